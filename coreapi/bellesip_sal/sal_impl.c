@@ -355,6 +355,12 @@ void sal_body_handler_set_encoding(SalBodyHandler *body_handler, const char *enc
 	belle_sip_body_handler_add_header(BELLE_SIP_BODY_HANDLER(body_handler), belle_sip_header_create("Content-Encoding", encoding));
 }
 
+int sal_body_handler_apply_encoding(SalBodyHandler *body_handler) {
+	const char *encoding = sal_body_handler_get_encoding(body_handler);
+	if (encoding == NULL || !BELLE_SIP_IS_INSTANCE_OF(body_handler, belle_sip_memory_body_handler_t)) return -1;
+	return belle_sip_memory_body_handler_apply_encoding(BELLE_SIP_MEMORY_BODY_HANDLER(body_handler), encoding);
+}
+
 void * sal_body_handler_get_data(const SalBodyHandler *body_handler) {
 	return belle_sip_memory_body_handler_get_buffer(BELLE_SIP_MEMORY_BODY_HANDLER(body_handler));
 }
@@ -24,8 +24,14 @@
 // TODO: From coreapi. Remove me later.
 #include "private.h"
 
+static void linphone_buffer_release_content(LinphoneBuffer *buffer) {
+	if (buffer->content && !buffer->borrowed_content) belle_sip_free(buffer->content);
+	buffer->content = NULL;
+	buffer->borrowed_content = FALSE;
+}
+
 static void linphone_buffer_destroy(LinphoneBuffer *buffer) {
-	if (buffer->content) belle_sip_free(buffer->content);
+	linphone_buffer_release_content(buffer);
 }
 
 BELLE_SIP_DECLARE_NO_IMPLEMENTED_INTERFACES(LinphoneBuffer);
@@ -79,7 +85,7 @@ const uint8_t * linphone_buffer_get_content(const LinphoneBuffer *buffer) {
 
 void linphone_buffer_set_content(LinphoneBuffer *buffer, const uint8_t *content, size_t size) {
 	buffer->size = size;
-	if (buffer->content) belle_sip_free(buffer->content);
+	linphone_buffer_release_content(buffer);
 	buffer->content = reinterpret_cast<uint8_t *>(belle_sip_malloc(size + 1));
 	memcpy(buffer->content, content, size);
     ((char *)buffer->content)[size] = '\0';
@@ -91,7 +97,7 @@ const char * linphone_buffer_get_string_content(const LinphoneBuffer *buffer) {
 
 void linphone_buffer_set_string_content(LinphoneBuffer *buffer, const char *content) {
 	buffer->size = strlen(content);
-	if (buffer->content) belle_sip_free(buffer->content);
+	linphone_buffer_release_content(buffer);
 	buffer->content = (uint8_t *)belle_sip_strdup(content);
 }
 
@@ -106,3 +112,14 @@ void linphone_buffer_set_size(LinphoneBuffer *buffer, size_t size) {
 bool_t linphone_buffer_is_empty(const LinphoneBuffer *buffer) {
 	return (buffer->size == 0) ? TRUE : FALSE;
 }
+
+/*
+ * Make the buffer point to content without copying it: the caller keeps the ownership of content and must
+ * reset the buffer (with a NULL content) before content is freed.
+ */
+void linphone_buffer_set_borrowed_content(LinphoneBuffer *buffer, uint8_t *content, size_t size) {
+	linphone_buffer_release_content(buffer);
+	buffer->content = content;
+	buffer->size = content ? size : 0;
+	buffer->borrowed_content = content ? TRUE : FALSE;
+}
@@ -330,8 +330,7 @@ static void add_friend_to_list_map_if_not_in_it_yet(LinphoneFriend *lf, const ch
 	bctbx_iterator_cchar_delete(end);
 
 	if (!found) {
-		bctbx_pair_t *pair = (bctbx_pair_t*) bctbx_pair_cchar_new(uri, linphone_friend_ref(lf));
-		bctbx_map_cchar_insert_and_delete(lf->friend_list->friends_map_uri, pair);
+		linphone_friend_list_insert_uri_into_map(lf->friend_list, uri, lf);
 	}
 }
 
@@ -348,8 +347,7 @@ static void remove_friend_from_list_map_if_already_in_it(LinphoneFriend *lf, con
 		if (!key || strcmp(uri, key) != 0) break;
 		LinphoneFriend *lf2 = (LinphoneFriend*) bctbx_pair_cchar_get_second(pair);
 		if (lf2 == lf) {
-			linphone_friend_unref(lf2);
-			bctbx_map_cchar_erase(lf->friend_list->friends_map_uri, it);
+			linphone_friend_list_erase_uri_from_map(lf->friend_list, it);
 			break;
 		}
 		it = bctbx_iterator_cchar_get_next(it);
@@ -358,6 +356,14 @@ static void remove_friend_from_list_map_if_already_in_it(LinphoneFriend *lf, con
 	bctbx_iterator_cchar_delete(end);
 }
 
+static void linphone_friend_update_search_index(LinphoneFriend *lf) {
+	if (lf->friend_list) linphone_friend_list_update_search_index(lf->friend_list, lf);
+}
+
+static void linphone_friend_update_phone_numbers_map(LinphoneFriend *lf) {
+	if (lf->friend_list) linphone_friend_list_add_friend_phone_numbers_into_map(lf->friend_list, lf);
+}
+
 LinphoneStatus linphone_friend_set_address(LinphoneFriend *lf, const LinphoneAddress *addr) {
 	if (!addr) return -1;
 	LinphoneAddress *fr = linphone_address_clone(addr);
@@ -386,6 +392,7 @@ LinphoneStatus linphone_friend_set_address(LinphoneFriend *lf, const LinphoneAdd
 		if (lf->uri != NULL) linphone_address_unref(lf->uri);
 		lf->uri = fr;
 	}
+	linphone_friend_update_search_index(lf);
 
 	ms_free(address);
 	return 0;
@@ -413,6 +420,7 @@ void linphone_friend_add_address(LinphoneFriend *lf, const LinphoneAddress *addr
 		if (lf->uri == NULL) lf->uri = fr;
 		else linphone_address_unref(fr);
 	}
+	linphone_friend_update_search_index(lf);
 	ms_free(uri);
 }
 
@@ -440,6 +448,7 @@ void linphone_friend_remove_address(LinphoneFriend *lf, const LinphoneAddress *a
 	if (linphone_core_vcard_supported()) {
 		linphone_vcard_remove_sip_address(lf->vcard, address);
 	}
+	linphone_friend_update_search_index(lf);
 	ms_free(address);
 }
 
@@ -457,6 +466,8 @@ void linphone_friend_add_phone_number(LinphoneFriend *lf, const char *phone) {
 		}
 		linphone_vcard_add_phone_number(lf->vcard, phone);
 	}
+	linphone_friend_update_phone_numbers_map(lf);
+	linphone_friend_update_search_index(lf);
 }
 
 bctbx_list_t* linphone_friend_get_phone_numbers(const LinphoneFriend *lf) {
@@ -521,6 +532,8 @@ void linphone_friend_remove_phone_number(LinphoneFriend *lf, const char *phone)
 	if (linphone_core_vcard_supported()) {
 		linphone_vcard_remove_phone_number(lf->vcard, phone);
 	}
+	linphone_friend_update_phone_numbers_map(lf);
+	linphone_friend_update_search_index(lf);
 }
 
 LinphoneStatus linphone_friend_set_name(LinphoneFriend *lf, const char *name) {
@@ -534,6 +547,7 @@ LinphoneStatus linphone_friend_set_name(LinphoneFriend *lf, const char *name) {
 		}
 		linphone_address_set_display_name(lf->uri, name);
 	}
+	linphone_friend_update_search_index(lf);
 	return 0;
 }
 
@@ -642,6 +656,7 @@ static void _linphone_friend_destroy(LinphoneFriend *lf){
 	_linphone_friend_release_ops(lf);
 	if (lf->presence_models) bctbx_list_free_with_data(lf->presence_models, (bctbx_list_free_func)free_friend_presence);
 	if (lf->phone_number_sip_uri_map) bctbx_list_free_with_data(lf->phone_number_sip_uri_map, (bctbx_list_free_func)free_phone_number_sip_uri);
+	if (lf->phone_numbers_map_keys) bctbx_list_free_with_data(lf->phone_numbers_map_keys, (bctbx_list_free_func)ms_free);
 	if (lf->uri!=NULL) linphone_address_unref(lf->uri);
 	if (lf->info!=NULL) buddy_info_free(lf->info);
 	if (lf->vcard != NULL) linphone_vcard_unref(lf->vcard);
@@ -823,6 +838,8 @@ void linphone_friend_set_presence_model_for_uri_or_tel(LinphoneFriend *lf, const
 	} else {
 		add_presence_model_for_uri_or_tel(lf, uri_or_tel, presence);
 	}
+	/* The presence contact of a phone number is searchable by MagicSearch */
+	linphone_friend_update_search_index(lf);
 }
 
 bool_t linphone_friend_is_presence_received(const LinphoneFriend *lf) {
@@ -933,6 +950,8 @@ void linphone_friend_done(LinphoneFriend *fr) {
 			}
 		}
 	}
+	linphone_friend_update_phone_numbers_map(fr);
+	linphone_friend_update_search_index(fr);
 	linphone_friend_apply(fr, fr->lc);
 	linphone_friend_save(fr, fr->lc);
 }
@@ -1231,6 +1250,8 @@ void linphone_friend_set_vcard(LinphoneFriend *fr, LinphoneVcard *vcard) {
 
 	if (fr->vcard) linphone_vcard_unref(fr->vcard);
 	if (vcard) fr->vcard = linphone_vcard_ref(vcard);
+	linphone_friend_update_phone_numbers_map(fr);
+	linphone_friend_update_search_index(fr);
 	linphone_friend_save(fr, fr->lc);
 }
 
@@ -1718,6 +1739,9 @@ void linphone_friend_add_addresses_and_numbers_into_maps(LinphoneFriend *lf, Lin
 		}
 		iterator = bctbx_list_next(iterator);
 	}
+
+	linphone_friend_list_add_friend_phone_numbers_into_map(list, lf);
+	list->search_index->addFriend(lf);
 }
 
 bctbx_list_t* linphone_core_fetch_friends_from_db(LinphoneCore *lc, LinphoneFriendList *list) {
@@ -22,6 +22,7 @@
 #include "linphone/api/c-content.h"
 #include "linphone/core.h"
 
+#include "address/address.h"
 #include "c-wrapper/c-wrapper.h"
 
 // TODO: From coreapi. Remove me later.
@@ -223,6 +224,80 @@ static char * create_resource_list_xml(const LinphoneFriendList *list) {
 	return xml_content;
 }
 
+/* Size of the stack buffer used to compute the URI key of an address, longer URIs use the string path. */
+#define URI_KEY_MAX_LENGTH 512
+
+/*
+ * Write in buffer a key identifying the URI of the address, built only from the fields of the
+ * parsed address so that it can be computed without any allocation. Two addresses whose string URIs
+ * (as returned by linphone_address_as_string_uri_only()) are equal have the same key.
+ * Returns FALSE if the address can't be represented by a key (absolute URI, URI headers or password,
+ * or buffer too small): the string representation must then be used.
+ */
+static bool_t linphone_friend_list_get_uri_key(const LinphoneAddress *address, bool_t ignore_gruu, char *buffer, size_t size) {
+	const SalAddress *sal_address = L_GET_CPP_PTR_FROM_C_OBJECT(address)->getInternalAddress();
+	if (!sal_address) return FALSE;
+	belle_sip_uri_t *uri = belle_sip_header_address_get_uri(BELLE_SIP_HEADER_ADDRESS(sal_address));
+	if (!uri || belle_sip_uri_get_header_names(uri) || belle_sip_uri_get_user_password(uri)) return FALSE;
+
+	size_t offset = 0;
+	const char *user = belle_sip_uri_get_user(uri);
+	const char *host = belle_sip_uri_get_host(uri);
+	belle_sip_error_code error = belle_sip_snprintf(buffer, size, &offset, "%s:%s%s%s:%d",
+		belle_sip_uri_is_secure(uri) ? "sips" : "sip", user ? user : "", user ? "@" : "", host ? host : "", belle_sip_uri_get_port(uri));
+
+	belle_sip_parameters_t *parameters = BELLE_SIP_PARAMETERS(uri);
+	const belle_sip_list_t *it;
+	for (it = belle_sip_parameters_get_parameter_names(parameters); it != NULL && error == BELLE_SIP_OK; it = it->next) {
+		const char *name = (const char *)it->data;
+		if (ignore_gruu && strcmp(name, "gr") == 0) continue;
+		const char *value = belle_sip_parameters_get_parameter(parameters, name);
+		if (value)
+			error = belle_sip_snprintf(buffer, size, &offset, ";%s=%s", name, value);
+		else
+			error = belle_sip_snprintf(buffer, size, &offset, ";%s", name);
+	}
+	return error == BELLE_SIP_OK;
+}
+
+void linphone_friend_list_insert_uri_into_map(LinphoneFriendList *list, const char *uri, LinphoneFriend *lf) {
+	bctbx_pair_t *pair = (bctbx_pair_t*) bctbx_pair_cchar_new(uri, linphone_friend_ref(lf));
+	bctbx_map_cchar_insert_and_delete(list->friends_map_uri, pair);
+
+	LinphoneAddress *address = linphone_address_new(uri);
+	if (address) {
+		char key[URI_KEY_MAX_LENGTH];
+		if (linphone_friend_list_get_uri_key(address, FALSE, key, sizeof(key)))
+			list->friends_map_uri_keys->emplace(key, lf);
+		linphone_address_unref(address);
+	}
+}
+
+/* Erase the entry of friends_map_uri pointed by it, the iterator itself is not deleted. */
+void linphone_friend_list_erase_uri_from_map(LinphoneFriendList *list, bctbx_iterator_t *it) {
+	bctbx_pair_t *pair = bctbx_iterator_cchar_get_pair(it);
+	const char *uri = bctbx_pair_cchar_get_first(reinterpret_cast<bctbx_pair_cchar_t *>(pair));
+	LinphoneFriend *lf = (LinphoneFriend *)bctbx_pair_cchar_get_second(pair);
+
+	LinphoneAddress *address = uri ? linphone_address_new(uri) : NULL;
+	if (address) {
+		char key[URI_KEY_MAX_LENGTH];
+		if (linphone_friend_list_get_uri_key(address, FALSE, key, sizeof(key))) {
+			auto range = list->friends_map_uri_keys->equal_range((const char *)key);
+			for (auto keyIt = range.first; keyIt != range.second; ++keyIt) {
+				if (keyIt->second == lf) {
+					list->friends_map_uri_keys->erase(keyIt);
+					break;
+				}
+			}
+		}
+		linphone_address_unref(address);
+	}
+
+	linphone_friend_unref(lf);
+	bctbx_map_cchar_erase(list->friends_map_uri, it);
+}
+
 static void linphone_friend_presence_received(LinphoneFriendList *list, LinphoneFriend *lf, const char *uri, LinphonePresenceModel *presence) {
 	lf->presence_received = TRUE;
 	const char *phone_number = linphone_friend_sip_uri_to_phone_number(lf, uri);
@@ -247,8 +322,7 @@ static void linphone_friend_presence_received(LinphoneFriendList *list, Linphone
 		bctbx_iterator_cchar_delete(end);
 
 		if (!found_friend_with_phone) {
-			bctbx_pair_t *pair = (bctbx_pair_t*) bctbx_pair_cchar_new(presence_address, linphone_friend_ref(lf));
-			bctbx_map_cchar_insert_and_delete(list->friends_map_uri, pair);
+			linphone_friend_list_insert_uri_into_map(list, presence_address, lf);
 		}
 		linphone_friend_set_presence_model_for_uri_or_tel(lf, phone_number, presence);
 		linphone_core_notify_notify_presence_received_for_uri_or_tel(list->lc, lf, phone_number, presence);
@@ -467,6 +541,9 @@ static LinphoneFriendList * linphone_friend_list_new(void) {
 	list->enable_subscriptions = FALSE;
 	list->friends_map = bctbx_mmap_cchar_new();
 	list->friends_map_uri = bctbx_mmap_cchar_new();
+	list->friends_map_uri_keys = new std::multimap<std::string, LinphoneFriend *, std::less<>>();
+	list->friends_map_phone = bctbx_mmap_cchar_new();
+	list->search_index = new LinphonePrivate::FriendSearchIndex();
 	list->bodyless_subscription = FALSE;
 	return list;
 }
@@ -489,6 +566,9 @@ static void linphone_friend_list_destroy(LinphoneFriendList *list) {
 	if (list->friends) list->friends = bctbx_list_free_with_data(list->friends, (void (*)(void *))_linphone_friend_release);
 	if (list->friends_map) bctbx_mmap_cchar_delete_with_data(list->friends_map, (void (*)(void *))linphone_friend_unref);
 	if (list->friends_map_uri) bctbx_mmap_cchar_delete_with_data(list->friends_map_uri, (void (*)(void *))linphone_friend_unref);
+	if (list->friends_map_uri_keys) delete list->friends_map_uri_keys;
+	if (list->friends_map_phone) bctbx_mmap_cchar_delete_with_data(list->friends_map_phone, (void (*)(void *))linphone_friend_unref);
+	if (list->search_index) delete list->search_index;
 }
 
 BELLE_SIP_DECLARE_NO_IMPLEMENTED_INTERFACES(LinphoneFriendList);
@@ -532,6 +612,7 @@ void _linphone_friend_list_release(LinphoneFriendList *list){
 	if (list->friends) {
 		list->friends = bctbx_list_free_with_data(list->friends, (void (*)(void *))_linphone_friend_release);
 	}
+	if (list->search_index) list->search_index->clear();
 	linphone_friend_list_unref(list);
 }
 
@@ -660,11 +741,83 @@ LinphoneFriendListStatus linphone_friend_list_add_local_friend(LinphoneFriendLis
 	return _linphone_friend_list_add_friend(list, lf, FALSE);
 }
 
+/*
+ * Any normalization of a phone number, whatever the dial plan of the account used, ends with the last digits of the
+ * number (at least as many as the shortest national number length). Two phone numbers can only be equal once normalized
+ * if they share these digits, so they are used as the key of the phone numbers map.
+ */
+#define PHONE_NUMBER_MAP_KEY_LENGTH 4
+
+static char * linphone_friend_list_phone_number_map_key(const char *phone_number) {
+	if (!phone_number) return NULL;
+
+	char *unescaped_phone_number = belle_sip_username_unescape_unnecessary_characters(phone_number);
+	char key[PHONE_NUMBER_MAP_KEY_LENGTH + 1] = {0};
+	int count = 0;
+	for (const char *r = unescaped_phone_number + strlen(unescaped_phone_number); r != unescaped_phone_number && count < PHONE_NUMBER_MAP_KEY_LENGTH;) {
+		--r;
+		if (isdigit((unsigned char)*r)) {
+			key[PHONE_NUMBER_MAP_KEY_LENGTH - 1 - count] = *r;
+			count++;
+		}
+	}
+	belle_sip_free(unescaped_phone_number);
+
+	if (count < PHONE_NUMBER_MAP_KEY_LENGTH) return NULL;
+	return ms_strdup(key);
+}
+
+void linphone_friend_list_remove_friend_phone_numbers_from_map(LinphoneFriendList *list, LinphoneFriend *lf) {
+	bctbx_list_t *elem;
+	for (elem = lf->phone_numbers_map_keys; elem != NULL; elem = bctbx_list_next(elem)) {
+		const char *key = (const char *)bctbx_list_get_data(elem);
+		bctbx_iterator_t *it = bctbx_map_cchar_find_key(list->friends_map_phone, key);
+		bctbx_iterator_t *end = bctbx_map_cchar_end(list->friends_map_phone);
+
+		// Map is sorted, check if next entry matches key otherwise stop
+		while (!bctbx_iterator_cchar_equals(it, end)) {
+			bctbx_pair_t *pair = bctbx_iterator_cchar_get_pair(it);
+			const char *pair_key = bctbx_pair_cchar_get_first(reinterpret_cast<bctbx_pair_cchar_t *>(pair));
+			if (!pair_key || strcmp(key, pair_key) != 0) break;
+			if ((LinphoneFriend *)bctbx_pair_cchar_get_second(pair) == lf) {
+				linphone_friend_unref(lf);
+				bctbx_map_cchar_erase(list->friends_map_phone, it);
+				break;
+			}
+			it = bctbx_iterator_cchar_get_next(it);
+		}
+		bctbx_iterator_cchar_delete(it);
+		bctbx_iterator_cchar_delete(end);
+	}
+	lf->phone_numbers_map_keys = bctbx_list_free_with_data(lf->phone_numbers_map_keys, (bctbx_list_free_func)ms_free);
+}
+
+void linphone_friend_list_add_friend_phone_numbers_into_map(LinphoneFriendList *list, LinphoneFriend *lf) {
+	linphone_friend_list_remove_friend_phone_numbers_from_map(list, lf);
+
+	bctbx_list_t *phone_numbers = linphone_friend_get_phone_numbers(lf);
+	bctbx_list_t *elem;
+	for (elem = phone_numbers; elem != NULL; elem = bctbx_list_next(elem)) {
+		char *key = linphone_friend_list_phone_number_map_key((const char *)bctbx_list_get_data(elem));
+		if (!key) continue;
+		if (bctbx_list_find_custom(lf->phone_numbers_map_keys, (int (*)(const void*, const void*))strcmp, key)) {
+			ms_free(key);
+			continue;
+		}
+		bctbx_pair_t *pair = (bctbx_pair_t*) bctbx_pair_cchar_new(key, linphone_friend_ref(lf));
+		bctbx_map_cchar_insert_and_delete(list->friends_map_phone, pair);
+		lf->phone_numbers_map_keys = bctbx_list_prepend(lf->phone_numbers_map_keys, key);
+	}
+	if (phone_numbers) bctbx_list_free(phone_numbers);
+}
+
 void linphone_friend_list_invalidate_friends_maps(LinphoneFriendList *list) {
 	if (list->friends_map) bctbx_mmap_cchar_delete_with_data(list->friends_map, (void (*)(void *))linphone_friend_unref);
 	list->friends_map = bctbx_mmap_cchar_new();
 	if (list->friends_map_uri) bctbx_mmap_cchar_delete_with_data(list->friends_map_uri, (void (*)(void *))linphone_friend_unref);
 	list->friends_map_uri = bctbx_mmap_cchar_new();
+	list->friends_map_uri_keys->clear();
+	list->search_index->clear();
 	
 	const bctbx_list_t *elem;
 	for (elem = list->friends; elem != NULL; elem = bctbx_list_next(elem)) {
@@ -745,8 +898,7 @@ static LinphoneFriendListStatus _linphone_friend_list_remove_friend(LinphoneFrie
 			bctbx_iterator_t * it = bctbx_map_cchar_find_key(list->friends_map_uri, uri);
 			bctbx_iterator_t * end = bctbx_map_cchar_end(list->friends_map_uri);
 			if (!bctbx_iterator_cchar_equals(it, end)){
-				linphone_friend_unref((LinphoneFriend*)bctbx_pair_cchar_get_second(bctbx_iterator_cchar_get_pair(it)));
-				bctbx_map_cchar_erase(list->friends_map_uri, it);
+				linphone_friend_list_erase_uri_from_map(list, it);
 			}
 			if (it) bctbx_iterator_cchar_delete(it);
 			if (end) bctbx_iterator_cchar_delete(end);
@@ -764,8 +916,7 @@ static LinphoneFriendListStatus _linphone_friend_list_remove_friend(LinphoneFrie
 			bctbx_iterator_t * it = bctbx_map_cchar_find_key(list->friends_map_uri, uri);
 			bctbx_iterator_t * end = bctbx_map_cchar_end(list->friends_map_uri);
 			if (!bctbx_iterator_cchar_equals(it, end)){
-				linphone_friend_unref((LinphoneFriend*)bctbx_pair_cchar_get_second(bctbx_iterator_cchar_get_pair(it)));
-				bctbx_map_cchar_erase(list->friends_map_uri, it);
+				linphone_friend_list_erase_uri_from_map(list, it);
 			}
 			if (it) bctbx_iterator_cchar_delete(it);
 			if (end) bctbx_iterator_cchar_delete(end);
@@ -775,6 +926,9 @@ static LinphoneFriendListStatus _linphone_friend_list_remove_friend(LinphoneFrie
 		iterator = bctbx_list_next(iterator);
 	}
 
+	linphone_friend_list_remove_friend_phone_numbers_from_map(list, lf);
+	list->search_index->removeFriend(lf);
+
 	lf->friend_list = NULL;
 	linphone_friend_unref(lf);
 	return LinphoneFriendListOK;
@@ -784,6 +938,10 @@ LinphoneFriendListStatus linphone_friend_list_remove_friend(LinphoneFriendList *
 	return _linphone_friend_list_remove_friend(list, lf, TRUE);
 }
 
+void linphone_friend_list_update_search_index(LinphoneFriendList *list, LinphoneFriend *lf) {
+	if (list && list->search_index) list->search_index->updateFriend(lf);
+}
+
 const bctbx_list_t * linphone_friend_list_get_friends(const LinphoneFriendList *list) {
 	return list->friends;
 }
@@ -837,6 +995,10 @@ static void carddav_updated(LinphoneCardDavContext *cdc, LinphoneFriend *lf_new,
 		bctbx_list_t *elem = bctbx_list_find(list->friends, lf_old);
 		if (elem) {
 			elem->data = linphone_friend_ref(lf_new);
+			linphone_friend_list_remove_friend_phone_numbers_from_map(list, lf_old);
+			linphone_friend_list_add_friend_phone_numbers_into_map(list, lf_new);
+			list->search_index->removeFriend(lf_old);
+			list->search_index->addFriend(lf_new);
 		}
 		linphone_core_store_friend_in_db(lf_new->lc, lf_new);
 
@@ -871,6 +1033,13 @@ void linphone_friend_list_synchronize_friends_from_server(LinphoneFriendList *li
 }
 
 LinphoneFriend * linphone_friend_list_find_friend_by_address(const LinphoneFriendList *list, const LinphoneAddress *address) {
+	char key[URI_KEY_MAX_LENGTH];
+	if (linphone_friend_list_get_uri_key(address, TRUE, key, sizeof(key))) {
+		/* Same result as the string lookup below (the first friend inserted with this URI) without allocating anything */
+		auto it = list->friends_map_uri_keys->find((const char *)key);
+		return it != list->friends_map_uri_keys->end() ? it->second : NULL;
+	}
+
 	LinphoneAddress *clean_addr = linphone_address_clone(address);
 	LinphoneFriend *lf;
 	if (linphone_address_has_uri_param(clean_addr, "gr")) {
@@ -885,22 +1054,53 @@ LinphoneFriend * linphone_friend_list_find_friend_by_address(const LinphoneFrien
 
 LinphoneFriend * linphone_friend_list_find_friend_by_phone_number(const LinphoneFriendList *list, const char *phoneNumber) {
 	LinphoneFriend *result = NULL;
-	
-	const bctbx_list_t *elem;
-	for (elem = list->friends; elem != NULL; elem = bctbx_list_next(elem)) {
-		LinphoneFriend *lf = (LinphoneFriend *)bctbx_list_get_data(elem);
+	char *key = linphone_friend_list_phone_number_map_key(phoneNumber);
+
+	if (!key) {
+		/* Too short to be indexed, check every friend */
+		const bctbx_list_t *elem;
+		for (elem = list->friends; elem != NULL; elem = bctbx_list_next(elem)) {
+			LinphoneFriend *lf = (LinphoneFriend *)bctbx_list_get_data(elem);
+			if (linphone_friend_has_phone_number(lf, phoneNumber)) {
+				result = lf;
+				break;
+			}
+		}
+		return result;
+	}
+
+	/* Only the friends sharing the last digits of the phone number can match it once normalized */
+	bctbx_iterator_t *it = bctbx_map_cchar_find_key(list->friends_map_phone, key);
+	bctbx_iterator_t *end = bctbx_map_cchar_end(list->friends_map_phone);
+	while (!bctbx_iterator_cchar_equals(it, end)) {
+		bctbx_pair_t *pair = bctbx_iterator_cchar_get_pair(it);
+		const char *pair_key = bctbx_pair_cchar_get_first(reinterpret_cast<bctbx_pair_cchar_t *>(pair));
+		if (!pair_key || strcmp(key, pair_key) != 0) break;
+		LinphoneFriend *lf = (LinphoneFriend *)bctbx_pair_cchar_get_second(pair);
 		if (linphone_friend_has_phone_number(lf, phoneNumber)) {
 			result = lf;
 			break;
 		}
+		it = bctbx_iterator_cchar_get_next(it);
 	}
+	bctbx_iterator_cchar_delete(it);
+	bctbx_iterator_cchar_delete(end);
+	ms_free(key);
 
 	return result;
 }
 
 bctbx_list_t * linphone_friend_list_find_friends_by_address(const LinphoneFriendList *list, const LinphoneAddress *address) {
-	LinphoneAddress *clean_addr = linphone_address_clone(address);
 	bctbx_list_t *result = NULL;
+	char key[URI_KEY_MAX_LENGTH];
+	if (linphone_friend_list_get_uri_key(address, TRUE, key, sizeof(key))) {
+		auto range = list->friends_map_uri_keys->equal_range((const char *)key);
+		for (auto it = range.first; it != range.second; ++it)
+			result = bctbx_list_prepend(result, linphone_friend_ref(it->second));
+		return result;
+	}
+
+	LinphoneAddress *clean_addr = linphone_address_clone(address);
 	if (linphone_address_has_uri_param(clean_addr, "gr")) {
 		linphone_address_remove_uri_param(clean_addr, "gr");
 	}
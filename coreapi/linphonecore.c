@@ -7517,6 +7517,21 @@ int linphone_core_get_calls_nb(const LinphoneCore *lc) {
 	return (int)L_GET_CPP_PTR_FROM_C_OBJECT(lc)->getCallCount();
 }
 
+int linphone_core_get_media_ticker_count(const LinphoneCore *lc) {
+	const MediaTickerPool *pool = L_GET_CPP_PTR_FROM_C_OBJECT(lc)->getMediaTickerPool();
+	return pool ? (int)pool->getLoads().size() : 0;
+}
+
+float linphone_core_get_media_ticker_load(const LinphoneCore *lc, int index) {
+	const MediaTickerPool *pool = L_GET_CPP_PTR_FROM_C_OBJECT(lc)->getMediaTickerPool();
+	if (!pool || index < 0) return 0;
+	list<MediaTickerPool::TickerLoad> loads = pool->getLoads();
+	if ((size_t)index >= loads.size()) return 0;
+	auto it = loads.cbegin();
+	advance(it, index);
+	return it->load;
+}
+
 void linphone_core_activate_audio_session (LinphoneCore* lc, bool_t actived) {
 	L_GET_CPP_PTR_FROM_C_OBJECT(lc)->soundcardActivateAudioSession(actived);
 }
@@ -173,6 +173,11 @@ void linphone_friend_list_invalidate_subscriptions(LinphoneFriendList *list);
 void linphone_friend_list_notify_presence_received(LinphoneFriendList *list, LinphoneEvent *lev, const LinphoneContent *body);
 void linphone_friend_list_subscription_state_changed(LinphoneCore *lc, LinphoneEvent *lev, LinphoneSubscriptionState state);
 void linphone_friend_list_invalidate_friends_maps(LinphoneFriendList *list);
+void linphone_friend_list_update_search_index(LinphoneFriendList *list, LinphoneFriend *lf);
+void linphone_friend_list_add_friend_phone_numbers_into_map(LinphoneFriendList *list, LinphoneFriend *lf);
+void linphone_friend_list_remove_friend_phone_numbers_from_map(LinphoneFriendList *list, LinphoneFriend *lf);
+void linphone_friend_list_insert_uri_into_map(LinphoneFriendList *list, const char *uri, LinphoneFriend *lf);
+void linphone_friend_list_erase_uri_from_map(LinphoneFriendList *list, bctbx_iterator_t *it);
 
 /**
  * Removes all bodyless friend lists.
@@ -366,6 +371,8 @@ void _linphone_chat_room_notify_chat_message_should_be_stored(LinphoneChatRoom *
 void _linphone_chat_room_notify_chat_message_participant_imdn_state_changed(LinphoneChatRoom *cr, LinphoneChatMessage *msg, const LinphoneParticipantImdnState *state);
 void _linphone_chat_room_clear_callbacks (LinphoneChatRoom *cr);
 
+void linphone_buffer_set_borrowed_content(LinphoneBuffer *buffer, uint8_t *content, size_t size);
+
 void _linphone_chat_message_notify_msg_state_changed(LinphoneChatMessage* msg, LinphoneChatMessageState state);
 void _linphone_chat_message_notify_participant_imdn_state_changed(LinphoneChatMessage* msg, const LinphoneParticipantImdnState *state);
 void _linphone_chat_message_notify_file_transfer_recv(LinphoneChatMessage *msg, LinphoneContent* content, const LinphoneBuffer *buffer);
@@ -467,6 +474,11 @@ LinphoneEvent *linphone_event_new(LinphoneCore *lc, LinphoneSubscriptionDir dir,
 LinphoneEvent *linphone_event_new_with_op(LinphoneCore *lc, LinphonePrivate::SalEventOp *op, LinphoneSubscriptionDir dir, const char *name);
 LinphoneEvent *_linphone_core_create_publish(LinphoneCore *core, LinphoneAccount *account, const LinphoneAddress *resource, const char *event, int expires);
 void linphone_event_unpublish(LinphoneEvent *lev);
+/*
+ * Same as linphone_event_notify() with a body handler that may be shared by several NOTIFYs,
+ * the caller keeps its reference.
+ */
+LinphoneStatus _linphone_event_notify_with_body_handler(LinphoneEvent *lev, SalBodyHandler *body_handler);
 void linphone_event_set_current_callbacks(LinphoneEvent *ev, LinphoneEventCbs *cbs);
 /**
  * Useful for out of dialog notify
@@ -20,6 +20,10 @@
 #ifndef _PRIVATE_STRUCTS_H_
 #define _PRIVATE_STRUCTS_H_
 
+#include <functional>
+#include <map>
+#include <string>
+
 #include <bctoolbox/map.h>
 #include <libxml/xmlreader.h>
 #include <libxml/xmlwriter.h>
@@ -28,6 +32,7 @@
 
 #include "carddav.h"
 #include "sal/register-op.h"
+#include "search/friend-search-index.h"
 
 struct _LinphoneQualityReporting{
 	reporting_session_report_t * reports[3]; /**Store information on audio and video media streams (RFC 6035) */
@@ -108,6 +113,7 @@ struct _LinphoneFriend{
 	LinphoneSubscribePolicy pol;
 	MSList *presence_models; /* list of LinphoneFriendPresence. It associates SIP URIs and phone numbers with their respective presence models. */
 	MSList *phone_number_sip_uri_map; /* list of LinphoneFriendPhoneNumberSipUri. It associates phone numbers with their corresponding SIP URIs. */
+	bctbx_list_t *phone_numbers_map_keys; /* keys under which the friend is stored in the friends_map_phone of its list */
 	struct _LinphoneCore *lc;
 	BuddyInfo *info;
 	char *refkey;
@@ -150,6 +156,9 @@ struct _LinphoneFriendList {
 	MSList *friends;
 	bctbx_map_t *friends_map;
 	bctbx_map_t *friends_map_uri;
+	std::multimap<std::string, LinphoneFriend *, std::less<>> *friends_map_uri_keys; /* friends_map_uri entries by canonical URI key, see linphone_friend_list_get_uri_key() */
+	bctbx_map_t *friends_map_phone; /* friends by the last digits of their phone numbers, which don't depend on the dial plan used to normalize them */
+	LinphonePrivate::FriendSearchIndex *search_index; /* n-gram index used by MagicSearch, maintained alongside the friends maps */
 	unsigned char *content_digest;
 	int expected_notification_version;
 	unsigned int storage_id;
@@ -421,6 +430,7 @@ struct _LinphoneBuffer {
 	void *user_data;
 	uint8_t *content;	/**< A pointer to the buffer content */
 	size_t size;	/**< The size of the buffer content */
+	bool_t borrowed_content;	/**< The content is owned by someone else and must not be freed */
 };
 
 BELLE_SIP_DECLARE_VPTR_NO_EXPORT(LinphoneBuffer);
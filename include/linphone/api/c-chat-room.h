@@ -272,6 +272,17 @@ LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_message_events (Lin
  */
 LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_range_message_events (LinphoneChatRoom *chat_room, int begin, int end);
 
+/**
+ * Gets the nb_events chat message events stored right before the given event, sorted from oldest to most recent.
+ * Unlike linphone_chat_room_get_history_range_message_events(), the cost of this call does not grow with the depth in the history,
+ * so it should be preferred to page through large conversations: pass the oldest event of the previous page to get the next one.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which events should be retrieved @notnil
+ * @param last_event The #LinphoneEventLog the returned events precede. NULL to start from the most recent event. @maybenil
+ * @param nb_events Number of events to retrieve. 0 means everything.
+ * @return The list of chat message events. \bctbx_list{LinphoneEventLog} @tobefreed
+ */
+LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_message_events_before (LinphoneChatRoom *chat_room, const LinphoneEventLog *last_event, int nb_events);
+
 /**
  * Gets nb_events most recent events from chat_room chat room, sorted from oldest to most recent.
  * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which events should be retrieved @notnil
@@ -289,6 +300,17 @@ LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_events (LinphoneCha
  */
 LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_range_events (LinphoneChatRoom *chat_room, int begin, int end);
 
+/**
+ * Gets the nb_events events stored right before the given event, sorted from oldest to most recent.
+ * Unlike linphone_chat_room_get_history_range_events(), the cost of this call does not grow with the depth in the history,
+ * so it should be preferred to page through large conversations: pass the oldest event of the previous page to get the next one.
+ * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which events should be retrieved @notnil
+ * @param last_event The #LinphoneEventLog the returned events precede. NULL to start from the most recent event. @maybenil
+ * @param nb_events Number of events to retrieve. 0 means everything.
+ * @return The list of the found events. \bctbx_list{LinphoneEventLog} @tobefreed
+ */
+LINPHONE_PUBLIC bctbx_list_t *linphone_chat_room_get_history_events_before (LinphoneChatRoom *chat_room, const LinphoneEventLog *last_event, int nb_events);
+
 /**
  * Gets the number of events in a chat room.
  * @param chat_room The #LinphoneChatRoom object corresponding to the conversation for which size has to be computed @notnil
@@ -141,6 +141,7 @@ LINPHONE_PUBLIC unsigned int linphone_magic_search_get_search_limit (const Linph
 
 /**
  * Set the number of the maximum SearchResult which will be returned
+ * When the search is limited, the results with the highest weight are kept.
  * @param magic_search a #LinphoneMagicSearch object @notnil
  * @param limit the maximum number of #LinphoneSearchResult the search will return
  **/
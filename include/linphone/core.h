@@ -4014,6 +4014,26 @@ int linphone_core_get_current_call_stats(LinphoneCore *core, rtp_stats_t *local,
 **/
 LINPHONE_PUBLIC int linphone_core_get_calls_nb(const LinphoneCore *core);
 
+/**
+ * Get the number of running tickers of the shared media ticker pool.
+ * Streams are scheduled on this pool when the [misc] shared_media_tickers setting is enabled, the pool then holds
+ * at most [misc] shared_media_tickers_count (the number of CPUs by default) tickers for audio and text streams
+ * and as many for video streams.
+ * @param core #LinphoneCore object @notnil
+ * @return The number of running shared tickers, 0 if the pool is disabled.
+ * @ingroup media_parameters
+**/
+LINPHONE_PUBLIC int linphone_core_get_media_ticker_count(const LinphoneCore *core);
+
+/**
+ * Get the average load of a ticker of the shared media ticker pool.
+ * @param core #LinphoneCore object @notnil
+ * @param index The index of the ticker, between 0 and linphone_core_get_media_ticker_count() - 1.
+ * @return The load of the ticker in percent of its tick interval, 0 if there is no such ticker.
+ * @ingroup media_parameters
+**/
+LINPHONE_PUBLIC float linphone_core_get_media_ticker_load(const LinphoneCore *core, int index);
+
 /**
  * Gets the current list of calls.
  * Note that this list is read-only and might be changed by the core after a function call to linphone_core_iterate().
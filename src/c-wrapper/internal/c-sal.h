@@ -519,6 +519,8 @@ const char * sal_body_handler_get_content_type_parameter(const SalBodyHandler *b
 void sal_body_handler_set_content_type_parameter(SalBodyHandler *body_handler, const char *paramName, const char *paramValue);
 const char * sal_body_handler_get_encoding(const SalBodyHandler *body_handler);
 void sal_body_handler_set_encoding(SalBodyHandler *body_handler, const char *encoding);
+/* Compress the data with the encoding set on the body handler, belle-sip does not encode it again when it is sent. */
+int sal_body_handler_apply_encoding(SalBodyHandler *body_handler);
 void * sal_body_handler_get_data(const SalBodyHandler *body_handler);
 void sal_body_handler_set_data(SalBodyHandler *body_handler, void *data);
 size_t sal_body_handler_get_size(const SalBodyHandler *body_handler);
@@ -109,6 +109,14 @@ public:
 		contentsNotLoadedFromDatabase = true;
 	}
 
+	void markContentsAsLoaded () {
+		contentsNotLoadedFromDatabase = false;
+	}
+
+	bool areContentsLoaded () const {
+		return !contentsNotLoadedFromDatabase;
+	}
+
 	void loadContentsFromDatabase () const;
 
 	std::list<Content* > &getContents () {
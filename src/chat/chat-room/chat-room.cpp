@@ -499,6 +499,10 @@ list<shared_ptr<EventLog>> ChatRoom::getMessageHistoryRange (int begin, int end)
 	return getCore()->getPrivate()->mainDb->getHistoryRange(getConferenceId(), begin, end, MainDb::Filter::ConferenceChatMessageFilter);
 }
 
+list<shared_ptr<EventLog>> ChatRoom::getMessageHistoryBefore (const shared_ptr<const EventLog> &lastEvent, int nLast) const {
+	return getCore()->getPrivate()->mainDb->getHistoryBefore(getConferenceId(), lastEvent, nLast, MainDb::Filter::ConferenceChatMessageFilter);
+}
+
 list<shared_ptr<ChatMessage>> ChatRoom::getUnreadChatMessages() const {
 	return getCore()->getPrivate()->mainDb->getUnreadChatMessages(getConferenceId());
 }
@@ -524,6 +528,15 @@ list<shared_ptr<EventLog>> ChatRoom::getHistoryRange (int begin, int end) const
 	);
 }
 
+list<shared_ptr<EventLog>> ChatRoom::getHistoryBefore (const shared_ptr<const EventLog> &lastEvent, int nLast) const {
+	return getCore()->getPrivate()->mainDb->getHistoryBefore(
+		getConferenceId(),
+		lastEvent,
+		nLast,
+		MainDb::FilterMask({ MainDb::Filter::ConferenceChatMessageFilter, MainDb::Filter::ConferenceInfoNoDeviceFilter })
+	);
+}
+
 int ChatRoom::getHistorySize () const {
 	return getCore()->getPrivate()->mainDb->getHistorySize(getConferenceId());
 }
@@ -593,6 +593,18 @@ list<shared_ptr<EventLog>> ClientGroupChatRoom::getHistoryRange (int begin, int
 	);
 }
 
+list<shared_ptr<EventLog>> ClientGroupChatRoom::getHistoryBefore (const shared_ptr<const EventLog> &lastEvent, int nLast) const {
+	L_D();
+	return getCore()->getPrivate()->mainDb->getHistoryBefore(
+		getConferenceId(),
+		lastEvent,
+		nLast,
+		(d->capabilities & Capabilities::OneToOne) ?
+			MainDb::Filter::ConferenceChatMessageSecurityFilter :
+			MainDb::FilterMask({MainDb::Filter::ConferenceChatMessageFilter, MainDb::Filter::ConferenceInfoNoDeviceFilter})
+	);
+}
+
 int ClientGroupChatRoom::getHistorySize () const {
 	L_D();
 	return getCore()->getPrivate()->mainDb->getHistorySize(
@@ -973,6 +985,9 @@ void ClientGroupChatRoom::onFirstNotifyReceived (const IdentityAddress &addr) {
 		return;
 	}
 
+	// The full state may have changed the participant of a one to one chat room.
+	getCore()->getPrivate()->reindexOneToOneChatRoom(getConferenceId());
+
 	bool performMigration = false;
 	shared_ptr<AbstractChatRoom> chatRoom;
 	if (getParticipantCount() == 1 && d->capabilities & ClientGroupChatRoom::Capabilities::OneToOne) {
@@ -1017,6 +1032,7 @@ void ClientGroupChatRoom::onParticipantAdded (const shared_ptr<ConferencePartici
 	if (event->getFullState())
 		return;
 
+	getCore()->getPrivate()->reindexOneToOneChatRoom(getConferenceId());
 	d->addEvent(event);
 
 	LinphoneChatRoom *cr = d->getCChatRoom();
@@ -1026,6 +1042,7 @@ void ClientGroupChatRoom::onParticipantAdded (const shared_ptr<ConferencePartici
 void ClientGroupChatRoom::onParticipantRemoved (const shared_ptr<ConferenceParticipantEvent> &event, const std::shared_ptr<Participant> &participant) {
 	L_D();
 
+	getCore()->getPrivate()->reindexOneToOneChatRoom(getConferenceId());
 	d->addEvent(event);
 
 	LinphoneChatRoom *cr = d->getCChatRoom();
@@ -1127,6 +1144,7 @@ void ClientGroupChatRoom::onParticipantsCleared () {
 			getCore()->getPrivate()->mainDb->deleteChatRoomParticipantDevice(getSharedFromThis(), device);
 	}
 	getConference()->clearParticipants ();
+	getCore()->getPrivate()->reindexOneToOneChatRoom(getConferenceId());
 }
 
 void ClientGroupChatRoom::onEphemeralModeChanged (const shared_ptr<ConferenceEphemeralMessageEvent> &event) {
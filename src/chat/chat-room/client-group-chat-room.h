@@ -65,6 +65,7 @@ public:
 
 	std::list<std::shared_ptr<EventLog>> getHistory (int nLast) const override;
 	std::list<std::shared_ptr<EventLog>> getHistoryRange (int begin, int end) const override;
+	std::list<std::shared_ptr<EventLog>> getHistoryBefore (const std::shared_ptr<const EventLog> &lastEvent, int nLast) const override;
 	int getHistorySize () const override;
 
 	bool addParticipant (const IdentityAddress &participantAddress) override;
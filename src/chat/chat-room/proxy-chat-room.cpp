@@ -115,6 +115,11 @@ list<shared_ptr<EventLog>> ProxyChatRoom::getMessageHistoryRange (int begin, int
 	return d->chatRoom->getMessageHistoryRange(begin, end);
 }
 
+list<shared_ptr<EventLog>> ProxyChatRoom::getMessageHistoryBefore (const shared_ptr<const EventLog> &lastEvent, int nLast) const {
+	L_D();
+	return d->chatRoom->getMessageHistoryBefore(lastEvent, nLast);
+}
+
 list<shared_ptr<ChatMessage>> ProxyChatRoom::getUnreadChatMessages() const {
 	L_D();
 	return d->chatRoom->getUnreadChatMessages();
@@ -135,6 +140,11 @@ list<shared_ptr<EventLog>> ProxyChatRoom::getHistoryRange (int begin, int end) c
 	return d->chatRoom->getHistoryRange(begin, end);
 }
 
+list<shared_ptr<EventLog>> ProxyChatRoom::getHistoryBefore (const shared_ptr<const EventLog> &lastEvent, int nLast) const {
+	L_D();
+	return d->chatRoom->getHistoryBefore(lastEvent, nLast);
+}
+
 int ProxyChatRoom::getHistorySize () const {
 	L_D();
 	return d->chatRoom->getHistorySize();
@@ -117,15 +117,7 @@ public:
 
 private:
 	struct Message {
-		Message (const std::string &from, const ContentType &contentType, const std::string &text, const SalCustomHeader *salCustomHeaders)
-			: fromAddr(from)
-		{
-			content.setContentType(contentType);
-			if (!text.empty())
-				content.setBodyFromUtf8(text);
-			if (salCustomHeaders)
-				customHeaders = sal_custom_header_clone(salCustomHeaders);
-		}
+		Message (const std::string &from, const ContentType &contentType, const std::string &text, const SalCustomHeader *salCustomHeaders);
 
 		~Message () {
 			if (customHeaders)
@@ -135,11 +127,22 @@ private:
 		IdentityAddress fromAddr;
 		Content content;
 		std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
+		// Headers of the MESSAGEs sent to the devices, cloned for each of them.
 		SalCustomHeader *customHeaders = nullptr;
 	};
 
-	static void copyMessageHeaders (const std::shared_ptr<Message> &fromMessage, const std::shared_ptr<ChatMessage> &toMessage);
+	struct QueuedMessages {
+		IdentityAddress deviceAddress;
+		std::queue<std::shared_ptr<Message>> messages;
+	};
+
+	// Keys of the address indexes, compared the same way as IdentityAddress::operator==().
+	static std::string getParticipantKey (const IdentityAddress &address);
+	static std::string getDeviceKey (const IdentityAddress &address);
+
 	static bool allDevicesLeft(const std::shared_ptr<Participant> &participant);
+	void addCachedParticipant (const std::shared_ptr<Participant> &participant);
+	void addAuthorizedParticipant (const std::shared_ptr<Participant> &participant);
 	void addParticipantDevice (const std::shared_ptr<Participant> &participant, const std::shared_ptr<ParticipantDeviceIdentity> &deviceInfo);
 	void designateAdmin ();
 	void sendMessage (const std::shared_ptr<Message> &message, const IdentityAddress &deviceAddr);
@@ -149,7 +152,7 @@ private:
 	void byeDevice (const std::shared_ptr<ParticipantDevice> &device);
 	bool isAdminLeft () const;
 	void queueMessage (const std::shared_ptr<Message> &message);
-	void queueMessage (const std::shared_ptr<Message> &msg, const IdentityAddress &deviceAddress);
+	void queueMessage (const std::shared_ptr<Message> &msg, const std::shared_ptr<ParticipantDevice> &device);
 	void removeParticipantDevice (const std::shared_ptr<Participant> &participant, const IdentityAddress &deviceAddress);
 
 	void onParticipantDeviceLeft (const std::shared_ptr<ParticipantDevice> &device);
@@ -182,7 +185,10 @@ private:
 	std::shared_ptr<ParticipantDevice> mInitiatorDevice; /*pointer to the ParticipantDevice that is creating the chat room*/
 	bool joiningPendingAfterCreation = false;
 	bool needsUnref = false;
-	std::unordered_map<std::string, std::queue<std::shared_ptr<Message>>> queuedMessages;
+	std::unordered_map<std::string, QueuedMessages> queuedMessages; // Indexed by getDeviceKey().
+	// Indexes of ServerGroupChatRoom::cachedParticipants and of the participants of the conference, by getParticipantKey().
+	std::unordered_map<std::string, std::shared_ptr<Participant>> cachedParticipantsByAddress;
+	std::unordered_map<std::string, std::shared_ptr<Participant>> authorizedParticipantsByAddress;
 	Utils::Version protocolVersion;
 	L_DECLARE_PUBLIC(ServerGroupChatRoom);
 };
@@ -76,18 +76,63 @@ ParticipantDeviceIdentity::~ParticipantDeviceIdentity(){
 		bctbx_list_free_with_data(callbacksCopy, (bctbx_list_free_func) belle_sip_object_unref);\
 	}while(0)
 
+ServerGroupChatRoomPrivate::Message::Message (const string &from, const ContentType &contentType, const string &text, const SalCustomHeader *salCustomHeaders)
+	: fromAddr(from)
+{
+	content.setContentType(contentType);
+	if (!text.empty())
+		content.setBodyFromUtf8(text);
+
+	// Prepare the headers once, the message may be sent to every device of the chat room.
+	static const char *headersToCopy[] = {
+		"Content-Encoding",
+		"Expires",
+		"Priority"
+	};
+	for (const char *headerName : headersToCopy) {
+		const char *headerValue = sal_custom_header_find(salCustomHeaders, headerName);
+		if (headerValue)
+			customHeaders = sal_custom_header_append(customHeaders, headerName, headerValue);
+	}
+	customHeaders = sal_custom_header_append(customHeaders, "Session-mode", "true"); // Special custom header to identify MESSAGE that belong to server group chatroom
+}
+
+// -----------------------------------------------------------------------------
+
+string ServerGroupChatRoomPrivate::getParticipantKey (const IdentityAddress &address) {
+	return address.getUsername() + "@" + address.getDomain();
+}
+
+string ServerGroupChatRoomPrivate::getDeviceKey (const IdentityAddress &address) {
+	return getParticipantKey(address) + ";gr=" + address.getGruu();
+}
+
+void ServerGroupChatRoomPrivate::addCachedParticipant (const shared_ptr<Participant> &participant) {
+	L_Q();
+	q->cachedParticipants.push_back(participant);
+	cachedParticipantsByAddress[getParticipantKey(participant->getAddress())] = participant;
+}
+
+void ServerGroupChatRoomPrivate::addAuthorizedParticipant (const shared_ptr<Participant> &participant) {
+	L_Q();
+	q->getConference()->participants.push_back(participant);
+	authorizedParticipantsByAddress[getParticipantKey(participant->getAddress())] = participant;
+}
+
+// -----------------------------------------------------------------------------
+
 shared_ptr<Participant> ServerGroupChatRoomPrivate::addParticipant (const IdentityAddress &addr) {
 	L_Q();
 
 	shared_ptr<Participant> participant = q->findCachedParticipant(addr);
 	if (!participant) {
 		participant = Participant::create(q->getConference().get(),addr);
-		q->cachedParticipants.push_back(participant);
+		addCachedParticipant(participant);
 	}
 	/* Case of participant that is still referenced in the chatroom, but no longer authorized because it has been removed
 	 * previously OR a totally new participant. */
 	if (q->findParticipant(addr) == nullptr){
-		q->getConference()->participants.push_back(participant);
+		addAuthorizedParticipant(participant);
 		shared_ptr<ConferenceParticipantEvent> event = q->getConference()->notifyParticipantAdded(time(nullptr), false, participant);
 		q->getCore()->getPrivate()->mainDb->addEvent(event);
 	}
@@ -117,17 +162,16 @@ void ServerGroupChatRoomPrivate::setParticipantDeviceState (const shared_ptr<Par
 	// Do not change state of participants if the core is shutting down.
 	// If a participant is about to leave and its call session state is End, it will be released during shutdown event though the participant may not be notified yet as it is offline
 	if (linphone_core_get_global_state(q->getCore()->getCCore()) ==  LinphoneGlobalOn) {
-		string address(device->getAddress().asString());
-		lInfo() << q << ": Set participant device '" << address << "' state to " << state;
+		lInfo() << q << ": Set participant device '" << device->getAddress().asString() << "' state to " << state;
 		device->setState(state);
 		q->getCore()->getPrivate()->mainDb->updateChatRoomParticipantDevice(q->getSharedFromThis(), device);
 		switch (state){
 			case ParticipantDevice::State::ScheduledForLeaving:
 			case ParticipantDevice::State::Leaving:
-				queuedMessages.erase(address);
+				queuedMessages.erase(getDeviceKey(device->getAddress()));
 			break;
 			case ParticipantDevice::State::Left:
-				queuedMessages.erase(address);
+				queuedMessages.erase(getDeviceKey(device->getAddress()));
 				onParticipantDeviceLeft(device);
 			break;
 			default:
@@ -345,34 +389,49 @@ void ServerGroupChatRoomPrivate::declineSession (const shared_ptr<CallSession> &
 
 void ServerGroupChatRoomPrivate::dispatchQueuedMessages () {
 	L_Q();
-	for (const auto &participant : q->getParticipants()) {
+	// Only look at the devices having queued messages, through the address indexes.
+	list<shared_ptr<ParticipantDevice>> devices;
+	for (auto it = queuedMessages.begin(); it != queuedMessages.end();) {
+		if (it->second.messages.empty()) {
+			it = queuedMessages.erase(it);
+			continue;
+		}
+		const IdentityAddress &deviceAddress = it->second.deviceAddress;
+		++it;
+
+		// Only the devices of the participants that are currently part of the chat room.
+		auto participantIt = authorizedParticipantsByAddress.find(getParticipantKey(deviceAddress));
+		if (participantIt == authorizedParticipantsByAddress.end())
+			continue;
+		shared_ptr<ParticipantDevice> device = participantIt->second->findDevice(deviceAddress, false);
+		if (device)
+			devices.push_back(device);
+	}
+
+	for (const auto &device : devices) {
 		/*
 		 * Dispatch messages for each device in Present state. In a one to one chatroom, if a device
 		 * is found is Left state, it must be invited first.
 		 */
+		auto queueIt = queuedMessages.find(getDeviceKey(device->getAddress()));
+		if (queueIt == queuedMessages.end() || queueIt->second.messages.empty())
+			continue;
 
-		for (const auto &device : participant->getDevices()) {
-
-			string uri(device->getAddress().asString());
-			auto & msgQueue = queuedMessages[uri];
-
-			if (!msgQueue.empty()){
-				if ( (capabilities & ServerGroupChatRoom::Capabilities::OneToOne) && device->getState() == ParticipantDevice::State::Left){
-					// Happens only with protocol < 1.1
-					lInfo() << "There is a message to transmit to a participant in left state in a one to one chatroom, so inviting first.";
-					inviteDevice(device);
-					continue;
-				}
-				if (device->getState() != ParticipantDevice::State::Present)
-					continue;
-				size_t nbMessages = msgQueue.size();
-				lInfo() << q << ": Dispatching " << nbMessages << " queued message(s) for '" << uri << "'";
-				while (!msgQueue.empty()) {
-					shared_ptr<Message> msg = msgQueue.front();
-					sendMessage(msg, device->getAddress());
-					msgQueue.pop();
-				}
-			}
+		auto & msgQueue = queueIt->second.messages;
+		if ( (capabilities & ServerGroupChatRoom::Capabilities::OneToOne) && device->getState() == ParticipantDevice::State::Left){
+			// Happens only with protocol < 1.1
+			lInfo() << "There is a message to transmit to a participant in left state in a one to one chatroom, so inviting first.";
+			inviteDevice(device);
+			continue;
+		}
+		if (device->getState() != ParticipantDevice::State::Present)
+			continue;
+		size_t nbMessages = msgQueue.size();
+		lInfo() << q << ": Dispatching " << nbMessages << " queued message(s) for '" << device->getAddress().asString() << "'";
+		while (!msgQueue.empty()) {
+			shared_ptr<Message> msg = msgQueue.front();
+			sendMessage(msg, device->getAddress());
+			msgQueue.pop();
 		}
 	}
 }
@@ -389,15 +448,16 @@ void ServerGroupChatRoomPrivate::removeParticipant (const shared_ptr<Participant
 		updateParticipantDeviceSession(device);
 	}
 
-	for (const auto &p : q->getParticipants()) {
-		if (participant->getAddress() == p->getAddress()) {
-			lInfo() << q <<" 'participant ' "<< p->getAddress() <<" no more authorized'";
-			q->getConference()->removeParticipant(p);
-			break;
-		}
+	const string participantKey = getParticipantKey(participant->getAddress());
+	auto participantIt = authorizedParticipantsByAddress.find(participantKey);
+	if (participantIt != authorizedParticipantsByAddress.end()) {
+		shared_ptr<Participant> p = participantIt->second;
+		lInfo() << q <<" 'participant ' "<< p->getAddress() <<" no more authorized'";
+		q->getConference()->removeParticipant(p);
+		authorizedParticipantsByAddress.erase(participantKey);
 	}
 
-	queuedMessages.erase(participant->getAddress().asString());
+	queuedMessages.erase(getDeviceKey(participant->getAddress()));
 
 	shared_ptr<ConferenceParticipantEvent> event = q->getConference()->notifyParticipantRemoved(time(nullptr), false, participant);
 	q->getCore()->getPrivate()->mainDb->addConferenceParticipantEventToDb(event);
@@ -713,19 +773,6 @@ void ServerGroupChatRoomPrivate::setParticipantDevices(const IdentityAddress &pa
 
 // -----------------------------------------------------------------------------
 
-void ServerGroupChatRoomPrivate::copyMessageHeaders (const shared_ptr<Message> &fromMessage, const shared_ptr<ChatMessage> &toMessage) {
-	string headersToCopy[] = {
-		"Content-Encoding",
-		"Expires",
-		"Priority"
-	};
-	for (const auto &headerName : headersToCopy) {
-		const char *headerValue = sal_custom_header_find(fromMessage->customHeaders, headerName.c_str());
-		if (headerValue)
-			toMessage->getPrivate()->addSalCustomHeader(headerName, headerValue);
-	}
-}
-
 /*
  * This method is in charge of applying the state of a participant device to the SIP session
  */
@@ -832,8 +879,8 @@ void ServerGroupChatRoomPrivate::sendMessage (const shared_ptr<Message> &message
 	L_Q();
 
 	shared_ptr<ChatMessage> msg = q->createChatMessage();
-	copyMessageHeaders(message, msg);
-	msg->getPrivate()->addSalCustomHeader("Session-mode", "true"); // Special custom header to identify MESSAGE that belong to server group chatroom
+	// The headers are prepared once at reception, each copy gets its own list as the ChatMessage may append to it.
+	msg->getPrivate()->setSalCustomHeaders(sal_custom_header_clone(message->customHeaders));
 	msg->setInternalContent(message->content);
 	msg->getPrivate()->forceFromAddress(q->getConferenceAddress());
 	msg->getPrivate()->forceToAddress(deviceAddr);
@@ -1003,25 +1050,27 @@ void ServerGroupChatRoomPrivate::queueMessage (const shared_ptr<Message> &msg) {
 		for (const auto &device : participant->getDevices()) {
 			// Queue the message for all devices except the one that sent it
 			if (msg->fromAddr != device->getAddress()){
-				queueMessage(msg, device->getAddress());
+				queueMessage(msg, device);
 			}
 		}
 	}
 }
 
-void ServerGroupChatRoomPrivate::queueMessage (const shared_ptr<Message> &msg, const IdentityAddress &deviceAddress) {
+void ServerGroupChatRoomPrivate::queueMessage (const shared_ptr<Message> &msg, const shared_ptr<ParticipantDevice> &device) {
 	chrono::system_clock::time_point timestamp = chrono::system_clock::now();
-	string uri(deviceAddress.asString());
+	QueuedMessages &deviceQueue = queuedMessages[getDeviceKey(device->getAddress())];
+	if (deviceQueue.messages.empty())
+		deviceQueue.deviceAddress = device->getAddress();
 	// Remove queued messages older than one week
-	while (!queuedMessages[uri].empty()) {
-		shared_ptr<Message> m = queuedMessages[uri].front();
+	while (!deviceQueue.messages.empty()) {
+		shared_ptr<Message> m = deviceQueue.messages.front();
 		chrono::hours age = chrono::duration_cast<chrono::hours>(timestamp - m->timestamp);
 		chrono::hours oneWeek(168);
 		if (age < oneWeek)
 			break;
-		queuedMessages[uri].pop();
+		deviceQueue.messages.pop();
 	}
-	queuedMessages[uri].push(msg);
+	deviceQueue.messages.push(msg);
 }
 
 /* The removal of participant device is done only when such device disapears from registration database, ie when a device unregisters explicitely
@@ -1296,6 +1345,8 @@ ServerGroupChatRoom::ServerGroupChatRoom (
 ) : ChatRoom(*new ServerGroupChatRoomPrivate(capabilities), core, params, make_shared<LocalConference>(core, peerAddress, nullptr, ConferenceParams::create(core->getCCore()),this)) {
 	L_D();
 	cachedParticipants = move(participants);
+	for (const auto &participant : cachedParticipants)
+		d->cachedParticipantsByAddress[ServerGroupChatRoomPrivate::getParticipantKey(participant->getAddress())] = participant;
 	getConference()->setLastNotify(lastNotifyId);
 	getConference()->setConferenceId(ConferenceId(peerAddress, peerAddress));
 	getConference()->confParams->setConferenceAddress(peerAddress);
@@ -1337,12 +1388,10 @@ shared_ptr<Participant> ServerGroupChatRoom::findParticipant (const shared_ptr<c
 }
 
 shared_ptr<Participant> ServerGroupChatRoom::findParticipant (const IdentityAddress &participantAddress) const {
-	IdentityAddress searchedAddr(participantAddress);
-	searchedAddr.setGruu("");
-	for (const auto &participant : getParticipants()) {
-		if (participant->getAddress() == searchedAddr)
-			return participant;
-	}
+	L_D();
+	auto it = d->authorizedParticipantsByAddress.find(ServerGroupChatRoomPrivate::getParticipantKey(participantAddress));
+	if (it != d->authorizedParticipantsByAddress.end())
+		return it->second;
 	lInfo() << "Unable to find participant in server group chat room " << this << " with address " << participantAddress.asString();
 	return nullptr;
 }
@@ -1357,13 +1406,9 @@ shared_ptr<Participant> ServerGroupChatRoom::findCachedParticipant (const shared
 }
 
 shared_ptr<Participant> ServerGroupChatRoom::findCachedParticipant (const IdentityAddress &participantAddress) const {
-	IdentityAddress searchedAddr(participantAddress);
-	searchedAddr.setGruu("");
-	for (const auto &participant : cachedParticipants) {
-		if (participant->getAddress() == searchedAddr)
-			return participant;
-	}
-	return nullptr;
+	L_D();
+	auto it = d->cachedParticipantsByAddress.find(ServerGroupChatRoomPrivate::getParticipantKey(participantAddress));
+	return it != d->cachedParticipantsByAddress.end() ? it->second : nullptr;
 }
 
 shared_ptr<ParticipantDevice> ServerGroupChatRoom::findCachedParticipantDevice (const shared_ptr<const CallSession> &session) const {
@@ -1512,7 +1557,7 @@ void ServerGroupChatRoom::setState (ConferenceInterface::State state) {
 				 * Since we don't have the protocol version at this stage (it will be known after receiving register information),
 				 * it is not a problem to push the two participants in the authorized list even if they are in the process of leaving.
 				 */
-				getConference()->participants.push_back(participant);
+				d->addAuthorizedParticipant(participant);
 			}else{
 				bool atLeastOneDeviceJoining = false;
 				bool atLeastOneDevicePresent = false;
@@ -1538,7 +1583,7 @@ void ServerGroupChatRoom::setState (ConferenceInterface::State state) {
 				//its devices were "BYEed" yet. This is what the line below is testing. Might be better to add a new state in the participant Class,
 				// but it's not the case yet.
 				if (atLeastOneDevicePresent || atLeastOneDeviceJoining || atLeastOneDeviceLeaving == false ){
-					getConference()->participants.push_back(participant);
+					d->addAuthorizedParticipant(participant);
 				}
 			}
 		}
@@ -17,6 +17,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cctype>
+#include <cstring>
 #include <set>
 
 #include <belr/abnf.h>
@@ -576,6 +578,419 @@ namespace Cpim {
 		list<shared_ptr<HeaderNode>> mContentHeaders;
 		list<shared_ptr<HeaderNode>> mMessageHeaders;
 	};
+
+	// -------------------------------------------------------------------------
+
+	// Single pass parser of the usual CPIM messages (From, To, cc, DateTime, NS, Require and generic headers without
+	// parameters). It builds the same nodes as the grammar and gives up on anything else, the message is then parsed
+	// with the grammar.
+	class FastParser {
+	public:
+		explicit FastParser (const string &input) : mInput(input) {}
+
+		shared_ptr<MessageNode> parseMessage (size_t &parsedSize);
+
+	private:
+		static bool isOneOf (char c, const char *chars) {
+			return c != '\0' && strchr(chars, c);
+		}
+
+		static bool isAlpha (char c) {
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+		}
+
+		static bool isDigit (char c) {
+			return c >= '0' && c <= '9';
+		}
+
+		static bool isHexDigit (char c) {
+			return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+		}
+
+		static bool isNameChar (char c) {
+			return c == 0x21 || (c >= 0x23 && c <= 0x27) || c == 0x2a || c == 0x2b || c == 0x2d
+				|| (c >= 0x5e && c <= 0x60) || c == 0x7c || c == 0x7e || isAlpha(c) || isDigit(c);
+		}
+
+		static bool isUnreserved (char c) {
+			return isAlpha(c) || isDigit(c) || isOneOf(c, "-_.!~*'()");
+		}
+
+		bool atEnd () const {
+			return mPos >= mInput.size();
+		}
+
+		char peek () const {
+			return atEnd() ? '\0' : mInput[mPos];
+		}
+
+		bool consume (const char *str);
+		bool consumeIgnoringCase (const char *str);
+		bool consumeCrlf ();
+		bool skipUtf8Multi ();
+		bool skipName ();
+		bool skipHeaderName ();
+		bool skipToken ();
+		bool skipString ();
+		bool skipUriChar (bool allowSlash);
+		bool parseNumber (size_t length, string &value);
+
+		bool parseUri (string &uri);
+		shared_ptr<HeaderNode> parseContactHeader (shared_ptr<ContactHeaderNode> node);
+		shared_ptr<HeaderNode> parseDateTimeHeader ();
+		shared_ptr<HeaderNode> parseNsHeader ();
+		shared_ptr<HeaderNode> parseRequireHeader ();
+		shared_ptr<HeaderNode> parseGenericHeader (const string &name);
+		shared_ptr<HeaderNode> parseHeader (bool messageHeader);
+
+		const string &mInput;
+		size_t mPos = 0;
+	};
+
+	bool FastParser::consume (const char *str) {
+		size_t length = strlen(str);
+		if (mInput.compare(mPos, length, str) != 0)
+			return false;
+		mPos += length;
+		return true;
+	}
+
+	bool FastParser::consumeIgnoringCase (const char *str) {
+		size_t length = strlen(str);
+		if (mPos + length > mInput.size())
+			return false;
+		for (size_t i = 0; i < length; i++) {
+			if (tolower(static_cast<unsigned char>(mInput[mPos + i])) != tolower(static_cast<unsigned char>(str[i])))
+				return false;
+		}
+		mPos += length;
+		return true;
+	}
+
+	bool FastParser::consumeCrlf () {
+		return consume("\r\n");
+	}
+
+	// UTF8-multi rule of the grammar.
+	bool FastParser::skipUtf8Multi () {
+		unsigned char c = static_cast<unsigned char>(peek());
+		size_t continuationBytes;
+		if (c >= 0xc0 && c <= 0xdf)
+			continuationBytes = 1;
+		else if (c >= 0xe0 && c <= 0xef)
+			continuationBytes = 2;
+		else if (c >= 0xf0 && c <= 0xf7)
+			continuationBytes = 3;
+		else if (c >= 0xf8 && c <= 0xfb)
+			continuationBytes = 4;
+		else if (c >= 0xfc && c <= 0xfd)
+			continuationBytes = 5;
+		else
+			return false;
+
+		if (mPos + continuationBytes >= mInput.size())
+			return false;
+		for (size_t i = 1; i <= continuationBytes; i++) {
+			unsigned char continuation = static_cast<unsigned char>(mInput[mPos + i]);
+			if (continuation < 0x80 || continuation > 0xbf)
+				return false;
+		}
+		mPos += continuationBytes + 1;
+		return true;
+	}
+
+	bool FastParser::skipName () {
+		size_t start = mPos;
+		while (!atEnd() && isNameChar(peek()))
+			mPos++;
+		return mPos > start;
+	}
+
+	// Header-name = [ Name-prefix "." ] Name
+	bool FastParser::skipHeaderName () {
+		if (!skipName())
+			return false;
+		if (peek() == '.') {
+			mPos++;
+			return skipName();
+		}
+		return true;
+	}
+
+	bool FastParser::skipToken () {
+		size_t start = mPos;
+		while (!atEnd()) {
+			char c = peek();
+			if (isNameChar(c) || c == '.')
+				mPos++;
+			else if (!skipUtf8Multi())
+				break;
+		}
+		return mPos > start;
+	}
+
+	bool FastParser::skipString () {
+		if (!consume("\""))
+			return false;
+		while (!atEnd()) {
+			unsigned char c = static_cast<unsigned char>(peek());
+			if (c == '"') {
+				mPos++;
+				return true;
+			}
+			if (c == '\\') {
+				mPos++;
+				char escaped = peek();
+				if (escaped == 'u') {
+					mPos++;
+					for (int i = 0; i < 4; i++, mPos++) {
+						if (!isHexDigit(peek()))
+							return false;
+					}
+				} else if (isOneOf(escaped, "btnr\"'\\")) {
+					mPos++;
+				} else
+					return false;
+			} else if (c >= 0x20 && c <= 0x7e) {
+				mPos++;
+			} else if (!skipUtf8Multi())
+				return false;
+		}
+		return false;
+	}
+
+	bool FastParser::skipUriChar (bool allowSlash) {
+		char c = peek();
+		if (c == '%') {
+			if (mPos + 2 >= mInput.size() || !isHexDigit(mInput[mPos + 1]) || !isHexDigit(mInput[mPos + 2]))
+				return false;
+			mPos += 3;
+			return true;
+		}
+		if (isUnreserved(c) || isOneOf(c, ";?:@&=+$,") || (allowSlash && isOneOf(c, "/[]"))) {
+			mPos++;
+			return true;
+		}
+		return false;
+	}
+
+	bool FastParser::parseNumber (size_t length, string &value) {
+		if (mPos + length > mInput.size())
+			return false;
+		for (size_t i = 0; i < length; i++) {
+			if (!isDigit(mInput[mPos + i]))
+				return false;
+		}
+		value = mInput.substr(mPos, length);
+		mPos += length;
+		return true;
+	}
+
+	// Only the opaque-part form of absoluteURI (sip:, urn:, tag:, ...), the hierarchical URIs are left to the grammar.
+	bool FastParser::parseUri (string &uri) {
+		size_t start = mPos;
+		if (!isAlpha(peek()))
+			return false;
+		while (isAlpha(peek()) || isDigit(peek()) || isOneOf(peek(), "+-."))
+			mPos++;
+		if (!consume(":") || !skipUriChar(false))
+			return false;
+		while (skipUriChar(true));
+		uri = mInput.substr(start, mPos - start);
+		return true;
+	}
+
+	// "From: " / "To: " / "cc: " [ Formal-name ] "<" URI ">"
+	shared_ptr<HeaderNode> FastParser::parseContactHeader (shared_ptr<ContactHeaderNode> node) {
+		size_t start = mPos;
+		if (peek() == '"') {
+			if (!skipString())
+				return nullptr;
+		} else {
+			// 1*( Token SP )
+			while (peek() != '<') {
+				if (!skipToken() || !consume(" "))
+					return nullptr;
+			}
+		}
+		if (mPos > start)
+			node->setFormalName(mInput.substr(start, mPos - start));
+
+		string uri;
+		if (!consume("<") || !parseUri(uri) || !consume(">"))
+			return nullptr;
+		node->setUri(uri);
+		return node;
+	}
+
+	// date-fullyear "-" date-month "-" date-mday "T" time-hour ":" time-minute ":" time-second [ time-secfrac ] time-offset
+	shared_ptr<HeaderNode> FastParser::parseDateTimeHeader () {
+		shared_ptr<DateTimeHeaderNode> node = make_shared<DateTimeHeaderNode>();
+		string value;
+		if (!parseNumber(4, value))
+			return nullptr;
+		node->setYear(value);
+		if (!consume("-") || !parseNumber(2, value))
+			return nullptr;
+		node->setMonth(value);
+		if (!consume("-") || !parseNumber(2, value))
+			return nullptr;
+		node->setMonthDay(value);
+		if (!consume("T") || !parseNumber(2, value))
+			return nullptr;
+		node->setHour(value);
+		if (!consume(":") || !parseNumber(2, value))
+			return nullptr;
+		node->setMinute(value);
+		if (!consume(":") || !parseNumber(2, value))
+			return nullptr;
+		node->setSecond(value);
+
+		if (consume(".")) {
+			if (!isDigit(peek()))
+				return nullptr;
+			while (isDigit(peek()))
+				mPos++;
+		}
+
+		shared_ptr<DateTimeOffsetNode> offset = make_shared<DateTimeOffsetNode>();
+		if (!consume("Z")) {
+			char sign = peek();
+			if (sign != '+' && sign != '-')
+				return nullptr;
+			mPos++;
+			offset->setSign(string(1, sign));
+			if (!parseNumber(2, value))
+				return nullptr;
+			offset->setHour(value);
+			if (!consume(":") || !parseNumber(2, value))
+				return nullptr;
+			offset->setMinute(value);
+		} else {
+			offset->setHour("0");
+			offset->setMinute("0");
+		}
+		node->setOffset(offset);
+		return node;
+	}
+
+	// "NS: " [ Name-prefix SP ] "<" URI ">"
+	shared_ptr<HeaderNode> FastParser::parseNsHeader () {
+		shared_ptr<NsHeaderNode> node = make_shared<NsHeaderNode>();
+		size_t start = mPos;
+		if (skipName()) {
+			node->setPrefixName(mInput.substr(start, mPos - start));
+			if (!consume(" "))
+				return nullptr;
+		}
+
+		string uri;
+		if (!consume("<") || !parseUri(uri) || !consume(">"))
+			return nullptr;
+		node->setUri(uri);
+		return node;
+	}
+
+	// "Require: " Header-name *( "," Header-name )
+	shared_ptr<HeaderNode> FastParser::parseRequireHeader () {
+		size_t start = mPos;
+		do {
+			if (!skipHeaderName())
+				return nullptr;
+		} while (consume(","));
+
+		shared_ptr<RequireHeaderNode> node = make_shared<RequireHeaderNode>();
+		node->setHeaderNames(mInput.substr(start, mPos - start));
+		return node;
+	}
+
+	// Header-name ":" SP Header-value, the header parameters are left to the grammar.
+	shared_ptr<HeaderNode> FastParser::parseGenericHeader (const string &name) {
+		if (!consume(" "))
+			return nullptr;
+
+		size_t start = mPos;
+		while (!atEnd()) {
+			unsigned char c = static_cast<unsigned char>(peek());
+			if (c >= 0x20 && c <= 0x7e)
+				mPos++;
+			else if (!skipUtf8Multi())
+				break;
+		}
+
+		shared_ptr<HeaderNode> node = make_shared<HeaderNode>();
+		node->setName(name);
+		node->setValue(mInput.substr(start, mPos - start));
+		return node;
+	}
+
+	shared_ptr<HeaderNode> FastParser::parseHeader (bool messageHeader) {
+		size_t start = mPos;
+		if (!skipHeaderName() || !consume(":"))
+			return nullptr;
+		string name = mInput.substr(start, mPos - start - 1);
+
+		if (messageHeader) {
+			// The header names of the grammar are case insensitive, other spellings of the reserved ones are left to it.
+			static const char *reservedNames[] = { "From", "To", "cc", "DateTime", "NS", "Require", "Subject" };
+			for (const char *reservedName : reservedNames) {
+				if (name != reservedName && Utils::iequals(name, reservedName))
+					return nullptr;
+			}
+		}
+
+		shared_ptr<HeaderNode> node;
+		if (!messageHeader)
+			node = parseGenericHeader(name);
+		else if (name == "From" || name == "To" || name == "cc") {
+			if (!consume(" "))
+				return nullptr;
+			if (name == "From")
+				node = parseContactHeader(make_shared<FromHeaderNode>());
+			else if (name == "To")
+				node = parseContactHeader(make_shared<ToHeaderNode>());
+			else
+				node = parseContactHeader(make_shared<CcHeaderNode>());
+		} else if (name == "DateTime")
+			node = consume(" ") ? parseDateTimeHeader() : nullptr;
+		else if (name == "NS")
+			node = consume(" ") ? parseNsHeader() : nullptr;
+		else if (name == "Require")
+			node = consume(" ") ? parseRequireHeader() : nullptr;
+		else if (name != "Subject")
+			node = parseGenericHeader(name);
+
+		if (!node || !consumeCrlf())
+			return nullptr;
+		return node;
+	}
+
+	shared_ptr<MessageNode> FastParser::parseMessage (size_t &parsedSize) {
+		shared_ptr<MessageNode> messageNode = make_shared<MessageNode>();
+		shared_ptr<ListHeaderNode> messageHeaders = make_shared<ListHeaderNode>();
+		shared_ptr<ListHeaderNode> contentHeaders = make_shared<ListHeaderNode>();
+
+		// Optional Crappy-header, followed by an empty line. The literals of the grammar are case insensitive.
+		consumeIgnoringCase("Content-Type: Message/CPIM\r\n\r\n");
+		do {
+			shared_ptr<HeaderNode> header = parseHeader(true);
+			if (!header)
+				return nullptr;
+			messageHeaders->push_back(header);
+		} while (!consumeCrlf());
+
+		do {
+			shared_ptr<HeaderNode> header = parseHeader(false);
+			if (!header)
+				return nullptr;
+			contentHeaders->push_back(header);
+		} while (!consumeCrlf());
+
+		messageNode->addMessageHeaders(messageHeaders);
+		messageNode->addContentHeaders(contentHeaders);
+		parsedSize = mPos;
+		return messageNode;
+	}
 }
 
 // -----------------------------------------------------------------------------
@@ -584,6 +999,7 @@ class Cpim::ParserPrivate : public ObjectPrivate {
 public:
 	
 	shared_ptr<belr::Parser<shared_ptr<Node> >> parser;
+	size_t fastParsedMessagesCount = 0;
 };
 
 Cpim::Parser::Parser () : Singleton(*new ParserPrivate) {
@@ -659,6 +1075,27 @@ Cpim::Parser::Parser () : Singleton(*new ParserPrivate) {
 shared_ptr<Cpim::Message> Cpim::Parser::parseMessage (const string &input) {
 	L_D();
 
+	size_t parsedSize;
+	shared_ptr<MessageNode> messageNode = FastParser(input).parseMessage(parsedSize);
+	if (!messageNode)
+		return parseMessageWithGrammar(input);
+	d->fastParsedMessagesCount++;
+
+	shared_ptr<Message> message = messageNode->createMessage();
+	if (message) {
+		message->setContent(input.substr(parsedSize));
+	}
+	return message;
+}
+
+size_t Cpim::Parser::getFastParsedMessagesCount () const {
+	L_D();
+	return d->fastParsedMessagesCount;
+}
+
+shared_ptr<Cpim::Message> Cpim::Parser::parseMessageWithGrammar (const string &input) {
+	L_D();
+
 	size_t parsedSize;
 	shared_ptr<Node> node = d->parser->parseInput("Message", input, &parsedSize);
 	if (!node) {
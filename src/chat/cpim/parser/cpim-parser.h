@@ -34,7 +34,12 @@ namespace Cpim {
 		friend class Singleton<Parser>;
 
 	public:
+		// Usual messages are parsed by a hand-written parser, the other ones by the CPIM grammar.
 		std::shared_ptr<Message> parseMessage (const std::string &input);
+		// Parse with the CPIM grammar only.
+		std::shared_ptr<Message> parseMessageWithGrammar (const std::string &input);
+		// Number of messages parseMessage() did not give to the CPIM grammar.
+		size_t getFastParsedMessagesCount () const;
 
 		std::shared_ptr<Header> cloneHeader (const Header &header);
 
@@ -69,6 +69,10 @@ public:
 		FileTransferContent *fileTransferContent
 	) {}
 
+	// Tell if downloadingFile() and uploadingFile() accept the same buffer as input and output,
+	// which lets file transfers process each chunk in place instead of going through a scratch buffer.
+	virtual bool isFileTransferInPlaceSupported () const { return false; }
+
 	virtual int downloadingFile (
 		const std::shared_ptr<ChatMessage> &message,
 		size_t offset,
@@ -531,6 +531,11 @@ void LimeX3dhEncryptionEngine::generateFileTransferKey (
 	bctbx_clean(keyBuffer, FILE_TRANSFER_KEY_SIZE);
 }
 
+bool LimeX3dhEncryptionEngine::isFileTransferInPlaceSupported () const {
+	// AES-GCM is a stream mode: bctbx_aes_gcm_encryptFile() and bctbx_aes_gcm_decryptFile() can write over their input.
+	return true;
+}
+
 int LimeX3dhEncryptionEngine::downloadingFile (
 	const shared_ptr<ChatMessage> &message,
 	size_t offset,
@@ -17,6 +17,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "linphone/api/c-content.h"
 
 #include "address/address.h"
@@ -56,6 +58,7 @@ FileTransferChatMessageModifier::~FileTransferChatMessageModifier () {
 		cancelFileTransfer(); //to avoid body handler to still refference zombie FileTransferChatMessageModifier
 	else
 		releaseHttpRequest();
+	releaseChunkBuffers();
 }
 
 ChatMessageModifier::Result FileTransferChatMessageModifier::encode (const shared_ptr<ChatMessage> &message, int &errorCode) {
@@ -64,17 +67,34 @@ ChatMessageModifier::Result FileTransferChatMessageModifier::encode (const share
 	currentFileContentToTransfer = nullptr;
 	currentFileTransferContent = nullptr;
 	// For each FileContent, upload it and create a FileTransferContent
+	list<FileContent *> fileContents;
 	for (Content *content : message->getContents()) {
 		if (content->isFile()) {
 				lInfo() << "Found file content [" << content << "], set it for file upload";
-				FileContent *fileContent = (FileContent *)content;
-				currentFileContentToTransfer = fileContent;
-				break;
+				fileContents.push_back((FileContent *)content);
 		}
 	}
-	if (!currentFileContentToTransfer)
+	if (fileContents.empty())
 		return ChatMessageModifier::Result::Skipped;
 
+	int maxParallelUploads = linphone_config_get_int(linphone_core_get_config(message->getCore()->getCCore()), "misc", "max_parallel_file_uploads", 1);
+	if (maxParallelUploads > 1 && fileContents.size() > 1) {
+		// Upload up to maxParallelUploads contents at once, the message is sent again once all of them are done.
+		lInfo() << "Uploading the " << fileContents.size() << " file contents of message [" << message << "], " << maxParallelUploads << " at once";
+		pendingParallelUploads = fileContents;
+		for (int i = 0; i < maxParallelUploads && !pendingParallelUploads.empty(); i++) {
+			if (startNextParallelUpload() != 0) {
+				pendingParallelUploads.clear();
+				cancelParallelUploads();
+				return ChatMessageModifier::Result::Error;
+			}
+		}
+		return ChatMessageModifier::Result::Suspended;
+	}
+
+	// Otherwise the file contents are uploaded one after the other, the next one when the message is sent again.
+	currentFileContentToTransfer = fileContents.front();
+
 	/* Open a transaction with the server and send an empty request(RCS5.1 section 3.5.4.8.3.1) */
 	if (uploadFile(nullptr) == 0)
 		return ChatMessageModifier::Result::Suspended;
@@ -188,29 +208,29 @@ int FileTransferChatMessageModifier::onSendBody (
 		// Deprecated, use _linphone_chat_message_notify_file_transfer_send_chunk instead
 		_linphone_chat_message_notify_file_transfer_send(msg, content, offset, *size);
 
-		LinphoneBuffer *lb = linphone_buffer_new();
+		LinphoneBuffer *lb = getChunkLinphoneBuffer();
 		_linphone_chat_message_notify_file_transfer_send_chunk(msg, content, offset, *size, lb);
 		size_t lb_size = linphone_buffer_get_size(lb);
 		if (lb_size != 0) {
 			memcpy(buffer, linphone_buffer_get_content(lb), lb_size);
 			*size = lb_size;
 		}
-		linphone_buffer_unref(lb);
 	}
 
 	EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
 	if (imee) {
 		size_t max_size = *size;
-		uint8_t *encrypted_buffer = (uint8_t *)ms_malloc0(max_size);
+		// Encrypt the chunk where belle-sip expects it if the engine allows it.
+		uint8_t *encrypted_buffer = imee->isFileTransferInPlaceSupported() ? buffer : getChunkBuffer(max_size);
 		retval = imee->uploadingFile(L_GET_CPP_PTR_FROM_C_OBJECT(msg), offset, buffer, size, encrypted_buffer, currentFileTransferContent);
 		if (retval == 0) {
 			if (*size > max_size) {
 				lError() << "IM encryption engine process upload file callback returned a size bigger than the size of the buffer, so it will be truncated !";
 				*size = max_size;
 			}
-			memcpy(buffer, encrypted_buffer, *size);
+			if (encrypted_buffer != buffer)
+				memcpy(buffer, encrypted_buffer, *size);
 		}
-		ms_free(encrypted_buffer);
 	}
 
 	return retval <= 0 && *size != 0 ? BELLE_SIP_CONTINUE : BELLE_SIP_STOP;
@@ -288,18 +308,19 @@ belle_sip_body_handler_t *FileTransferChatMessageModifier::prepare_upload_body_h
 		EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
 		if (imee) {
 			size_t max_size = buf_size;
-			uint8_t *encrypted_buffer = (uint8_t *)ms_malloc0(max_size);
+			uint8_t *encrypted_buffer = imee->isFileTransferInPlaceSupported() ? buf : getChunkBuffer(max_size);
 			int retval = imee->uploadingFile(message, 0, buf, &max_size, encrypted_buffer, currentFileTransferContent);
 			if (retval == 0) {
 				if (max_size > buf_size) {
 					lError() << "IM encryption engine process upload file callback returned a size bigger than the size of the buffer, so it will be truncated !";
 					max_size = buf_size;
 				}
-				memcpy(buf, encrypted_buffer, buf_size);
+				if (encrypted_buffer != buf)
+					memcpy(buf, encrypted_buffer, buf_size);
 				// Call it once more to compute the authentication tag
 				imee->uploadingFile(message, 0, nullptr, 0, nullptr, currentFileTransferContent);
 			}
-			ms_free(encrypted_buffer);
+			releaseChunkBuffers();
 		}
 
 		first_part_bh = (belle_sip_body_handler_t *)belle_sip_memory_body_handler_new_from_buffer(
@@ -356,6 +377,8 @@ void FileTransferChatMessageModifier::processResponseFromPostFile (const belle_h
 					fileUploadEndBackgroundTask();
 
 					delete parsedXmlFileTransferContent;
+					if (parentUpload)
+						parentUpload->onParallelUploadEnded(this, false);
 					return;
 				}
 
@@ -376,6 +399,13 @@ void FileTransferChatMessageModifier::processResponseFromPostFile (const belle_h
 				currentFileTransferContent->setBodyFromUtf8(xml_body.c_str());
 				currentFileTransferContent = nullptr;
 
+				if (parentUpload) {
+					releaseHttpRequest();
+					fileUploadEndBackgroundTask();
+					parentUpload->onParallelUploadEnded(this, true);
+					return;
+				}
+
 				message->getPrivate()->setState(ChatMessage::State::FileTransferDone);
 				releaseHttpRequest();
 				message->getPrivate()->send();
@@ -389,6 +419,8 @@ void FileTransferChatMessageModifier::processResponseFromPostFile (const belle_h
 				message->getPrivate()->setState(ChatMessage::State::NotDelivered);
 				releaseHttpRequest();
 				fileUploadEndBackgroundTask();
+				if (parentUpload)
+					parentUpload->onParallelUploadEnded(this, false);
 			}
 		} else if (code == 400) {
 			lWarning() << "Received HTTP code response " << code << " for file transfer, probably meaning file is too large";
@@ -399,6 +431,8 @@ void FileTransferChatMessageModifier::processResponseFromPostFile (const belle_h
 			message->getPrivate()->setState(ChatMessage::State::FileTransferError);
 			releaseHttpRequest();
 			fileUploadEndBackgroundTask();
+			if (parentUpload)
+				parentUpload->onParallelUploadEnded(this, false);
 		} else if (code == 401) {
 			lWarning() << "Received HTTP code response " << code << " for file transfer, probably meaning that our credentials were rejected";
 			message->getPrivate()->replaceContent(currentFileTransferContent, currentFileContentToTransfer);
@@ -408,6 +442,8 @@ void FileTransferChatMessageModifier::processResponseFromPostFile (const belle_h
 			message->getPrivate()->setState(ChatMessage::State::FileTransferError);
 			releaseHttpRequest();
 			fileUploadEndBackgroundTask();
+			if (parentUpload)
+				parentUpload->onParallelUploadEnded(this, false);
 		} else {
 			lWarning() << "Unhandled HTTP code response " << code << " for file transfer";
 			message->getPrivate()->replaceContent(currentFileTransferContent, currentFileContentToTransfer);
@@ -417,6 +453,8 @@ void FileTransferChatMessageModifier::processResponseFromPostFile (const belle_h
 			message->getPrivate()->setState(ChatMessage::State::NotDelivered);
 			releaseHttpRequest();
 			fileUploadEndBackgroundTask();
+			if (parentUpload)
+				parentUpload->onParallelUploadEnded(this, false);
 		}
 	}
 }
@@ -433,6 +471,8 @@ void FileTransferChatMessageModifier::processIoErrorUpload (const belle_sip_io_e
 		return;
 	message->getPrivate()->setState(ChatMessage::State::NotDelivered);
 	releaseHttpRequest();
+	if (parentUpload)
+		parentUpload->onParallelUploadEnded(this, false);
 }
 
 static void _chat_message_process_auth_requested_upload (void *data, belle_sip_auth_event *event) {
@@ -550,6 +590,81 @@ error:
 	return -1;
 }
 
+int FileTransferChatMessageModifier::startNextParallelUpload () {
+	shared_ptr<ChatMessage> message = chatMessage.lock();
+	if (!message || pendingParallelUploads.empty())
+		return -1;
+
+	shared_ptr<FileTransferChatMessageModifier> upload = make_shared<FileTransferChatMessageModifier>(provider);
+	upload->chatMessage = message;
+	upload->currentFileContentToTransfer = pendingParallelUploads.front();
+	upload->parentUpload = this;
+	pendingParallelUploads.pop_front();
+	parallelUploads.push_back(upload);
+
+	lInfo() << "Starting upload of file content [" << upload->currentFileContentToTransfer << "] of message [" << message << "]";
+	/* Open a transaction with the server and send an empty request(RCS5.1 section 3.5.4.8.3.1) */
+	return upload->uploadFile(nullptr);
+}
+
+void FileTransferChatMessageModifier::onParallelUploadEnded (FileTransferChatMessageModifier *upload, bool success) {
+	auto it = find_if(parallelUploads.begin(), parallelUploads.end(), [upload](const shared_ptr<FileTransferChatMessageModifier> &parallelUpload) {
+		return parallelUpload.get() == upload;
+	});
+	if (it == parallelUploads.end())
+		return;
+
+	shared_ptr<ChatMessage> message = chatMessage.lock();
+	if (!message)
+		return;
+
+	// The ended upload is still running the callback that notified us, destroy it later.
+	shared_ptr<FileTransferChatMessageModifier> endedUpload = *it;
+	parallelUploads.erase(it);
+	message->getCore()->doLater([endedUpload]() {});
+
+	if (!success) {
+		// The message state has been set by the failed upload, the other ones are useless now.
+		lWarning() << "Upload of a file content of message [" << message << "] failed, cancelling the other ones";
+		pendingParallelUploads.clear();
+		cancelParallelUploads();
+		return;
+	}
+
+	if (!pendingParallelUploads.empty()) {
+		if (startNextParallelUpload() != 0) {
+			message->getPrivate()->setState(ChatMessage::State::NotDelivered);
+			pendingParallelUploads.clear();
+			cancelParallelUploads();
+		}
+		return;
+	}
+
+	if (parallelUploads.empty()) {
+		// Every file content has been replaced by its FileTransferContent, the message can now be sent.
+		message->getPrivate()->setState(ChatMessage::State::FileTransferDone);
+		message->getPrivate()->send();
+	}
+}
+
+void FileTransferChatMessageModifier::cancelParallelUploads () {
+	shared_ptr<ChatMessage> message = chatMessage.lock();
+
+	// Cancelling an upload may notify its end, take them out of the list first.
+	list<shared_ptr<FileTransferChatMessageModifier>> uploads;
+	uploads.swap(parallelUploads);
+	for (const auto &upload : uploads) {
+		// Give the file content back to the message, as when an upload fails.
+		if (message && upload->currentFileTransferContent && upload->currentFileContentToTransfer) {
+			message->getPrivate()->replaceContent(upload->currentFileTransferContent, upload->currentFileContentToTransfer);
+			delete upload->currentFileTransferContent;
+			upload->currentFileTransferContent = nullptr;
+		}
+		upload->cancelFileTransfer();
+		upload->fileUploadEndBackgroundTask();
+	}
+}
+
 void FileTransferChatMessageModifier::fileUploadBeginBackgroundTask () {
 	shared_ptr<ChatMessage> message = chatMessage.lock();
 	if (!message)
@@ -612,12 +727,12 @@ void FileTransferChatMessageModifier::onRecvBody (belle_sip_user_body_handler_t
 	int retval = -1;
 	EncryptionEngine *imee = message->getCore()->getEncryptionEngine();
 	if (imee) {
-		uint8_t *decrypted_buffer = (uint8_t *)ms_malloc0(size);
+		// Decrypt the chunk in the belle-sip buffer if the engine allows it.
+		uint8_t *decrypted_buffer = imee->isFileTransferInPlaceSupported() ? buffer : getChunkBuffer(size);
 		retval = imee->downloadingFile(message, offset, buffer, size, decrypted_buffer, currentFileTransferContent);
-		if (retval == 0) {
+		if (retval == 0 && decrypted_buffer != buffer) {
 			memcpy(buffer, decrypted_buffer, size);
 		}
-		ms_free(decrypted_buffer);
 	}
 
 	if (retval == 0 || retval == -1) {
@@ -625,7 +740,9 @@ void FileTransferChatMessageModifier::onRecvBody (belle_sip_user_body_handler_t
 			LinphoneChatMessage *msg = L_GET_C_BACK_PTR(message);
 			LinphoneChatMessageCbs *cbs = linphone_chat_message_get_callbacks(msg);
 			LinphoneContent *content = L_GET_C_BACK_PTR((Content *)currentFileContentToTransfer);
-			LinphoneBuffer *lb = linphone_buffer_new_from_data(buffer, size);
+			// The chunk is only valid during the callbacks, give it to them without copying it.
+			LinphoneBuffer *lb = getChunkLinphoneBuffer();
+			linphone_buffer_set_borrowed_content(lb, buffer, size);
 			// Deprecated: use list of callbacks now
 			if (linphone_chat_message_cbs_get_file_transfer_recv(cbs)) {
 				linphone_chat_message_cbs_get_file_transfer_recv(cbs)(msg, content, lb);
@@ -634,7 +751,7 @@ void FileTransferChatMessageModifier::onRecvBody (belle_sip_user_body_handler_t
 				linphone_core_notify_file_transfer_recv(message->getCore()->getCCore(), msg, content, (const char *)buffer, size);
 			}
 			_linphone_chat_message_notify_file_transfer_recv(msg, content, lb);
-			linphone_buffer_unref(lb);
+			linphone_buffer_set_borrowed_content(lb, nullptr, 0);
 		}
 	} else {
 		lWarning() << "File transfer decrypt failed with code -" << hex <<(int)(-retval);
@@ -925,6 +1042,12 @@ bool FileTransferChatMessageModifier::downloadFile (
 // ----------------------------------------------------------
 
 void FileTransferChatMessageModifier::cancelFileTransfer () {
+	if (!parallelUploads.empty()) {
+		pendingParallelUploads.clear();
+		cancelParallelUploads();
+		return;
+	}
+
 	if (!httpRequest) {
 		lInfo() << "No existing file transfer - nothing to cancel";
 		return;
@@ -960,7 +1083,11 @@ void FileTransferChatMessageModifier::cancelFileTransfer () {
 }
 
 bool FileTransferChatMessageModifier::isFileTransferInProgressAndValid () const {
-	return httpRequest && !belle_http_request_is_cancelled(httpRequest);
+	if (httpRequest && !belle_http_request_is_cancelled(httpRequest))
+		return true;
+	return any_of(parallelUploads.cbegin(), parallelUploads.cend(), [](const shared_ptr<FileTransferChatMessageModifier> &upload) {
+		return upload->isFileTransferInProgressAndValid();
+	});
 }
 
 void FileTransferChatMessageModifier::releaseHttpRequest () {
@@ -973,6 +1100,30 @@ void FileTransferChatMessageModifier::releaseHttpRequest () {
 		}
 	}
 	currentFileContentToTransfer = nullptr;
+	releaseChunkBuffers();
+}
+
+uint8_t *FileTransferChatMessageModifier::getChunkBuffer (size_t size) {
+	// Chunks have the same size during a transfer, the buffer is allocated once.
+	if (chunkBuffer.size() < size)
+		chunkBuffer.resize(size);
+	return chunkBuffer.data();
+}
+
+LinphoneBuffer *FileTransferChatMessageModifier::getChunkLinphoneBuffer () {
+	if (!chunkLinphoneBuffer)
+		chunkLinphoneBuffer = linphone_buffer_new();
+	else
+		linphone_buffer_set_borrowed_content(chunkLinphoneBuffer, nullptr, 0);
+	return chunkLinphoneBuffer;
+}
+
+void FileTransferChatMessageModifier::releaseChunkBuffers () {
+	vector<uint8_t>().swap(chunkBuffer);
+	if (chunkLinphoneBuffer) {
+		linphone_buffer_unref(chunkLinphoneBuffer);
+		chunkLinphoneBuffer = nullptr;
+	}
 }
 
 /* -------------------------------------------------------------------------------------- */
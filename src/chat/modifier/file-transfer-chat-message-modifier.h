@@ -20,6 +20,10 @@
 #ifndef _L_FILE_TRANSFER_CHAT_MESSAGE_MODIFIER_H_
 #define _L_FILE_TRANSFER_CHAT_MESSAGE_MODIFIER_H_
 
+#include <list>
+#include <memory>
+#include <vector>
+
 #include <belle-sip/belle-sip.h>
 
 #include "chat-message-modifier.h"
@@ -83,6 +87,14 @@ private:
 
 	void onDownloadFailed ();
 	void releaseHttpRequest ();
+
+	int startNextParallelUpload ();
+	void onParallelUploadEnded (FileTransferChatMessageModifier *upload, bool success);
+	void cancelParallelUploads ();
+
+	uint8_t *getChunkBuffer (size_t size);
+	LinphoneBuffer *getChunkLinphoneBuffer ();
+	void releaseChunkBuffers ();
 	belle_sip_body_handler_t *prepare_upload_body_handler(std::shared_ptr<ChatMessage> message);
 
 	std::weak_ptr<ChatMessage> chatMessage;
@@ -95,6 +107,15 @@ private:
 
 	size_t lastNotifiedPercentage = 0;
 
+	// When several file contents are uploaded at once, each upload is run by its own modifier.
+	std::list<FileContent *> pendingParallelUploads;
+	std::list<std::shared_ptr<FileTransferChatMessageModifier>> parallelUploads;
+	FileTransferChatMessageModifier *parentUpload = nullptr;
+
+	// Reused by all the chunks of the current transfer instead of allocating them for each chunk.
+	std::vector<uint8_t> chunkBuffer;
+	LinphoneBuffer *chunkLinphoneBuffer = nullptr;
+
 	BackgroundTask bgTask;
 };
 
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <bctoolbox/port.h>
+
+#include "chat/chat-message/chat-message.h"
+#include "core/core-p.h"
+#include "imdn.h"
+#include "logger/logger.h"
+
+#include "imdn-scheduler.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+ImdnScheduler::ImdnScheduler (const shared_ptr<Core> &core) : CoreAccessor(core) {
+	LinphoneConfig *config = linphone_core_get_config(core->getCCore());
+	maxSendsPerInterval = (unsigned int)max(0, linphone_config_get_int(config, "misc", "imdn_max_sends_per_interval", 20));
+	sendInterval = (unsigned int)max(1, linphone_config_get_int(config, "misc", "imdn_send_interval", 200));
+}
+
+ImdnScheduler::~ImdnScheduler () {
+	stopTimer();
+	if (persistTimer) {
+		belle_sip_source_cancel(persistTimer);
+		belle_sip_object_unref(persistTimer);
+	}
+	if (!pendingDeliveredIds.empty() || !pendingDisplayedIds.empty())
+		lWarning() << "ImdnScheduler: " << (pendingDeliveredIds.size() + pendingDisplayedIds.size()) << " delivered IMDN states not saved.";
+}
+
+// -----------------------------------------------------------------------------
+
+void ImdnScheduler::schedule (Imdn *imdn) {
+	if (queuedImdns.find(imdn) != queuedImdns.end())
+		return;
+
+	// Do not overtake the chat rooms already waiting.
+	if (queue.empty() && acquireSendSlot()) {
+		stats.sends++;
+		imdn->send();
+		return;
+	}
+
+	queuedImdns[imdn] = queue.insert(queue.end(), QueuedImdn{ imdn, bctbx_get_cur_time_ms() });
+	stats.queueDepth = queue.size();
+	stats.maxQueueDepth = max(stats.maxQueueDepth, stats.queueDepth);
+	if (!timer) {
+		uint64_t elapsed = bctbx_get_cur_time_ms() - intervalStart;
+		startTimer(elapsed < sendInterval ? (unsigned int)(sendInterval - elapsed) : 0);
+	}
+}
+
+void ImdnScheduler::unschedule (Imdn *imdn) {
+	auto it = queuedImdns.find(imdn);
+	if (it == queuedImdns.end())
+		return;
+
+	queue.erase(it->second);
+	queuedImdns.erase(it);
+	stats.queueDepth = queue.size();
+	if (queue.empty())
+		stopTimer();
+}
+
+// -----------------------------------------------------------------------------
+
+void ImdnScheduler::persistDelivered (
+	const list<shared_ptr<ChatMessage>> &deliveredMessages,
+	const list<shared_ptr<ChatMessage>> &displayedMessages
+) {
+	for (const auto &chatMessage : deliveredMessages) {
+		if (chatMessage->isValid())
+			pendingDeliveredIds.push_back(chatMessage->getStorageId());
+	}
+	for (const auto &chatMessage : displayedMessages) {
+		if (chatMessage->isValid())
+			pendingDisplayedIds.push_back(chatMessage->getStorageId());
+	}
+
+	// The 200 OK of the IMDNs of the other chat rooms are likely to follow, save them together.
+	if (!persistTimer && (!pendingDeliveredIds.empty() || !pendingDisplayedIds.empty())) {
+		persistTimer = getCore()->createTimer([this]() {
+			flushPendingWrites();
+			return false;
+		}, sendInterval, "IMDN persistence");
+	}
+}
+
+void ImdnScheduler::flushPendingWrites () {
+	if (persistTimer) {
+		belle_sip_source_cancel(persistTimer);
+		belle_sip_object_unref(persistTimer);
+		persistTimer = nullptr;
+	}
+	if (pendingDeliveredIds.empty() && pendingDisplayedIds.empty())
+		return;
+
+	const size_t count = pendingDeliveredIds.size() + pendingDisplayedIds.size();
+	getCore()->getPrivate()->mainDb->disableNotificationsRequired(pendingDeliveredIds, pendingDisplayedIds);
+	pendingDeliveredIds.clear();
+	pendingDisplayedIds.clear();
+	stats.persistedBatches++;
+	stats.persistedMessages += (unsigned int)count;
+	lDebug() << "ImdnScheduler: delivered IMDN states of " << count << " messages saved.";
+}
+
+// -----------------------------------------------------------------------------
+
+bool ImdnScheduler::acquireSendSlot () {
+	if (maxSendsPerInterval == 0)
+		return true;
+
+	uint64_t now = bctbx_get_cur_time_ms();
+	if (now - intervalStart >= sendInterval) {
+		intervalStart = now;
+		intervalSends = 0;
+	}
+	if (intervalSends >= maxSendsPerInterval)
+		return false;
+
+	intervalSends++;
+	return true;
+}
+
+void ImdnScheduler::sendQueued () {
+	while (!queue.empty() && acquireSendSlot()) {
+		QueuedImdn queued = queue.front();
+		queue.pop_front();
+		queuedImdns.erase(queued.imdn);
+
+		uint64_t latency = bctbx_get_cur_time_ms() - queued.queueTime;
+		stats.sends++;
+		stats.delayedSends++;
+		stats.lastFlushLatency = latency;
+		stats.maxFlushLatency = max(stats.maxFlushLatency, latency);
+		stats.totalFlushLatency += latency;
+		queued.imdn->send();
+	}
+	stats.queueDepth = queue.size();
+
+	if (!queue.empty())
+		lInfo() << "ImdnScheduler: " << queue.size() << " chat rooms still waiting to send their IMDNs (max latency: "
+			<< stats.maxFlushLatency << "ms).";
+}
+
+void ImdnScheduler::startTimer (unsigned int duration) {
+	timer = getCore()->createTimer([this]() {
+		sendQueued();
+		if (!queue.empty()) {
+			belle_sip_source_set_timeout_int64(timer, (int64_t)sendInterval);
+			return true;
+		}
+		stopTimer();
+		return false;
+	}, duration, "IMDN scheduler");
+}
+
+void ImdnScheduler::stopTimer () {
+	// Not through the core, the scheduler may be destroyed with it.
+	if (timer) {
+		belle_sip_source_cancel(timer);
+		belle_sip_object_unref(timer);
+		timer = nullptr;
+	}
+}
+
+LINPHONE_END_NAMESPACE
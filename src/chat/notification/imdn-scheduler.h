@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_IMDN_SCHEDULER_H_
+#define _L_IMDN_SCHEDULER_H_
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "core/core-accessor.h"
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+typedef struct belle_sip_source belle_sip_source_t;
+
+LINPHONE_BEGIN_NAMESPACE
+
+class ChatMessage;
+class Imdn;
+
+/*
+ * Paces the IMDN MESSAGEs sent by all the chat rooms of a core. When a client catches up
+ * on many chat rooms (typically after being offline), the rooms ready to send their IMDNs
+ * are queued and at most [misc] imdn_max_sends_per_interval of them send every
+ * [misc] imdn_send_interval milliseconds instead of all of them at once.
+ * The database updates following the delivery of the IMDNs are grouped in one transaction.
+ */
+class ImdnScheduler : public CoreAccessor {
+public:
+	struct Stats {
+		size_t queueDepth = 0; // Chat rooms currently waiting to send their IMDNs.
+		size_t maxQueueDepth = 0;
+		unsigned int sends = 0; // Chat rooms that sent their IMDNs.
+		unsigned int delayedSends = 0; // Among them, the ones that had to wait in the queue.
+		// Time spent in the queue by the delayed chat rooms, in milliseconds.
+		uint64_t lastFlushLatency = 0;
+		uint64_t maxFlushLatency = 0;
+		uint64_t totalFlushLatency = 0;
+		unsigned int persistedBatches = 0;
+		unsigned int persistedMessages = 0;
+	};
+
+	ImdnScheduler (const std::shared_ptr<Core> &core);
+	~ImdnScheduler ();
+
+	// Send the IMDNs of a chat room now if the rate allows it, or as soon as possible otherwise.
+	void schedule (Imdn *imdn);
+	void unschedule (Imdn *imdn);
+
+	// The messages whose IMDNs have been delivered no longer require them in database.
+	void persistDelivered (
+		const std::list<std::shared_ptr<ChatMessage>> &deliveredMessages,
+		const std::list<std::shared_ptr<ChatMessage>> &displayedMessages
+	);
+	void flushPendingWrites ();
+
+	const Stats &getStats () const {
+		return stats;
+	}
+
+private:
+	struct QueuedImdn {
+		Imdn *imdn;
+		uint64_t queueTime;
+	};
+
+	bool acquireSendSlot ();
+	void sendQueued ();
+	void startTimer (unsigned int duration);
+	void stopTimer ();
+
+	std::list<QueuedImdn> queue;
+	std::unordered_map<const Imdn *, std::list<QueuedImdn>::iterator> queuedImdns;
+	unsigned int maxSendsPerInterval = 0;
+	unsigned int sendInterval = 0;
+	uint64_t intervalStart = 0;
+	unsigned int intervalSends = 0;
+	belle_sip_source_t *timer = nullptr;
+
+	std::list<long long> pendingDeliveredIds;
+	std::list<long long> pendingDisplayedIds;
+	belle_sip_source_t *persistTimer = nullptr;
+
+	Stats stats;
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_IMDN_SCHEDULER_H_
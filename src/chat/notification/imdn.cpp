@@ -30,6 +30,7 @@
 #include "chat/encryption/encryption-engine.h"
 #endif
 
+#include "imdn-scheduler.h"
 #include "imdn.h"
 
 // =============================================================================
@@ -47,6 +48,9 @@ Imdn::Imdn (ChatRoom *chatRoom) : chatRoom(chatRoom) {
 Imdn::~Imdn () {
 	stopTimer();
 	try { //getCore may no longuer be available when deleting, specially in case of managed enviroment like java
+		ImdnScheduler *scheduler = chatRoom->getCore()->getImdnScheduler();
+		if (scheduler)
+			scheduler->unschedule(this);
 		chatRoom->getCore()->getPrivate()->unregisterListener(this);
 	} catch (const bad_weak_ptr &) {}
 }
@@ -88,14 +92,20 @@ void Imdn::onImdnMessageDelivered (const std::shared_ptr<ImdnMessage> &message)
 	// If an IMDN has been successfully delivered, remove it from the list so that
 	// it does not get sent again
 	auto context = message->getPrivate()->getContext();
-	for (const auto &chatMessage : context.deliveredMessages) {
-		chatMessage->getPrivate()->disableDeliveryNotificationRequiredInDatabase();
+	for (const auto &chatMessage : context.deliveredMessages)
 		deliveredMessages.remove(chatMessage);
-	}
 
-	for (const auto &chatMessage : context.displayedMessages) {
-		chatMessage->getPrivate()->disableDisplayNotificationRequiredInDatabase();
+	for (const auto &chatMessage : context.displayedMessages)
 		displayedMessages.remove(chatMessage);
+
+	ImdnScheduler *scheduler = chatRoom->getCore()->getImdnScheduler();
+	if (scheduler) {
+		scheduler->persistDelivered(context.deliveredMessages, context.displayedMessages);
+	} else {
+		for (const auto &chatMessage : context.deliveredMessages)
+			chatMessage->getPrivate()->disableDeliveryNotificationRequiredInDatabase();
+		for (const auto &chatMessage : context.displayedMessages)
+			chatMessage->getPrivate()->disableDisplayNotificationRequiredInDatabase();
 	}
 
 	for (const auto &chatMessage : context.nonDeliveredMessages)
@@ -126,7 +136,7 @@ void Imdn::onRegistrationStateChanged(LinphoneProxyConfig *cfg, LinphoneRegistra
 	if (state == LinphoneRegistrationOk && cfg == getRelatedProxyConfig()){
 		// When we are registered to the proxy, then send pending notification if any.
 		sentImdnMessages.clear();
-		send();
+		scheduleSend();
 	}
 }
 
@@ -134,7 +144,7 @@ void Imdn::onNetworkReachable (bool sipNetworkReachable, bool mediaNetworkReacha
 	if (sipNetworkReachable && getRelatedProxyConfig() == nullptr) {
 		// When the SIP network gets up and this chatroom isn't related to any proxy configuration, retry notification
 		sentImdnMessages.clear();
-		send();
+		scheduleSend();
 	}
 }
 
@@ -278,7 +288,7 @@ bool Imdn::isError (const shared_ptr<ChatMessage> &chatMessage) {
 int Imdn::timerExpired (void *data, unsigned int revents) {
 	Imdn *d = static_cast<Imdn *>(data);
 	d->stopTimer();
-	d->send();
+	d->scheduleSend();
 	return BELLE_SIP_STOP;
 }
 
@@ -299,6 +309,19 @@ LinphoneProxyConfig * Imdn::getRelatedProxyConfig(){
 	return cfg;
 }
 
+void Imdn::scheduleSend () {
+	ImdnScheduler *scheduler = nullptr;
+	try {
+		scheduler = chatRoom->getCore()->getImdnScheduler();
+	} catch (const bad_weak_ptr &) {
+		return; // Cannot send imdn if core is destroyed.
+	}
+	if (scheduler)
+		scheduler->schedule(this);
+	else
+		send();
+}
+
 void Imdn::send () {
 	try {
 		if (!chatRoom->getCore()->getCCore()->send_imdn_if_unregistered) {
@@ -364,7 +387,7 @@ void Imdn::send () {
 void Imdn::startTimer () {
 	if (!aggregationEnabled()) {
 		// Compatibility mode for basic chat rooms, do not aggregate notifications
-		send();
+		scheduleSend();
 		return;
 	}
 
@@ -36,6 +36,8 @@ class ChatRoom;
 class ImdnMessage;
 
 class Imdn : public CoreListener {
+	friend class ImdnScheduler;
+
 public:
 	enum class Type {
 		Delivery,
@@ -79,6 +81,8 @@ private:
 	LinphoneProxyConfig *getRelatedProxyConfig();
 	static int timerExpired (void *data, unsigned int revents);
 
+	// Sends through the ImdnScheduler of the core, which paces the IMDNs of all the chat rooms.
+	void scheduleSend ();
 	void send ();
 	void startTimer ();
 	void stopTimer ();
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <sstream>
+
+#include <libxml/xmlreader.h>
+
+#include "logger/logger.h"
+
+#include "conference-info-reader.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+namespace {
+	constexpr char ConferenceInfoNamespace[] = "urn:ietf:params:xml:ns:conference-info";
+	constexpr char LinphoneExtensionNamespace[] = "linphone:xml:ns:conference-info-linphone-extension";
+
+	// Elements of the linphone extension are prefixed in the path to not mix them with the conference-info ones.
+	constexpr char LinphoneExtensionPrefix[] = "linphone:";
+
+	class Reader {
+	public:
+		Reader (const string &xmlBody, const ConferenceInfoReader::Callbacks &callbacks) : callbacks(callbacks) {
+			reader = xmlReaderForMemory(xmlBody.c_str(), (int)xmlBody.size(), nullptr, "UTF-8", XML_PARSE_NONET);
+			if (reader)
+				xmlTextReaderSetErrorHandler(reader, onError, nullptr);
+		}
+
+		~Reader () {
+			if (reader)
+				xmlFreeTextReader(reader);
+		}
+
+		bool read ();
+
+	private:
+		static void onError (void *, const char *message, xmlParserSeverities, xmlTextReaderLocatorPtr) {
+			lError() << "Error while reading conference-info document: " << trim(message);
+		}
+
+		bool startElement ();
+		bool endElement ();
+
+		bool isPath (initializer_list<const char *> elements) const;
+		bool getAttribute (const char *name, string &value) const;
+		bool getStateAttribute (ConferenceInfoReader::State &state) const;
+		static string trim (const string &value);
+
+		xmlTextReaderPtr reader = nullptr;
+		const ConferenceInfoReader::Callbacks &callbacks;
+		bool stopped = false;
+
+		vector<string> path; // Names of the elements from the root to the current one.
+		string text; // Text of the current element.
+
+		ConferenceInfoReader::Description description;
+		ConferenceInfoReader::User user;
+	};
+
+	bool Reader::read () {
+		if (!reader)
+			return false;
+
+		int result = 0;
+		while (!stopped && (result = xmlTextReaderRead(reader)) == 1) {
+			switch (xmlTextReaderNodeType(reader)) {
+				case XML_READER_TYPE_ELEMENT: {
+					bool isEmpty = xmlTextReaderIsEmptyElement(reader) == 1;
+					if (!startElement() || (isEmpty && !stopped && !endElement()))
+						return false;
+					break;
+				}
+				case XML_READER_TYPE_END_ELEMENT:
+					if (!endElement())
+						return false;
+					break;
+				case XML_READER_TYPE_TEXT:
+				case XML_READER_TYPE_CDATA:
+				case XML_READER_TYPE_WHITESPACE:
+				case XML_READER_TYPE_SIGNIFICANT_WHITESPACE: {
+					const xmlChar *value = xmlTextReaderConstValue(reader);
+					if (value)
+						text += reinterpret_cast<const char *>(value);
+					break;
+				}
+				default:
+					break;
+			}
+		}
+		return stopped || result == 0;
+	}
+
+	bool Reader::startElement () {
+		const char *localName = reinterpret_cast<const char *>(xmlTextReaderConstLocalName(reader));
+		const char *ns = reinterpret_cast<const char *>(xmlTextReaderConstNamespaceUri(reader));
+		if (ns && strcmp(ns, ConferenceInfoNamespace) == 0)
+			path.emplace_back(localName);
+		else if (ns && strcmp(ns, LinphoneExtensionNamespace) == 0)
+			path.emplace_back(string(LinphoneExtensionPrefix) + localName);
+		else
+			path.emplace_back(); // Unknown element, it is skipped with its children.
+		text.clear();
+
+		if (path.size() == 1) {
+			if (path[0] != "conference-info") {
+				lError() << "Unexpected root element in conference-info document: " << localName;
+				return false;
+			}
+
+			string entity;
+			ConferenceInfoReader::State state;
+			if (!getAttribute("entity", entity) || !getStateAttribute(state))
+				return false;
+
+			string value;
+			bool hasVersion = getAttribute("version", value);
+			unsigned int version = hasVersion ? (unsigned int)strtoul(value.c_str(), nullptr, 10) : 0;
+			if (callbacks.onConferenceInfo && !callbacks.onConferenceInfo(entity, hasVersion, version, state))
+				stopped = true;
+		} else if (isPath({ "conference-description" })) {
+			description = ConferenceInfoReader::Description();
+		} else if (isPath({ "conference-description", "available-media", "entry" })) {
+			description.availableMedia.emplace_back();
+		} else if (isPath({ "conference-description", "linphone:ephemeral" })) {
+			description.hasEphemeral = true;
+		} else if (isPath({ "users" })) {
+			if (callbacks.onUsers)
+				callbacks.onUsers();
+		} else if (isPath({ "users", "user" })) {
+			user = ConferenceInfoReader::User();
+			getAttribute("entity", user.entity);
+			return getStateAttribute(user.state);
+		} else if (isPath({ "users", "user", "roles" })) {
+			user.hasRoles = true;
+		} else if (isPath({ "users", "user", "endpoint" })) {
+			user.endpoints.emplace_back();
+			ConferenceInfoReader::Endpoint &endpoint = user.endpoints.back();
+			endpoint.hasEntity = getAttribute("entity", endpoint.entity);
+			return getStateAttribute(endpoint.state);
+		} else if (isPath({ "users", "user", "endpoint", "media" })) {
+			user.endpoints.back().media.emplace_back();
+		}
+		return true;
+	}
+
+	bool Reader::endElement () {
+		if (path.empty())
+			return false;
+
+		if (isPath({ "conference-description" })) {
+			if (callbacks.onDescription)
+				callbacks.onDescription(description);
+		} else if (isPath({ "conference-description", "free-text" })) {
+			description.hasFreeText = true;
+			description.freeText = text;
+		} else if (isPath({ "conference-description", "subject" })) {
+			description.subject = text;
+		} else if (isPath({ "conference-description", "keywords" })) {
+			istringstream keywords(text);
+			string keyword;
+			while (keywords >> keyword)
+				description.keywords.push_back(keyword);
+		} else if (isPath({ "conference-description", "available-media", "entry", "type" })) {
+			description.availableMedia.back().type = text;
+		} else if (isPath({ "conference-description", "available-media", "entry", "status" })) {
+			description.availableMedia.back().status = trim(text);
+		} else if (isPath({ "conference-description", "linphone:ephemeral", "linphone:mode" })) {
+			description.ephemeralMode = text;
+		} else if (isPath({ "conference-description", "linphone:ephemeral", "linphone:lifetime" })) {
+			description.ephemeralLifetime = text;
+		} else if (isPath({ "users", "user" })) {
+			if (callbacks.onUser)
+				callbacks.onUser(user);
+		} else if (isPath({ "users", "user", "roles", "entry" })) {
+			user.roles.push_back(text);
+		} else if (isPath({ "users", "user", "endpoint", "display-text" })) {
+			user.endpoints.back().displayText = text;
+		} else if (isPath({ "users", "user", "endpoint", "media", "type" })) {
+			user.endpoints.back().media.back().type = text;
+		} else if (isPath({ "users", "user", "endpoint", "media", "src-id" })) {
+			user.endpoints.back().media.back().srcId = trim(text);
+		} else if (isPath({ "users", "user", "endpoint", "media", "status" })) {
+			user.endpoints.back().media.back().status = trim(text);
+		}
+
+		path.pop_back();
+		text.clear();
+		return true;
+	}
+
+	// The path is given without the root element.
+	bool Reader::isPath (initializer_list<const char *> elements) const {
+		if (path.size() != elements.size() + 1)
+			return false;
+
+		auto it = path.cbegin() + 1;
+		for (const char *element : elements) {
+			if (*it != element)
+				return false;
+			++it;
+		}
+		return true;
+	}
+
+	bool Reader::getAttribute (const char *name, string &value) const {
+		xmlChar *attribute = xmlTextReaderGetAttribute(reader, reinterpret_cast<const xmlChar *>(name));
+		if (!attribute)
+			return false;
+		value = reinterpret_cast<const char *>(attribute);
+		xmlFree(attribute);
+		return true;
+	}
+
+	bool Reader::getStateAttribute (ConferenceInfoReader::State &state) const {
+		string value;
+		if (!getAttribute("state", value) || (value = trim(value)) == "full")
+			state = ConferenceInfoReader::State::Full;
+		else if (value == "partial")
+			state = ConferenceInfoReader::State::Partial;
+		else if (value == "deleted")
+			state = ConferenceInfoReader::State::Deleted;
+		else {
+			lError() << "Invalid state in conference-info document: " << value;
+			return false;
+		}
+		return true;
+	}
+
+	string Reader::trim (const string &value) {
+		static const char *whitespaces = " \t\r\n";
+		size_t begin = value.find_first_not_of(whitespaces);
+		if (begin == string::npos)
+			return string();
+		return value.substr(begin, value.find_last_not_of(whitespaces) - begin + 1);
+	}
+}
+
+// -----------------------------------------------------------------------------
+
+bool ConferenceInfoReader::read (const string &xmlBody, const Callbacks &callbacks) {
+	return Reader(xmlBody, callbacks).read();
+}
+
+LINPHONE_END_NAMESPACE
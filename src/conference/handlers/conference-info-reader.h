@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_CONFERENCE_INFO_READER_H_
+#define _L_CONFERENCE_INFO_READER_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+/*
+ * Streaming reader of conference-info documents (RFC 4575) with the linphone extension.
+ * Unlike parseConferenceInfo(), no tree of the whole document is built: the conference
+ * description and each user are handed to the callbacks as soon as they are read, so the
+ * memory used does not depend on the number of users of full-state documents.
+ * Only the elements used by RemoteConferenceEventHandler are read.
+ */
+class ConferenceInfoReader {
+public:
+	enum class State {
+		Full,
+		Partial,
+		Deleted
+	};
+
+	struct Media {
+		std::string type;
+		std::string status; // Empty if not present.
+		std::string srcId; // Empty if not present.
+	};
+
+	struct Description {
+		bool hasFreeText = false;
+		std::string freeText;
+		std::string subject;
+		std::vector<std::string> keywords;
+		std::vector<Media> availableMedia;
+		bool hasEphemeral = false;
+		std::string ephemeralMode;
+		std::string ephemeralLifetime;
+	};
+
+	struct Endpoint {
+		bool hasEntity = false;
+		std::string entity;
+		State state = State::Full;
+		std::string displayText;
+		std::vector<Media> media;
+	};
+
+	struct User {
+		std::string entity;
+		State state = State::Full;
+		bool hasRoles = false;
+		std::vector<std::string> roles;
+		std::vector<Endpoint> endpoints;
+	};
+
+	struct Callbacks {
+		// Called first with the attributes of the document. Return false to stop reading.
+		std::function<bool (const std::string &entity, bool hasVersion, unsigned int version, State state)> onConferenceInfo;
+		std::function<void (const Description &description)> onDescription;
+		// Called once the users element is reached, even if it has no user.
+		std::function<void ()> onUsers;
+		std::function<void (const User &user)> onUser;
+	};
+
+	// Returns false if the document is malformed. The callbacks already called are not undone.
+	static bool read (const std::string &xmlBody, const Callbacks &callbacks);
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_CONFERENCE_INFO_READER_H_
@@ -17,6 +17,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <ctime>
 
 #include "linphone/api/c-content.h"
@@ -53,6 +54,21 @@ using namespace Xsd::ConferenceInfoLinphoneExtension;
 // =============================================================================
 
 LocalConferenceEventHandler::LocalConferenceEventHandler (Conference *conference, ConferenceListener *listener): conf(conference), confListener(listener) {
+	if (conf) {
+		int cacheSize = linphone_config_get_int(linphone_core_get_config(conf->getCore()->getCCore()), "misc", "conference_notify_cache_size", 64);
+		notifyCacheSize = cacheSize > 0 ? static_cast<size_t>(cacheSize) : 0;
+		int aggregationWindow = linphone_config_get_int(linphone_core_get_config(conf->getCore()->getCCore()), "misc", "conference_notify_aggregation_window", 0);
+		notifyAggregationWindow = aggregationWindow > 0 ? static_cast<unsigned int>(aggregationWindow) : 0;
+	}
+}
+
+LocalConferenceEventHandler::~LocalConferenceEventHandler () {
+	// The pending changes are dropped, the core may already be gone. The subscribers will catch up when subscribing again.
+	if (pendingNotifiesTimer) {
+		belle_sip_source_cancel(pendingNotifiesTimer);
+		belle_sip_object_unref(pendingNotifiesTimer);
+		pendingNotifiesTimer = nullptr;
+	}
 }
 
 // -----------------------------------------------------------------------------
@@ -62,15 +78,103 @@ void LocalConferenceEventHandler::notifyFullState (const string &notify, const s
 }
 
 void LocalConferenceEventHandler::notifyAllExcept (const string &notify, const shared_ptr<Participant> &exceptParticipant) {
+	SalBodyHandler *bodyHandler = nullptr;
+	unsigned int notifiesCount = notifyStats.notifies;
 	for (const auto &participant : conf->getParticipants()) {
 		if (participant != exceptParticipant)
-			notifyParticipant(notify, participant);
+			notifyParticipant(notify, participant, bodyHandler);
 	}
+	releaseNotifyBodyHandler(bodyHandler, notifyStats.notifies - notifiesCount);
 }
 
 void LocalConferenceEventHandler::notifyAll (const string &notify) {
+	SalBodyHandler *bodyHandler = nullptr;
+	unsigned int notifiesCount = notifyStats.notifies;
 	for (const auto &participant : conf->getParticipants())
-		notifyParticipant(notify, participant);
+		notifyParticipant(notify, participant, bodyHandler);
+	releaseNotifyBodyHandler(bodyHandler, notifyStats.notifies - notifiesCount);
+}
+
+void LocalConferenceEventHandler::scheduleNotify (const string &notify, const shared_ptr<Participant> &exceptParticipant) {
+	if (notifyAggregationWindow == 0) {
+		if (exceptParticipant)
+			notifyAllExcept(notify, exceptParticipant);
+		else
+			notifyAll(notify);
+		return;
+	}
+
+	pendingNotifies.push_back({ notify, exceptParticipant });
+	if (!pendingNotifiesTimer) {
+		pendingNotifiesTimer = conf->getCore()->createTimer([this] () -> bool {
+			flushPendingNotifies();
+			return false;
+		}, notifyAggregationWindow, "Conference NOTIFY aggregation");
+	}
+}
+
+void LocalConferenceEventHandler::flushPendingNotifies () {
+	if (pendingNotifiesTimer) {
+		conf->getCore()->destroyTimer(pendingNotifiesTimer);
+		pendingNotifiesTimer = nullptr;
+	}
+	if (pendingNotifies.empty())
+		return;
+
+	list<PendingNotify> notifies;
+	notifies.swap(pendingNotifies);
+	if (notifies.size() == 1) {
+		const PendingNotify &pendingNotify = notifies.front();
+		if (pendingNotify.exceptParticipant)
+			notifyAllExcept(pendingNotify.body, pendingNotify.exceptParticipant);
+		else
+			notifyAll(pendingNotify.body);
+		return;
+	}
+
+	// Each change keeps its own conference-info document and version so that the notify ids received by the
+	// subscribers stay the same as without aggregation.
+	auto mergeNotifies = [&notifies] (const shared_ptr<Participant> &participant) {
+		list<Content> contents;
+		for (const auto &pendingNotify : notifies) {
+			if (participant && (pendingNotify.exceptParticipant == participant))
+				continue;
+			contents.emplace_back(Content());
+			contents.back().setContentType(ContentType::ConferenceInfo);
+			contents.back().setBodyFromUtf8(pendingNotify.body);
+		}
+		if (contents.size() <= 1)
+			return contents.empty() ? string() : contents.front().getBodyAsUtf8String();
+
+		list<Content *> contentPtrs;
+		for (auto &content : contents)
+			contentPtrs.push_back(&content);
+		return ContentManager::contentListToMultipart(contentPtrs).getBodyAsUtf8String();
+	};
+
+	notifyStats.aggregatedChanges += static_cast<unsigned int>(notifies.size());
+	lInfo() << "Sending " << notifies.size() << " changes of conference [" << conf->getConferenceAddress() << "] in a single NOTIFY";
+
+	// The participants excluded from some of the changes get their own document, all the others share the same one.
+	string notify = mergeNotifies(nullptr);
+	SalBodyHandler *bodyHandler = nullptr;
+	unsigned int sharedNotifiesCount = 0;
+	for (const auto &participant : conf->getParticipants()) {
+		bool excluded = any_of(notifies.cbegin(), notifies.cend(), [&participant] (const PendingNotify &pendingNotify) {
+			return pendingNotify.exceptParticipant == participant;
+		});
+		unsigned int notifiesCount = notifyStats.notifies;
+		if (!excluded) {
+			notifyParticipant(notify, participant, bodyHandler);
+			sharedNotifiesCount += notifyStats.notifies - notifiesCount;
+			continue;
+		}
+
+		SalBodyHandler *participantBodyHandler = nullptr;
+		notifyParticipant(mergeNotifies(participant), participant, participantBodyHandler);
+		releaseNotifyBodyHandler(participantBodyHandler, notifyStats.notifies - notifiesCount);
+	}
+	releaseNotifyBodyHandler(bodyHandler, sharedNotifiesCount);
 }
 
 string LocalConferenceEventHandler::createNotifyFullState (LinphoneEvent * lev) {
@@ -344,6 +448,73 @@ string LocalConferenceEventHandler::createNotifyMultipart (int notifyId) {
 	return multipart;
 }
 
+string LocalConferenceEventHandler::createNotifyMissed (int notifyId, LinphoneEvent *lev) {
+	string multipart;
+	if (createNotifyMultipartFromCache(notifyId, multipart))
+		return multipart;
+
+	if (notifyCacheOverrun) {
+		lInfo() << "NOTIFY cache of conference [" << conf->getConferenceAddress() << "] does not go back to notify id " << notifyId
+			<< ", sending full state instead";
+		return createNotifyFullState(lev);
+	}
+	return createNotifyMultipart(notifyId);
+}
+
+void LocalConferenceEventHandler::cacheNotify (unsigned int notifyId, const string &notify) {
+	if (notifyCacheSize == 0 || notify.empty())
+		return;
+
+	if (!notifyCache.empty() && notifyId < notifyCache.back().notifyId) {
+		// The notify ids have been reset, previous bodies are no longer valid.
+		notifyCache.clear();
+		notifyCacheOverrun = false;
+	}
+	if (notifyCache.empty() && !notifyCacheOverrun)
+		notifyCacheFirstId = notifyId;
+
+	notifyCache.push_back({ notifyId, notify });
+	if (notifyCache.size() > notifyCacheSize) {
+		notifyCacheFirstId = notifyCache.front().notifyId + 1;
+		notifyCache.pop_front();
+		notifyCacheOverrun = true;
+	}
+	lastCatchUpNotifyId = -1;
+	lastCatchUp.clear();
+}
+
+bool LocalConferenceEventHandler::createNotifyMultipartFromCache (int notifyId, string &multipart) {
+	if (notifyCache.empty() || notifyId < 0 || static_cast<unsigned int>(notifyId) + 1 < notifyCacheFirstId)
+		return false;
+
+	if (notifyId == lastCatchUpNotifyId && conf->getLastNotify() == lastCatchUpLastNotify) {
+		multipart = lastCatchUp;
+		return true;
+	}
+
+	list<Content> contents;
+	for (const auto &cachedNotify : notifyCache) {
+		if (cachedNotify.notifyId <= static_cast<unsigned int>(notifyId))
+			continue;
+		contents.emplace_back(Content());
+		contents.back().setContentType(ContentType::ConferenceInfo);
+		contents.back().setBodyFromUtf8(cachedNotify.body);
+	}
+
+	if (!contents.empty()) {
+		list<Content *> contentPtrs;
+		for (auto &content : contents)
+			contentPtrs.push_back(&content);
+		multipart = ContentManager::contentListToMultipart(contentPtrs).getBodyAsUtf8String();
+	} else
+		multipart.clear();
+
+	lastCatchUpNotifyId = notifyId;
+	lastCatchUpLastNotify = conf->getLastNotify();
+	lastCatchUp = multipart;
+	return true;
+}
+
 string LocalConferenceEventHandler::createNotifyParticipantAdded (const Address & pAddress) {
 	string entity = conf->getConferenceAddress().asString();
 	ConferenceType confInfo = ConferenceType(entity);
@@ -707,14 +878,18 @@ string LocalConferenceEventHandler::createNotifyAvailableMediaChanged (const std
 }
 
 
-void LocalConferenceEventHandler::notifyParticipant (const string &notify, const shared_ptr<Participant> &participant) {
+void LocalConferenceEventHandler::notifyParticipant (const string &notify, const shared_ptr<Participant> &participant, SalBodyHandler *&bodyHandler) {
 	for (const auto &device : participant->getDevices()){
 		/* Only notify to device that are present in the conference. */
 		switch(device->getState()){
 			case ParticipantDevice::State::Present:
 			case ParticipantDevice::State::Joining:
 			case ParticipantDevice::State::ScheduledForJoining:
-				notifyParticipantDevice(notify, device, (notify.find(MultipartBoundary) != std::string::npos));
+				if (!device->isSubscribedToConferenceEventPackage() || notify.empty())
+					break;
+				if (!bodyHandler)
+					bodyHandler = createNotifyBodyHandler(notify, (notify.find(MultipartBoundary) != std::string::npos));
+				notifyParticipantDevice(bodyHandler, device);
 				break;
 			case ParticipantDevice::State::Leaving:
 			case ParticipantDevice::State::Left:
@@ -728,11 +903,22 @@ void LocalConferenceEventHandler::notifyParticipantDevice (const string &notify,
 	if (!device->isSubscribedToConferenceEventPackage() || notify.empty())
 		return;
 
+	SalBodyHandler *bodyHandler = createNotifyBodyHandler(notify, multipart);
+	notifyParticipantDevice(bodyHandler, device);
+	releaseNotifyBodyHandler(bodyHandler, 1);
+}
+
+void LocalConferenceEventHandler::notifyParticipantDevice (SalBodyHandler *bodyHandler, const shared_ptr<ParticipantDevice> &device) {
 	LinphoneEvent *ev = device->getConferenceSubscribeEvent();
 	LinphoneEventCbs *cbs = linphone_event_get_callbacks(ev);
 	linphone_event_cbs_set_user_data(cbs, this);
 	linphone_event_cbs_set_notify_response(cbs, notifyResponseCb);
 
+	if (_linphone_event_notify_with_body_handler(ev, bodyHandler) == 0)
+		notifyStats.notifies++;
+}
+
+SalBodyHandler *LocalConferenceEventHandler::createNotifyBodyHandler (const string &notify, bool multipart) {
 	Content content;
 	content.setBodyFromUtf8(notify);
 	ContentType contentType;
@@ -743,15 +929,45 @@ void LocalConferenceEventHandler::notifyParticipantDevice (const string &notify,
 		contentType = ContentType(ContentType::ConferenceInfo);
 
 	content.setContentType(contentType);
-	if (linphone_core_content_encoding_supported(conf->getCore()->getCCore(), "deflate"))
+	bool deflate = !!linphone_core_content_encoding_supported(conf->getCore()->getCCore(), "deflate");
+	if (deflate)
 		content.setContentEncoding("deflate");
 	LinphoneContent *cContent = L_GET_C_BACK_PTR(&content);
-	linphone_event_notify(ev, cContent);
+	SalBodyHandler *bodyHandler = sal_body_handler_ref(sal_body_handler_from_content(cContent, false));
+
+	notifyStats.bodies++;
+	notifyStats.bodiesSize += notify.size();
+	notifyStats.lastEncodingCpuTimeUs = 0;
+	if (deflate) {
+		// Compress the body now, once, instead of letting belle-sip do it for each NOTIFY.
+		clock_t start = clock();
+		if (sal_body_handler_apply_encoding(bodyHandler) != 0)
+			lWarning() << "Unable to compress NOTIFY body of conference [" << conf->getConferenceAddress() << "]";
+		notifyStats.lastEncodingCpuTimeUs = uint64_t(clock() - start) * 1000000 / CLOCKS_PER_SEC;
+		notifyStats.encodingCpuTimeUs += notifyStats.lastEncodingCpuTimeUs;
+	}
+	notifyStats.encodedBodiesSize += sal_body_handler_get_size(bodyHandler);
+	return bodyHandler;
+}
+
+void LocalConferenceEventHandler::releaseNotifyBodyHandler (SalBodyHandler *bodyHandler, unsigned int notifiesCount) {
+	if (!bodyHandler)
+		return;
+
+	lDebug() << "NOTIFY body of conference [" << conf->getConferenceAddress() << "] compressed in " << notifyStats.lastEncodingCpuTimeUs
+		<< "us and sent to " << notifiesCount << " devices (total: "
+		<< notifyStats.bodies << " bodies, " << notifyStats.notifies << " NOTIFYs, " << notifyStats.bodiesSize << " bytes compressed to "
+		<< notifyStats.encodedBodiesSize << " in " << notifyStats.encodingCpuTimeUs << "us of CPU)";
+	sal_body_handler_unref(bodyHandler);
 }
 
 // -----------------------------------------------------------------------------
 
 void LocalConferenceEventHandler::subscribeReceived (LinphoneEvent *lev) {
+	// The NOTIFYs sent below carry the last notify id, the changes still waiting for the aggregation
+	// window must reach the other devices first or they would be dropped as older ones.
+	flushPendingNotifies();
+
 	const LinphoneAddress *lAddr = linphone_event_get_from(lev);
 	char *addrStr = linphone_address_as_string(lAddr);
 	Address participantAddress(addrStr);
@@ -791,7 +1007,8 @@ void LocalConferenceEventHandler::subscribeReceived (LinphoneEvent *lev) {
 		} else if (evLastNotify < lastNotify) {
 			lInfo() << "Sending all missed notify [" << evLastNotify << "-" << lastNotify <<
 				"] for conference [" << conf->getConferenceAddress() << "] to: " << participant->getAddress();
-			notifyParticipantDevice(createNotifyMultipart(static_cast<int>(evLastNotify)), device, true);
+			string notify = createNotifyMissed(static_cast<int>(evLastNotify), lev);
+			notifyParticipantDevice(notify, device, (notify.find(MultipartBoundary) != std::string::npos));
 		} else if (evLastNotify > lastNotify) {
 			lError() << "Last notify received by client [" << evLastNotify << "] for conference [" <<
 				conf->getConferenceAddress() <<
@@ -827,7 +1044,7 @@ string LocalConferenceEventHandler::getNotifyForId (int notifyId, LinphoneEvent
 	if (notifyId == 0)
 		return createNotifyFullState(lev);
 	else if (notifyId < static_cast<int>(lastNotify))
-		return createNotifyMultipart(notifyId);
+		return createNotifyMissed(notifyId, lev);
 
 	return Utils::getEmptyConstRefObject<string>();
 }
@@ -838,7 +1055,9 @@ void LocalConferenceEventHandler::onFullStateReceived () {
 void LocalConferenceEventHandler::onParticipantAdded (const std::shared_ptr<ConferenceParticipantEvent> &event, const std::shared_ptr<Participant> &participant) {
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
-		notifyAllExcept(createNotifyParticipantAdded(participant->getAddress().asAddress()), participant);
+		string notify = createNotifyParticipantAdded(participant->getAddress().asAddress());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify, participant);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of participant " << participant->getAddress() << " being added because pointer to conference is null";
 	}
@@ -847,7 +1066,9 @@ void LocalConferenceEventHandler::onParticipantAdded (const std::shared_ptr<Conf
 void LocalConferenceEventHandler::onParticipantRemoved (const std::shared_ptr<ConferenceParticipantEvent> &event, const std::shared_ptr<Participant> &participant) {
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
-		notifyAllExcept(createNotifyParticipantRemoved(participant->getAddress().asAddress()), participant);
+		string notify = createNotifyParticipantRemoved(participant->getAddress().asAddress());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify, participant);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of participant " << participant->getAddress() << " being removed because pointer to conference is null";
 	}
@@ -857,7 +1078,9 @@ void LocalConferenceEventHandler::onParticipantSetAdmin (const std::shared_ptr<C
 	const bool isAdmin = (event->getType() == EventLog::Type::ConferenceParticipantSetAdmin);
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
-		notifyAll(createNotifyParticipantAdminStatusChanged(participant->getAddress().asAddress(), isAdmin));
+		string notify = createNotifyParticipantAdminStatusChanged(participant->getAddress().asAddress(), isAdmin);
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of participant " << participant->getAddress() << " admin status changed because pointer to conference is null";
 	}
@@ -866,7 +1089,9 @@ void LocalConferenceEventHandler::onParticipantSetAdmin (const std::shared_ptr<C
 void LocalConferenceEventHandler::onSubjectChanged (const std::shared_ptr<ConferenceSubjectEvent> &event) {
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
-		notifyAll(createNotifySubjectChanged(event->getSubject()));
+		string notify = createNotifySubjectChanged(event->getSubject());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of conference subject change because pointer to conference is null";
 	}
@@ -875,7 +1100,9 @@ void LocalConferenceEventHandler::onSubjectChanged (const std::shared_ptr<Confer
 void LocalConferenceEventHandler::onAvailableMediaChanged (const std::shared_ptr<ConferenceAvailableMediaEvent> &event) {
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
-		notifyAll(createNotifyAvailableMediaChanged(event->getAvailableMediaType()));
+		string notify = createNotifyAvailableMediaChanged(event->getAvailableMediaType());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of conference subject change because pointer to conference is null";
 	}
@@ -885,7 +1112,9 @@ void LocalConferenceEventHandler::onParticipantDeviceAdded (const std::shared_pt
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
 		Participant *participant = device->getParticipant();
-		notifyAll(createNotifyParticipantDeviceAdded(participant->getAddress().asAddress(), device->getAddress().asAddress()));
+		string notify = createNotifyParticipantDeviceAdded(participant->getAddress().asAddress(), device->getAddress().asAddress());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of participant device " << device->getAddress() << " being added because pointer to conference is null";
 	}
@@ -895,7 +1124,9 @@ void LocalConferenceEventHandler::onParticipantDeviceRemoved (const std::shared_
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
 		Participant *participant = device->getParticipant();
-		notifyAll(createNotifyParticipantDeviceRemoved(participant->getAddress().asAddress(), device->getAddress().asAddress()));
+		string notify = createNotifyParticipantDeviceRemoved(participant->getAddress().asAddress(), device->getAddress().asAddress());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of participant device " << device->getAddress() << " being removed because pointer to conference is null";
 	}
@@ -905,7 +1136,9 @@ void LocalConferenceEventHandler::onParticipantDeviceMediaChanged (const std::sh
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
 		Participant *participant = device->getParticipant();
-		notifyAll(createNotifyParticipantDeviceMediaChanged(participant->getAddress().asAddress(), device->getAddress().asAddress()));
+		string notify = createNotifyParticipantDeviceMediaChanged(participant->getAddress().asAddress(), device->getAddress().asAddress());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of participant device " << device->getAddress() << " being added because pointer to conference is null";
 	}
@@ -914,7 +1147,9 @@ void LocalConferenceEventHandler::onParticipantDeviceMediaChanged (const std::sh
 void LocalConferenceEventHandler::onEphemeralModeChanged (const std::shared_ptr<ConferenceEphemeralMessageEvent> &event) {
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
-		notifyAll(createNotifyEphemeralMode(event->getType()));
+		string notify = createNotifyEphemeralMode(event->getType());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of ephemeral mode changed to " << event->getType();
 	}
@@ -923,13 +1158,18 @@ void LocalConferenceEventHandler::onEphemeralModeChanged (const std::shared_ptr<
 void LocalConferenceEventHandler::onEphemeralLifetimeChanged (const std::shared_ptr<ConferenceEphemeralMessageEvent> &event) {
 	// Do not send notify if conference pointer is null. It may mean that the confernece has been terminated
 	if (conf) {
-		notifyAll(createNotifyEphemeralLifetime(event->getEphemeralMessageLifetime()));
+		string notify = createNotifyEphemeralLifetime(event->getEphemeralMessageLifetime());
+		cacheNotify(event->getNotifyId(), notify);
+		scheduleNotify(notify);
 	} else {
 		lWarning() << __func__ << ": Not sending notification of ephemeral lifetime changed to " << event->getEphemeralMessageLifetime();
 	}
 }
 
 void LocalConferenceEventHandler::onStateChanged (LinphonePrivate::ConferenceInterface::State state) {
+	// Let the subscribers know about the last changes before the conference goes away.
+	if (state == ConferenceInterface::State::TerminationPending)
+		flushPendingNotifies();
 }
 
 shared_ptr<Participant> LocalConferenceEventHandler::getConferenceParticipant (const Address & address) const {
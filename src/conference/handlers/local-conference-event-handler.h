@@ -20,6 +20,9 @@
 #ifndef _L_LOCAL_CONFERENCE_EVENT_HANDLER_H_
 #define _L_LOCAL_CONFERENCE_EVENT_HANDLER_H_
 
+#include <cstdint>
+#include <deque>
+#include <list>
 #include <string>
 
 #include "linphone/types.h"
@@ -36,6 +39,9 @@
 
 // =============================================================================
 
+typedef struct SalBodyHandler SalBodyHandler;
+typedef struct belle_sip_source belle_sip_source_t;
+
 LINPHONE_BEGIN_NAMESPACE
 
 class ConferenceId;
@@ -51,20 +57,42 @@ friend class LocalConferenceListEventHandler;
 	friend class Tester;
 #endif
 public:
+	// Cost of the NOTIFY bodies built for the conference events, each body being shared by all the notified devices.
+	struct NotifyStats {
+		unsigned int bodies = 0;
+		unsigned int notifies = 0;
+		size_t bodiesSize = 0;
+		size_t encodedBodiesSize = 0;
+		uint64_t encodingCpuTimeUs = 0;
+		uint64_t lastEncodingCpuTimeUs = 0;
+		// Conference changes sent together with other ones because of the aggregation window.
+		unsigned int aggregatedChanges = 0;
+	};
+
 	static Xsd::ConferenceInfo::MediaStatusType mediaDirectionToMediaStatus (LinphoneMediaDirection direction);
 	LocalConferenceEventHandler (Conference *conference, ConferenceListener* listener = nullptr);
+	~LocalConferenceEventHandler ();
+
+	const NotifyStats &getNotifyStats () const {
+		return notifyStats;
+	}
 
 	void subscribeReceived (LinphoneEvent *lev);
 	void subscriptionStateChanged (LinphoneEvent *lev, LinphoneSubscriptionState state);
 
 	std::string getNotifyForId (int notifyId, LinphoneEvent *lev);
 
+	// Send right now the conference changes waiting for the end of the aggregation window.
+	void flushPendingNotifies ();
+
 //protected:
 	void notifyFullState (const std::string &notify, const std::shared_ptr<ParticipantDevice> &device);
 	void notifyAllExcept (const std::string &notify, const std::shared_ptr<Participant> &exceptParticipant);
 	void notifyAll (const std::string &notify);
 	std::string createNotifyFullState (LinphoneEvent * lev);
 	std::string createNotifyMultipart (int notifyId);
+	// Missed NOTIFYs since notifyId, taken from the cache if possible. A full state is returned if the cache has been overrun.
+	std::string createNotifyMissed (int notifyId, LinphoneEvent *lev);
 	std::string createNotifyParticipantAdded (const Address & pAddress);
 	std::string createNotifyParticipantAdminStatusChanged (const Address & pAddress, bool isAdmin);
 	std::string createNotifyParticipantRemoved (const Address & pAddress);
@@ -161,14 +189,50 @@ private:
 	std::string createNotifySubjectChanged (const std::string &subject);
 	std::string createNotifyEphemeralLifetime (const long & lifetime);
 	std::string createNotifyEphemeralMode (const EventLog::Type & type);
-	void notifyParticipant (const std::string &notify, const std::shared_ptr<Participant> &participant);
+	// The body handler is created by the first device to notify, then used for the next ones.
+	void notifyParticipant (const std::string &notify, const std::shared_ptr<Participant> &participant, SalBodyHandler *&bodyHandler);
 	void notifyParticipantDevice (const std::string &notify, const std::shared_ptr<ParticipantDevice> &device, bool multipart = false);
+	void notifyParticipantDevice (SalBodyHandler *bodyHandler, const std::shared_ptr<ParticipantDevice> &device);
+	SalBodyHandler *createNotifyBodyHandler (const std::string &notify, bool multipart);
+	void releaseNotifyBodyHandler (SalBodyHandler *bodyHandler, unsigned int notifiesCount);
+
+	// Notify a conference change to all the participants but exceptParticipant, at the end of the aggregation window if any.
+	void scheduleNotify (const std::string &notify, const std::shared_ptr<Participant> &exceptParticipant = nullptr);
+
+	void cacheNotify (unsigned int notifyId, const std::string &notify);
+	bool createNotifyMultipartFromCache (int notifyId, std::string &multipart);
 
 	std::shared_ptr<Participant> getConferenceParticipant (const Address & address) const;
 
 	void addMediaCapabilities(const std::shared_ptr<ParticipantDevice> & device, Xsd::ConferenceInfo::EndpointType & endpoint);
 	void addAvailableMediaCapabilities(const LinphoneMediaDirection audioDirection, const LinphoneMediaDirection videoDirection, const LinphoneMediaDirection textDirection, Xsd::ConferenceInfo::ConferenceDescriptionType & confDescr);
 
+	NotifyStats notifyStats;
+
+	// Serialized bodies of the last partial NOTIFYs, in notify id order.
+	struct CachedNotify {
+		unsigned int notifyId;
+		std::string body;
+	};
+	std::deque<CachedNotify> notifyCache;
+	size_t notifyCacheSize = 0;
+	// The cache holds every NOTIFY whose id is greater or equal.
+	unsigned int notifyCacheFirstId = 0;
+	bool notifyCacheOverrun = false;
+	// Last catch-up built from the cache, the devices reconnecting together usually miss the same NOTIFYs.
+	int lastCatchUpNotifyId = -1;
+	unsigned int lastCatchUpLastNotify = 0;
+	std::string lastCatchUp;
+
+	// Changes waiting for the end of the aggregation window, each one keeping its own notify id.
+	struct PendingNotify {
+		std::string body;
+		std::shared_ptr<Participant> exceptParticipant;
+	};
+	std::list<PendingNotify> pendingNotifies;
+	unsigned int notifyAggregationWindow = 0;
+	belle_sip_source_t *pendingNotifiesTimer = nullptr;
+
 	L_DISABLE_COPY(LocalConferenceEventHandler);
 };
 
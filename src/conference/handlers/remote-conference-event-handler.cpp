@@ -17,8 +17,6 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <sstream>
-
 #include "linphone/utils/algorithm.h"
 #include "linphone/utils/utils.h"
 
@@ -29,10 +27,9 @@
 #include "content/content.h"
 #include "core/core-p.h"
 #include "logger/logger.h"
+#include "conference-info-reader.h"
 #include "remote-conference-event-handler.h"
 
-#include <xsd/cxx/xml/string.hxx>
-
 // TODO: Remove me later.
 #include "private.h"
 
@@ -42,9 +39,6 @@ using namespace std;
 
 LINPHONE_BEGIN_NAMESPACE
 
-using namespace Xsd::ConferenceInfo;
-using namespace Xsd::ConferenceInfoLinphoneExtension;
-
 // -----------------------------------------------------------------------------
 
 RemoteConferenceEventHandler::RemoteConferenceEventHandler (Conference *remoteConference, ConferenceListener * listener) {
@@ -68,331 +62,333 @@ RemoteConferenceEventHandler::~RemoteConferenceEventHandler () {
 // -----------------------------------------------------------------------------
 
 void RemoteConferenceEventHandler::conferenceInfoNotifyReceived (const string &xmlBody) {
-	istringstream data(xmlBody);
-	unique_ptr<ConferenceType> confInfo;
-	try {
-		confInfo = parseConferenceInfo(data, Xsd::XmlSchema::Flags::dont_validate);
-	} catch (const exception &) {
+	// Full states are applied as they are read, so that memory does not grow with the number of users. They emit no
+	// event, hence the version is only recorded once the whole document is read. Partial notifies are small and emit
+	// events carrying the version: they are kept until the document is read, then applied as a whole.
+	bool accepted = false;
+	bool isFullState = false;
+	bool hasVersion = false;
+	unsigned int version = 0;
+	bool hasUsers = false;
+	bool participantsCleared = false;
+	bool stateApplied = false;
+	time_t creationTime = time(nullptr);
+	bool hasDescription = false;
+	ConferenceInfoReader::Description pendingDescription;
+	list<ConferenceInfoReader::User> pendingUsers;
+
+	ConferenceInfoReader::Callbacks callbacks;
+	callbacks.onConferenceInfo = [&](const string &entity, bool docHasVersion, unsigned int docVersion, ConferenceInfoReader::State state) {
+		IdentityAddress entityAddress(entity);
+		if (entityAddress != getConferenceId().getPeerAddress())
+			return false;
+
+		// 1. Check the notify version, it is only recorded once the document is read.
+		if (docHasVersion && getLastNotify() >= docVersion) {
+			lWarning() << "Ignoring conference notify for: " << getConferenceId() << ", notify version received is: "
+				<< docVersion << ", should be stricly more than last notify id of conference: " << getLastNotify();
+			return false;
+		}
+
+		hasVersion = docHasVersion;
+		version = docVersion;
+		accepted = true;
+		isFullState = (state == ConferenceInfoReader::State::Full);
+		return true;
+	};
+	callbacks.onDescription = [&](const ConferenceInfoReader::Description &description) {
+		if (!isFullState) {
+			hasDescription = true;
+			pendingDescription = description;
+			return;
+		}
+
+		// 2. Compute event time.
+		if (description.hasFreeText)
+			creationTime = static_cast<time_t>(Utils::stoll(description.freeText));
+
+		// 3. Notify ephemeral settings, media, subject and keywords.
+		conferenceDescriptionReceived(description, creationTime, isFullState);
+		stateApplied = true;
+	};
+	callbacks.onUsers = [&]() {
+		hasUsers = true;
+		if (isFullState) {
+			confListener->onParticipantsCleared();
+			participantsCleared = true;
+			stateApplied = true;
+		}
+	};
+	callbacks.onUser = [&](const ConferenceInfoReader::User &user) {
+		if (!isFullState) {
+			pendingUsers.push_back(user);
+			return;
+		}
+
+		// 4. Notify changes on users.
+		userReceived(user, creationTime, isFullState);
+	};
+
+	if (!ConferenceInfoReader::read(xmlBody, callbacks)) {
 		lError() << "Error while parsing conference-info notify for: " << getConferenceId();
+		if (stateApplied) {
+			// The full state is only partly applied: request a new one with the next subscribe.
+			lError() << "Conference " << getConferenceId() << " is left with a partial full state, resetting its last notify";
+			conf->resetLastNotify();
+		}
 		return;
 	}
-
-	IdentityAddress entityAddress(confInfo->getEntity().c_str());
-	if (entityAddress != getConferenceId().getPeerAddress())
+	if (!accepted)
 		return;
 
-	auto &confDescription = confInfo->getConferenceDescription();
+	if (hasVersion)
+		conf->setLastNotify(version);
 
-	// 1. Compute event time.
-	time_t creationTime = time(nullptr);
-	{
-		auto &freeText = confDescription->getFreeText();
-		if (freeText.present())
-			creationTime = static_cast<time_t>(Utils::stoll(freeText.get()));
+	if (hasDescription) {
+		if (pendingDescription.hasFreeText)
+			creationTime = static_cast<time_t>(Utils::stoll(pendingDescription.freeText));
+		conferenceDescriptionReceived(pendingDescription, creationTime, isFullState);
 	}
+	for (const auto &user : pendingUsers)
+		userReceived(user, creationTime, isFullState);
 
-	// 2. Update last notify.
-	{
-		auto &version = confInfo->getVersion();
-		if (version.present()) {
-			unsigned int notifyVersion = version.get();
-			if (getLastNotify() >= notifyVersion) {
-				lWarning() << "Ignoring conference notify for: " << getConferenceId() << ", notify version received is: "
-					<< notifyVersion << ", should be stricly more than last notify id of conference: " << getLastNotify();
-				return;
-			}
-			conf->setLastNotify(version.get());
+	if (isFullState && !participantsCleared)
+		confListener->onParticipantsCleared();
+
+	if (!hasUsers)
+		return;
+
+	if (isFullState) {
+		confListener->onFirstNotifyReceived(getConferenceId().getPeerAddress());
+		conf->notifyFullState();
+		if (conf->getState() == ConferenceInterface::State::CreationPending) {
+			// Move to Created state when the list of participants is received
+			conf->setState(ConferenceInterface::State::Created);
 		}
 	}
+}
 
-	bool isFullState = confInfo->getState() == StateType::full;
-
-	// 3. Notify ephemeral settings, media, subject and keywords.
-	if (confDescription.present()) {
-		auto &subject = confDescription.get().getSubject();
-		if (subject.present() && !subject.get().empty()) {
-
-			if (conf->getSubject() != subject.get()) {
-				conf->Conference::setSubject(subject.get());
-				if (!isFullState) {
-					conf->notifySubjectChanged(
-						creationTime,
-						isFullState,
-						subject.get()
-					);
-				}
-			}
+void RemoteConferenceEventHandler::conferenceDescriptionReceived (
+	const ConferenceInfoReader::Description &description,
+	time_t creationTime,
+	bool isFullState
+) {
+	if (!description.subject.empty() && conf->getSubject() != description.subject) {
+		conf->Conference::setSubject(description.subject);
+		if (!isFullState) {
+			conf->notifySubjectChanged(
+				creationTime,
+				isFullState,
+				description.subject
+			);
 		}
+	}
 
-		auto &keywords = confDescription.get().getKeywords();
-		if (keywords.present() && !keywords.get().empty()) {
-			KeywordsType xmlKeywords = keywords.get();
-			confListener->onConferenceKeywordsChanged(
-				vector<string>(xmlKeywords.begin(), xmlKeywords.end())
-			);
+	if (!description.keywords.empty())
+		confListener->onConferenceKeywordsChanged(description.keywords);
+
+	for (const auto &mediaEntry : description.availableMedia) {
+		const std::string &mediaType = mediaEntry.type;
+		const LinphoneMediaDirection mediaDirection = RemoteConferenceEventHandler::mediaStatusToMediaDirection(mediaEntry.status);
+		const bool enabled = (mediaDirection == LinphoneMediaDirectionSendRecv);
+		if (mediaType.compare("audio") == 0) {
+			conf->confParams->enableAudio(enabled);
+		} else if (mediaType.compare("video") == 0) {
+			conf->confParams->enableVideo(enabled);
+		} else if (mediaType.compare("text") == 0) {
+			conf->confParams->enableChat(enabled);
+		} else {
+			lError() << "Unrecognized media type " << mediaType;
 		}
+	}
 
+	if (description.hasEphemeral) {
+		const auto &ephemeralLifetime = description.ephemeralLifetime;
+		const auto &ephemeralMode = description.ephemeralMode;
 
-		const auto &availableMedia = confDescription.get().getAvailableMedia();
-		if (availableMedia.present()) {
-			for (auto &mediaEntry : availableMedia.get().getEntry()) {
-				const std::string mediaType = mediaEntry.getType();
-				const LinphoneMediaDirection mediaDirection = RemoteConferenceEventHandler::mediaStatusToMediaDirection(mediaEntry.getStatus().get());
-				const bool enabled = (mediaDirection == LinphoneMediaDirectionSendRecv);
-				if (mediaType.compare("audio") == 0) {
-					conf->confParams->enableAudio(enabled);
-				} else if (mediaType.compare("video") == 0) {
-					conf->confParams->enableVideo(enabled);
-				} else if (mediaType.compare("text") == 0) {
-					conf->confParams->enableChat(enabled);
-				} else {
-					lError() << "Unrecognized media type " << mediaType;
-				}
-			}
+		const auto & core = conf->getCore();
+		auto chatRoom = core->findChatRoom(getConferenceId());
+		std::shared_ptr<LinphonePrivate::ClientGroupChatRoom> cgcr = nullptr;
+		if (chatRoom && (chatRoom->getConference().get() == conf)) {
+			cgcr = dynamic_pointer_cast<LinphonePrivate::ClientGroupChatRoom>(chatRoom);
 		}
+		if (cgcr) {
+			if (ephemeralMode.empty() || (ephemeralMode.compare("admin-managed") == 0)) {
+				cgcr->getCurrentParams()->setEphemeralMode(AbstractChatRoom::EphemeralMode::AdminManaged);
+				if (!ephemeralLifetime.empty()) {
+					const auto lifetime = std::stol(ephemeralLifetime);
+					cgcr->getCurrentParams()->setEphemeralLifetime(lifetime);
+					cgcr->getPrivate()->enableEphemeral((lifetime != 0));
+					if (!isFullState) {
+						conf->notifyEphemeralLifetimeChanged(
+							creationTime,
+							isFullState,
+							lifetime
+						);
 
-		auto & anySequence (confDescription.get().getAny());
-
-		for (const auto &anyElement : anySequence) {
-			auto name = xsd::cxx::xml::transcode<char>(anyElement.getLocalName());
-			auto nodeName = xsd::cxx::xml::transcode<char>(anyElement.getNodeName());
-			auto nodeValue = xsd::cxx::xml::transcode<char>(anyElement.getNodeValue());
-			if (nodeName == "linphone-cie:ephemeral") {
-				Ephemeral ephemeral{anyElement};
-				auto ephemeralLifetime = ephemeral.getLifetime();
-				auto ephemeralMode = ephemeral.getMode();
-
-				const auto & core = conf->getCore();
-				auto chatRoom = core->findChatRoom(getConferenceId());
-				std::shared_ptr<LinphonePrivate::ClientGroupChatRoom> cgcr = nullptr;
-				if (chatRoom && (chatRoom->getConference().get() == conf)) {
-					cgcr = dynamic_pointer_cast<LinphonePrivate::ClientGroupChatRoom>(chatRoom);
-				}
-				if (cgcr) {
-					if (ephemeralMode.empty() || (ephemeralMode.compare("admin-managed") == 0)) {
-						cgcr->getCurrentParams()->setEphemeralMode(AbstractChatRoom::EphemeralMode::AdminManaged);
-						if (!ephemeralLifetime.empty()) {
-							const auto lifetime = std::stol(ephemeralLifetime);
-							cgcr->getCurrentParams()->setEphemeralLifetime(lifetime);
-							cgcr->getPrivate()->enableEphemeral((lifetime != 0));
-							if (!isFullState) {
-								conf->notifyEphemeralLifetimeChanged(
-									creationTime,
-									isFullState,
-									lifetime
-								);
-
-								conf->notifyEphemeralMessageEnabled(
-									creationTime,
-									isFullState,
-									(lifetime != 0)
-								);
-							}
-
-
-						}
-					} else if (ephemeralMode.compare("device-managed") == 0) {
-						cgcr->getCurrentParams()->setEphemeralMode(AbstractChatRoom::EphemeralMode::DeviceManaged);
+						conf->notifyEphemeralMessageEnabled(
+							creationTime,
+							isFullState,
+							(lifetime != 0)
+						);
 					}
 				}
+			} else if (ephemeralMode.compare("device-managed") == 0) {
+				cgcr->getCurrentParams()->setEphemeralMode(AbstractChatRoom::EphemeralMode::DeviceManaged);
 			}
 		}
-
 	}
+}
 
-	if (isFullState)
-		confListener->onParticipantsCleared();
-
-	auto &users = confInfo->getUsers();
-	if (!users.present()) return;
-
-	// 4. Notify changes on users.
-	for (auto &user : users->getUser()) {
-		Address address(conf->getCore()->interpretUrl(user.getEntity().get()));
-		StateType state = user.getState();
-
-		shared_ptr<Participant> participant = conf->findParticipant(address);
-
-		if (state == StateType::deleted) {
-			if (conf->isMe(address)) {
-				lInfo() << "Participant " << address.asString() << " requested to be deleted is me.";
-				continue;
-			} else if (participant) {
-				conf->participants.remove(participant);
-
-				if (!isFullState && participant) {
-					conf->notifyParticipantRemoved(
-						creationTime,
-						isFullState,
-						participant
-					);
-				}
-
-				continue;
-			} else {
-				lWarning() << "Participant " << address.asString() << " removed but not in the list of participants!";
+void RemoteConferenceEventHandler::userReceived (const ConferenceInfoReader::User &user, time_t creationTime, bool isFullState) {
+	Address address(conf->getCore()->interpretUrl(user.entity));
+	ConferenceInfoReader::State state = user.state;
+
+	shared_ptr<Participant> participant = conf->findParticipant(address);
+
+	if (state == ConferenceInfoReader::State::Deleted) {
+		if (conf->isMe(address)) {
+			lInfo() << "Participant " << address.asString() << " requested to be deleted is me.";
+			return;
+		} else if (participant) {
+			conf->participants.remove(participant);
+
+			if (!isFullState && participant) {
+				conf->notifyParticipantRemoved(
+					creationTime,
+					isFullState,
+					participant
+				);
 			}
-		} else if (state == StateType::full) {
-			if (conf->isMe(address)) {
-				lInfo() << "Participant " << address.asString() << " requested to be added is me.";
-			} else if (participant) {
-				lWarning() << "Participant " << *participant << " added but already in the list of participants!";
-			} else {
-				participant = Participant::create(conf,address);
-				conf->participants.push_back(participant);
-
-				if (!isFullState) {
-					conf->notifyParticipantAdded(
-						creationTime,
-						isFullState,
-						participant
-					);
-				}
+
+			return;
+		} else {
+			lWarning() << "Participant " << address.asString() << " removed but not in the list of participants!";
+		}
+	} else if (state == ConferenceInfoReader::State::Full) {
+		if (conf->isMe(address)) {
+			lInfo() << "Participant " << address.asString() << " requested to be added is me.";
+		} else if (participant) {
+			lWarning() << "Participant " << *participant << " added but already in the list of participants!";
+		} else {
+			participant = Participant::create(conf,address);
+			conf->participants.push_back(participant);
+
+			if (!isFullState) {
+				conf->notifyParticipantAdded(
+					creationTime,
+					isFullState,
+					participant
+				);
 			}
 		}
+	}
 
-		// Try to get participant again as it may have been added or removed earlier on
-		if (conf->isMe(address))
-			participant = conf->getMe();
-		else
-			participant = conf->findParticipant(address);
-
-		if (!participant) {
-			lWarning() << "Participant " << address.asString() << " is not in the list of participants however it is trying to change the list of devices or change role!";
-		} else {
+	// Try to get participant again as it may have been added or removed earlier on
+	if (conf->isMe(address))
+		participant = conf->getMe();
+	else
+		participant = conf->findParticipant(address);
 
-			auto &roles = user.getRoles();
-			if (roles) {
+	if (!participant) {
+		lWarning() << "Participant " << address.asString() << " is not in the list of participants however it is trying to change the list of devices or change role!";
+		return;
+	}
 
-				auto &entry = roles->getEntry();
-				bool isAdmin = (find(entry, "admin") != entry.end()
-						? true
-						: false);
+	if (user.hasRoles) {
+		bool isAdmin = (find(user.roles, "admin") != user.roles.end()
+				? true
+				: false);
 
-				if (participant->isAdmin() != isAdmin) {
+		if (participant->isAdmin() != isAdmin) {
 
-					participant->setAdmin(isAdmin);
+			participant->setAdmin(isAdmin);
 
-					if (!isFullState) {
-						conf->notifyParticipantSetAdmin(
-							creationTime,
-							isFullState,
-							participant,
-							isAdmin
-						);
-					}
-				}
+			if (!isFullState) {
+				conf->notifyParticipantSetAdmin(
+					creationTime,
+					isFullState,
+					participant,
+					isAdmin
+				);
 			}
+		}
+	}
 
-			for (const auto &endpoint : user.getEndpoint()) {
-				if (!endpoint.getEntity().present())
-					continue;
+	for (const auto &endpoint : user.endpoints) {
+		if (!endpoint.hasEntity)
+			continue;
 
-				Address gruu(endpoint.getEntity().get());
-				StateType state = endpoint.getState();
+		Address gruu(endpoint.entity);
+		ConferenceInfoReader::State state = endpoint.state;
 
-				shared_ptr<ParticipantDevice> device = nullptr;
-				if (state == StateType::deleted) {
+		shared_ptr<ParticipantDevice> device = nullptr;
+		if (state == ConferenceInfoReader::State::Deleted) {
 
-					// Take a pointer towards the device before deleting it in order to send the notification
-					device = participant->findDevice(gruu);
-					participant->removeDevice(gruu);
+			// Take a pointer towards the device before deleting it in order to send the notification
+			device = participant->findDevice(gruu);
+			participant->removeDevice(gruu);
 
-					if (!isFullState && device && participant) {
-						conf->notifyParticipantDeviceRemoved(
-							creationTime,
-							isFullState,
-							participant,
-							device
-						);
-					}
+			if (!isFullState && device && participant) {
+				conf->notifyParticipantDeviceRemoved(
+					creationTime,
+					isFullState,
+					participant,
+					device
+				);
+			}
 
-				} else if (state == StateType::full) {
+		} else if (state == ConferenceInfoReader::State::Full) {
 
-					device = participant->addDevice(gruu);
+			device = participant->addDevice(gruu);
 
-					const string &name = endpoint.getDisplayText().present() ? endpoint.getDisplayText().get() : "";
+			const string &name = endpoint.displayText;
 
-					if (!name.empty())
-						device->setName(name);
+			if (!name.empty())
+				device->setName(name);
 
-					if (!isFullState) {
-						conf->notifyParticipantDeviceAdded(
-							creationTime,
-							isFullState,
-							participant,
-							device
-						);
-					}
-				} else {
-					device = participant->findDevice(gruu);
-				}
+			if (!isFullState) {
+				conf->notifyParticipantDeviceAdded(
+					creationTime,
+					isFullState,
+					participant,
+					device
+				);
+			}
+		} else {
+			device = participant->findDevice(gruu);
+		}
 
-				if (state != StateType::deleted) {
-/*
-					auto & deviceAnySequence (endpoint.get().getAny());
-
-					for (auto anyElementIt = deviceAnySequence.begin(); anyElementIt != deviceAnySequence.end (); ++anyElementIt) {
-						const xercesc_3_1::DOMElement& anyElement (*anyElementIt);
-						string name (xsd::cxx::xml::transcode<char>(anyElement.getLocalName()));
-						string nodeName (xsd::cxx::xml::transcode<char>(anyElement.getNodeName()));
-						string nodeValue (xsd::cxx::xml::transcode<char>(anyElement.getNodeValue()));
-						if (nodeName.compare("linphone-cie:service-description") == 0) {
-							const auto service = ServiceDescription(anyElement);
-							const auto serviceId = service.getServiceId();
-							const auto serviceVersion = Utils::Version(service.getVersion());
-							if (serviceId.compare("ephemeral") == 0) {
-								device->enableAdminModeSupport((serviceVersion > Utils::Version(1,1)));
-							}
-						}
-					}
-*/
-
-					for (const auto &media : endpoint.getMedia()) {
-						const std::string mediaType = media.getType().get();
-						const LinphoneMediaDirection mediaDirection = RemoteConferenceEventHandler::mediaStatusToMediaDirection(media.getStatus().get());
-						if (mediaType.compare("audio") == 0) {
-							device->setAudioDirection(mediaDirection);
-
-							if (media.getSrcId()) {
-								const std::string srcId = media.getSrcId().get();
-								unsigned long ssrc = std::stoul(srcId);
-								device->setSsrc((uint32_t) ssrc);
-							}
-						} else if (mediaType.compare("video") == 0) {
-							device->setVideoDirection(mediaDirection);
-						} else if (mediaType.compare("text") == 0) {
-							device->setTextDirection(mediaDirection);
-						} else {
-							lError() << "Unrecognized media type " << mediaType;
-						}
+		if (device && state != ConferenceInfoReader::State::Deleted) {
+			for (const auto &media : endpoint.media) {
+				const std::string &mediaType = media.type;
+				const LinphoneMediaDirection mediaDirection = RemoteConferenceEventHandler::mediaStatusToMediaDirection(media.status);
+				if (mediaType.compare("audio") == 0) {
+					device->setAudioDirection(mediaDirection);
+
+					if (!media.srcId.empty()) {
+						unsigned long ssrc = std::stoul(media.srcId);
+						device->setSsrc((uint32_t) ssrc);
 					}
+				} else if (mediaType.compare("video") == 0) {
+					device->setVideoDirection(mediaDirection);
+				} else if (mediaType.compare("text") == 0) {
+					device->setTextDirection(mediaDirection);
+				} else {
+					lError() << "Unrecognized media type " << mediaType;
 				}
 			}
 		}
 	}
-
-	if (isFullState) {
-		confListener->onFirstNotifyReceived(getConferenceId().getPeerAddress());
-		conf->notifyFullState();
-		if (conf->getState() == ConferenceInterface::State::CreationPending) {
-			// Move to Created state when the list of participants is received
-			conf->setState(ConferenceInterface::State::Created);
-		}
-	}
 }
 
-LinphoneMediaDirection RemoteConferenceEventHandler::mediaStatusToMediaDirection (MediaStatusType status) {
-	switch (status) {
-		case MediaStatusType::inactive:
-			return LinphoneMediaDirectionInactive;
-		case MediaStatusType::sendonly:
-			return LinphoneMediaDirectionSendOnly;
-		case MediaStatusType::recvonly:
-			return LinphoneMediaDirectionRecvOnly;
-		case MediaStatusType::sendrecv:
-			return LinphoneMediaDirectionSendRecv;
-	}
+LinphoneMediaDirection RemoteConferenceEventHandler::mediaStatusToMediaDirection (const string &status) {
+	if (status == "inactive")
+		return LinphoneMediaDirectionInactive;
+	if (status == "sendonly")
+		return LinphoneMediaDirectionSendOnly;
+	if (status == "recvonly")
+		return LinphoneMediaDirectionRecvOnly;
 	return LinphoneMediaDirectionSendRecv;
 }
 
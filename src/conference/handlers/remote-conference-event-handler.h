@@ -25,6 +25,7 @@
 #include "xml/conference-info.h"
 #include "xml/conference-info-linphone-extension.h"
 #include "conference/conference-id.h"
+#include "conference-info-reader.h"
 #include "core/core-listener.h"
 #include "remote-conference-event-handler-base.h"
 #include "chat/chat-room/client-group-chat-room-p.h"
@@ -44,7 +45,7 @@ class LINPHONE_PUBLIC RemoteConferenceEventHandler : public RemoteConferenceEven
 
 public:
 
-	static LinphoneMediaDirection mediaStatusToMediaDirection (Xsd::ConferenceInfo::MediaStatusType status);
+	static LinphoneMediaDirection mediaStatusToMediaDirection (const std::string &status);
 	RemoteConferenceEventHandler (Conference *remoteConference, ConferenceListener * listener);
 	~RemoteConferenceEventHandler ();
 
@@ -76,6 +77,9 @@ protected:
 	bool subscriptionWanted = false;
 
 private:
+	void conferenceDescriptionReceived (const ConferenceInfoReader::Description &description, time_t creationTime, bool isFullState);
+	void userReceived (const ConferenceInfoReader::User &user, time_t creationTime, bool isFullState);
+
 	void unsubscribePrivate ();
 	L_DISABLE_COPY(RemoteConferenceEventHandler);
 };
@@ -36,6 +36,7 @@
 
 // =============================================================================
 
+class LocalConferenceBenchmark;
 class LocalConferenceTester;
 
 namespace LinphoneTest {
@@ -76,6 +77,7 @@ class LINPHONE_PUBLIC Participant : public bellesip::HybridObject<LinphonePartic
 	friend class ServerGroupChatRoomPrivate;
 
 	friend class LinphoneTest::LocalConferenceTester;
+	friend class ::LocalConferenceBenchmark;
 	friend class ::LocalConferenceTester;
 public:
 	explicit Participant (Conference *conference, const IdentityAddress &address, std::shared_ptr<CallSession> callSession);
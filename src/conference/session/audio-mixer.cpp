@@ -17,6 +17,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "streams.h"
 #include "mixers.h"
 
@@ -34,6 +36,10 @@ MS2AudioMixer::MS2AudioMixer(MixerSession &session) : StreamMixer(session){
 	ms_conf_params.active_talker_callback = &MS2AudioMixer::sOnActiveTalkerChanged;
 	ms_conf_params.user_data = this;
 	mConference = ms_audio_conference_new(&ms_conf_params, mSession.getCCore()->factory);
+	int partitionSize = linphone_config_get_int(mSession.getCCore()->config, "sound", "conference_mixer_partition_size", 0);
+	int talkingPartitions = linphone_config_get_int(mSession.getCCore()->config, "sound", "conference_mixer_talking_partitions", 0);
+	mPartitionSize = static_cast<unsigned int>(std::max(partitionSize, 0));
+	mMaxTalkingPartitions = static_cast<unsigned int>(std::max(talkingPartitions, 0));
 }
 
 MS2AudioMixer::~MS2AudioMixer(){
@@ -46,17 +52,29 @@ MS2AudioMixer::~MS2AudioMixer(){
 	if (mLocalEndpoint){
 		removeLocalParticipant();
 	}
+	for (auto &partition : mPartitions){
+		destroyPartition(partition);
+	}
 	ms_audio_conference_destroy(mConference);
+	if (mBridgeProfile){
+		rtp_profile_destroy(mBridgeProfile);
+	}
+}
+
+void MS2AudioMixer::startEventsTimer(){
+	if (mTimer) return;
+	mTimer = mSession.getCore().createTimer([this]() -> bool{
+			ms_audio_conference_process_events(mConference);
+			for (auto &partition : mPartitions){
+				ms_audio_conference_process_events(partition.conference);
+			}
+			return true;
+		}, 50, "AudioConference events timer");
 }
 
 void MS2AudioMixer::addListener(AudioMixerListener *listener){
-	if (mTimer == nullptr){
-		// Start the monitoring of the active talker since somebody wants this information.
-		mTimer = mSession.getCore().createTimer([this]() -> bool{
-				ms_audio_conference_process_events(mConference);
-				return true;
-			}, 50, "AudioConference events timer");
-	}
+	// Start the monitoring of the active talker since somebody wants this information.
+	startEventsTimer();
 	mListeners.push_back(listener);
 }
 
@@ -67,25 +85,178 @@ void MS2AudioMixer::removeListener(AudioMixerListener *listener){
 void MS2AudioMixer::sOnActiveTalkerChanged(MSAudioConference *audioconf, MSAudioEndpoint *ep){
 	const MSAudioConferenceParams *params = ms_audio_conference_get_params(audioconf);
 	MS2AudioMixer *zis = static_cast<MS2AudioMixer*>(params->user_data);
-	zis->onActiveTalkerChanged(ep);
+	if (audioconf == zis->mConference){
+		zis->onActiveTalkerChanged(ep);
+		return;
+	}
+	for (auto &partition : zis->mPartitions){
+		if (partition.conference == audioconf){
+			zis->onPartitionActiveTalkerChanged(partition, ep);
+			return;
+		}
+	}
 }
 
-void MS2AudioMixer::onActiveTalkerChanged(MSAudioEndpoint *ep){
-	StreamsGroup *sg = (StreamsGroup*)ms_audio_endpoint_get_user_data(ep);
+void MS2AudioMixer::notifyActiveTalker(StreamsGroup *sg){
 	for (auto & l : mListeners){
 		l->onActiveTalkerChanged(sg);
 	}
 }
 
+void MS2AudioMixer::onActiveTalkerChanged(MSAudioEndpoint *ep){
+	mMainActiveTalker = ep;
+	for (const auto &partition : mPartitions){
+		if (partition.mainEndpoint == ep){
+			// The partial mix of a partition is the loudest, its own active talker is the one to report.
+			if (partition.hasActiveTalker)
+				notifyActiveTalker(partition.activeTalker);
+			return;
+		}
+	}
+	notifyActiveTalker((StreamsGroup*)ms_audio_endpoint_get_user_data(ep));
+}
+
+void MS2AudioMixer::onPartitionActiveTalkerChanged(Partition &partition, MSAudioEndpoint *ep){
+	if (ep == partition.partitionEndpoint){
+		// The mix coming from the main conference, reported by the main conference itself.
+		return;
+	}
+	partition.activeTalker = (StreamsGroup*)ms_audio_endpoint_get_user_data(ep);
+	partition.hasActiveTalker = true;
+	if (mMaxTalkingPartitions > 0){
+		mTalkingPartitions.remove(&partition);
+		mTalkingPartitions.push_front(&partition);
+		ms_audio_conference_mute_member(mConference, partition.mainEndpoint, FALSE);
+		if (mTalkingPartitions.size() > mMaxTalkingPartitions){
+			ms_audio_conference_mute_member(mConference, mTalkingPartitions.back()->mainEndpoint, TRUE);
+			mTalkingPartitions.pop_back();
+		}
+	}
+	if (mMainActiveTalker == partition.mainEndpoint){
+		notifyActiveTalker(partition.activeTalker);
+	}
+}
+
 void MS2AudioMixer::connectEndpoint(Stream *as, MSAudioEndpoint *endpoint, bool muted){
 	ms_audio_endpoint_set_user_data(endpoint, &as->getGroup());
-	ms_audio_conference_add_member(mConference, endpoint);
-	ms_audio_conference_mute_member(mConference, endpoint, muted);
+	addMember(endpoint, muted);
 }
 
 void MS2AudioMixer::disconnectEndpoint(Stream *as, MSAudioEndpoint *endpoint){
+	removeMember(endpoint);
 	ms_audio_endpoint_set_user_data(endpoint, nullptr);
-	ms_audio_conference_remove_member(mConference, endpoint);
+}
+
+void MS2AudioMixer::addMember(MSAudioEndpoint *endpoint, bool muted){
+	Partition *partition = (mPartitionSize > 0 && mMainMembers >= mPartitionSize) ? getPartitionWithRoom() : nullptr;
+	if (!partition){
+		mMainMembers++;
+		ms_audio_conference_add_member(mConference, endpoint);
+		ms_audio_conference_mute_member(mConference, endpoint, muted);
+		return;
+	}
+	partition->members++;
+	mPartitionMembers[endpoint] = partition;
+	ms_audio_conference_add_member(partition->conference, endpoint);
+	ms_audio_conference_mute_member(partition->conference, endpoint, muted);
+}
+
+void MS2AudioMixer::removeMember(MSAudioEndpoint *endpoint){
+	auto it = mPartitionMembers.find(endpoint);
+	if (it == mPartitionMembers.end()){
+		if (mMainActiveTalker == endpoint) mMainActiveTalker = nullptr;
+		if (mMainMembers > 0) mMainMembers--;
+		ms_audio_conference_remove_member(mConference, endpoint);
+		return;
+	}
+	Partition *partition = it->second;
+	mPartitionMembers.erase(it);
+	if (partition->hasActiveTalker && partition->activeTalker == ms_audio_endpoint_get_user_data(endpoint)){
+		partition->activeTalker = nullptr;
+		partition->hasActiveTalker = false;
+	}
+	ms_audio_conference_remove_member(partition->conference, endpoint);
+	if (--partition->members == 0){
+		destroyPartition(*partition);
+		mPartitions.remove_if([partition](const Partition &p){ return &p == partition; });
+	}
+}
+
+MS2AudioMixer::Partition *MS2AudioMixer::getPartitionWithRoom(){
+	Partition *emptiest = nullptr;
+	for (auto &partition : mPartitions){
+		if (partition.members < mPartitionSize && (!emptiest || partition.members < emptiest->members))
+			emptiest = &partition;
+	}
+	if (emptiest) return emptiest;
+
+	mPartitions.emplace_back();
+	if (!createPartition(mPartitions.back())){
+		destroyPartition(mPartitions.back());
+		mPartitions.pop_back();
+		lError() << "MS2AudioMixer: cannot create a new mixing partition, the participant is mixed by the main conference";
+		return nullptr;
+	}
+	lInfo() << "MS2AudioMixer: mixing partition #" << mPartitions.size() << " created";
+	return &mPartitions.back();
+}
+
+bool MS2AudioMixer::createPartition(Partition &partition){
+	MSAudioConferenceParams params = *ms_audio_conference_get_params(mConference);
+	partition.conference = ms_audio_conference_new(&params, getSession().getCCore()->factory);
+	partition.partitionStream = createBridgeStream();
+	partition.mainStream = createBridgeStream();
+	if (!partition.partitionStream || !partition.mainStream)
+		return false;
+	if (!mBridgeProfile)
+		mBridgeProfile = sMakeDummyProfile(params.samplerate);
+	startBridgeStream(partition.partitionStream, partition.mainStream);
+	startBridgeStream(partition.mainStream, partition.partitionStream);
+	partition.partitionEndpoint = ms_audio_endpoint_get_from_stream(partition.partitionStream, TRUE);
+	partition.mainEndpoint = ms_audio_endpoint_get_from_stream(partition.mainStream, TRUE);
+	ms_audio_conference_add_member(partition.conference, partition.partitionEndpoint);
+	ms_audio_conference_add_member(mConference, partition.mainEndpoint);
+	if (mMaxTalkingPartitions > 0){
+		// Nobody talked in the partition yet, the active talker monitoring unmutes it.
+		ms_audio_conference_mute_member(mConference, partition.mainEndpoint, TRUE);
+		startEventsTimer();
+	}
+	return true;
+}
+
+void MS2AudioMixer::destroyPartition(Partition &partition){
+	mTalkingPartitions.remove(&partition);
+	if (mMainActiveTalker && mMainActiveTalker == partition.mainEndpoint)
+		mMainActiveTalker = nullptr;
+	stopBridgeStream(mConference, partition.mainStream, partition.mainEndpoint);
+	stopBridgeStream(partition.conference, partition.partitionStream, partition.partitionEndpoint);
+	partition.mainStream = partition.partitionStream = nullptr;
+	partition.mainEndpoint = partition.partitionEndpoint = nullptr;
+	if (partition.conference){
+		ms_audio_conference_destroy(partition.conference);
+		partition.conference = nullptr;
+	}
+}
+
+AudioStream *MS2AudioMixer::createBridgeStream(){
+	// Random local ports, the streams only exchange packets over the loopback.
+	return audio_stream_new2(getSession().getCCore()->factory, "127.0.0.1", -1, -1);
+}
+
+void MS2AudioMixer::startBridgeStream(AudioStream *stream, AudioStream *remoteStream){
+	int remotePort = rtp_session_get_local_port(remoteStream->ms.sessions.rtp_session);
+	audio_stream_start_full(stream, mBridgeProfile, "127.0.0.1", remotePort, "127.0.0.1", 0, 0, 40,
+		nullptr, nullptr, nullptr, nullptr, FALSE);
+}
+
+void MS2AudioMixer::stopBridgeStream(MSAudioConference *conference, AudioStream *stream, MSAudioEndpoint *endpoint){
+	if (endpoint){
+		ms_audio_conference_remove_member(conference, endpoint);
+		ms_audio_endpoint_release_from_stream(endpoint);
+	}
+	if (stream){
+		audio_stream_stop(stream);
+	}
 }
 
 RtpProfile *MS2AudioMixer::sMakeDummyProfile(int samplerate) {
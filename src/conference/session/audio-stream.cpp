@@ -411,6 +411,11 @@ void MS2AudioStream::render(const OfferAnswerContext &params, CallSession::State
 			audio_stream_set_client_to_mixer_extension_id(mStream, streamCfg.getClientToMixerExtensionId());
 		}
 
+		// Graphs driven by a sound card have their own ticker, it would otherwise delay the streams sharing it.
+		if (!mCurrentCaptureCard && !mCurrentPlaybackCard)
+			useSharedTicker();
+		else
+			releaseSharedTicker();
 		int err = audio_stream_start_from_io(mStream, audioProfile, dest.rtpAddr.c_str(), dest.rtpPort,
 			dest.rtcpAddr.c_str(), dest.rtcpPort, usedPt, &io);
 		VideoStream *vs = getPeerVideoStream();
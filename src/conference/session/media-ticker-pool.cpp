@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "logger/logger.h"
+#include "media-ticker-pool.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+MediaTickerPool::MediaTickerPool (unsigned int size) {
+	size = max(size, 1u);
+	mAudioSlots.resize(size);
+	mVideoSlots.resize(size);
+	for (unsigned int i = 0; i < size; i++) {
+		mAudioSlots[i].name = "Shared audio MSTicker " + to_string(i);
+		mVideoSlots[i].name = "Shared video MSTicker " + to_string(i);
+	}
+}
+
+shared_ptr<MSTicker> MediaTickerPool::acquire (SalStreamType type) {
+	vector<Slot> &slots = (type == SalVideo) ? mVideoSlots : mAudioSlots;
+
+	Slot *idleSlot = nullptr;
+	shared_ptr<MSTicker> best;
+	float bestLoad = 0;
+	long bestStreams = 0;
+	for (auto &slot : slots) {
+		shared_ptr<MSTicker> ticker = slot.ticker.lock();
+		if (!ticker) {
+			if (!idleSlot)
+				idleSlot = &slot;
+			continue;
+		}
+		float load = ms_ticker_get_average_load(ticker.get());
+		long streams = ticker.use_count() - 1;
+		if (!best || (load < bestLoad) || ((load == bestLoad) && (streams < bestStreams))) {
+			best = ticker;
+			bestLoad = load;
+			bestStreams = streams;
+		}
+	}
+	if (best && !idleSlot) {
+		lInfo() << "Stream placed on " << best->name << " (load " << bestLoad << "%, " << bestStreams << " streams)";
+		return best;
+	}
+
+	// Every running ticker has at least one stream: spread the streams over the whole pool first.
+	MSTickerParams params;
+	memset(&params, 0, sizeof(params));
+	params.name = idleSlot->name.c_str();
+	params.prio = (type == SalVideo) ? MS_TICKER_PRIO_NORMAL : MS_TICKER_PRIO_HIGH;
+	shared_ptr<MSTicker> ticker(ms_ticker_new_with_params(&params), ms_ticker_destroy);
+	idleSlot->ticker = ticker;
+	lInfo() << "Stream placed on new " << idleSlot->name;
+	return ticker;
+}
+
+list<MediaTickerPool::TickerLoad> MediaTickerPool::getLoads () const {
+	list<TickerLoad> loads;
+	appendLoads(mAudioSlots, loads);
+	appendLoads(mVideoSlots, loads);
+	return loads;
+}
+
+// -----------------------------------------------------------------------------
+
+void MediaTickerPool::appendLoads (const vector<Slot> &slots, list<TickerLoad> &loads) {
+	for (const auto &slot : slots) {
+		shared_ptr<MSTicker> ticker = slot.ticker.lock();
+		if (!ticker)
+			continue;
+		loads.push_back(TickerLoad{ slot.name, static_cast<unsigned int>(ticker.use_count() - 1), ms_ticker_get_average_load(ticker.get()) });
+	}
+}
+
+LINPHONE_END_NAMESPACE
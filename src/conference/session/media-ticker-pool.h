@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_MEDIA_TICKER_POOL_H_
+#define _L_MEDIA_TICKER_POOL_H_
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <mediastreamer2/msticker.h>
+
+#include "c-wrapper/internal/c-sal.h"
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+/*
+ * Fixed set of mediastreamer2 tickers shared by the streams of all the calls of a core, instead
+ * of one ticker thread per stream. Video graphs run on their own tickers, audio and text graphs
+ * share the other ones, each kind having at most `size` tickers.
+ * A stream is placed on an idle slot while there is one, then on the least loaded ticker of
+ * its kind. Tickers are reference counted by the streams using them: a ticker is destroyed
+ * when its last stream releases it, even if the pool has been destroyed in the meantime.
+ */
+class MediaTickerPool {
+public:
+	struct TickerLoad {
+		std::string name;
+		unsigned int streams;
+		float load; // Average load of the ticker, in percent of the tick interval.
+	};
+
+	explicit MediaTickerPool (unsigned int size);
+	MediaTickerPool (const MediaTickerPool &) = delete;
+
+	MediaTickerPool &operator= (const MediaTickerPool &) = delete;
+
+	std::shared_ptr<MSTicker> acquire (SalStreamType type);
+
+	unsigned int getSize () const {
+		return static_cast<unsigned int>(mAudioSlots.size());
+	}
+
+	// Running tickers, audio ones first.
+	std::list<TickerLoad> getLoads () const;
+
+private:
+	struct Slot {
+		std::string name;
+		std::weak_ptr<MSTicker> ticker;
+	};
+
+	static void appendLoads (const std::vector<Slot> &slots, std::list<TickerLoad> &loads);
+
+	std::vector<Slot> mAudioSlots;
+	std::vector<Slot> mVideoSlots;
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_MEDIA_TICKER_POOL_H_
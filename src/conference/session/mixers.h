@@ -25,7 +25,15 @@
 
 #include "mediastreamer2/msconference.h"
 
+#include <chrono>
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class AudioMixerBenchmark;
 
 LINPHONE_BEGIN_NAMESPACE
 
@@ -121,6 +129,12 @@ inline std::ostream & operator<<(std::ostream &str, const StreamMixer & mixer){
  * Implementation of a StreamMixer that uses mediastreamer2 to handle the mixing.
  * This StreamMixer also inherits from AudioControlInterface, to give control
  * on the local participant, if enabled.
+ * When [sound] conference_mixer_partition_size is set, the remote participants beyond this number are
+ * split into partitions of at most this size, each one mixed by its own MSAudioConference (thus its own ticker thread).
+ * Each partition is connected to the main conference by a pair of audio streams exchanging L16 over the loopback:
+ * the partition receives the mix of the other participants from the main conference, which receives the partial mix
+ * of the partition members. With [sound] conference_mixer_talking_partitions, only the partial mixes of this number of
+ * partitions, the ones whose members talked most recently, are mixed by the main conference.
  */
 class MS2AudioMixer : public StreamMixer, public AudioControlInterface{
 public:
@@ -160,14 +174,51 @@ public:
 
 	// Used to retrieve participant volumes;
 	MSAudioConference * getAudioConference();
+	// Number of partitions the remote participants not mixed by the main conference are split into.
+	size_t getPartitionCount() const{
+		return mPartitions.size();
+	}
 private:
+	friend class ::AudioMixerBenchmark;
+
+	struct Partition{
+		MSAudioConference *conference = nullptr;
+		// The two ends of the loopback connection between the partition and the main conference.
+		AudioStream *partitionStream = nullptr;
+		AudioStream *mainStream = nullptr;
+		MSAudioEndpoint *partitionEndpoint = nullptr;
+		MSAudioEndpoint *mainEndpoint = nullptr;
+		unsigned int members = 0;
+		StreamsGroup *activeTalker = nullptr;
+		bool hasActiveTalker = false;
+	};
+
+	void addMember(MSAudioEndpoint *endpoint, bool muted);
+	void removeMember(MSAudioEndpoint *endpoint);
+	Partition *getPartitionWithRoom();
+	bool createPartition(Partition &partition);
+	void destroyPartition(Partition &partition);
+	AudioStream *createBridgeStream();
+	void startBridgeStream(AudioStream *stream, AudioStream *remoteStream);
+	void stopBridgeStream(MSAudioConference *conference, AudioStream *stream, MSAudioEndpoint *endpoint);
+	void startEventsTimer();
+	void notifyActiveTalker(StreamsGroup *sg);
 	void onActiveTalkerChanged(MSAudioEndpoint *ep);
+	void onPartitionActiveTalkerChanged(Partition &partition, MSAudioEndpoint *ep);
 	static void sOnActiveTalkerChanged(MSAudioConference *audioconf, MSAudioEndpoint *ep);
 	void addLocalParticipant();
 	void removeLocalParticipant();
 	RtpProfile *sMakeDummyProfile(int samplerate);
 	std::list<AudioMixerListener*> mListeners;
 	MSAudioConference *mConference = nullptr;
+	std::list<Partition> mPartitions;
+	std::unordered_map<MSAudioEndpoint *, Partition *> mPartitionMembers;
+	std::list<Partition *> mTalkingPartitions; // Most recent first.
+	MSAudioEndpoint *mMainActiveTalker = nullptr;
+	RtpProfile *mBridgeProfile = nullptr;
+	unsigned int mMainMembers = 0; // Remote participants mixed by the main conference.
+	unsigned int mPartitionSize = 0;
+	unsigned int mMaxTalkingPartitions = 0;
 	AudioStream *mLocalParticipantStream = nullptr;
 	MSAudioEndpoint *mLocalEndpoint = nullptr;
 	MSAudioEndpoint *mRecordEndpoint = nullptr;
@@ -177,6 +228,93 @@ private:
 	bool mLocalMicEnabled = true;
 };
 
+/**
+ * Selective forwarding of the video of the remote participants of a MS2VideoMixer, used instead of the mediastreamer2
+ * video conference when [video] conference_router_mode is enabled.
+ * The RTP packets received from the focused participant are forwarded as they are to the other participants, the
+ * focused participant receiving the previously focused one: nothing is composed nor re-encoded for them.
+ * The stream of each participant still decodes what it receives, its graph having a void output, so the decoding cost
+ * of the server remains proportional to the number of participants sending video.
+ * The packets are picked up and sent by a RTP transport modifier of each stream, which rewrites their SSRC, payload type,
+ * sequence numbers and timestamps so that each participant receives a single continuous stream whatever the source.
+ * A participant receives video if the direction of its stream allows it, and only from sources using the same codec.
+ * Key frames are requested to a source when it is given to new receivers, and when a receiver asks for one.
+ */
+class MS2VideoRouter{
+public:
+	struct Stats{
+		uint64_t forwardedPackets = 0;
+		uint64_t droppedPackets = 0; // Packets of a receiver whose stream did not send them in time.
+		uint64_t keyFrameRequests = 0;
+	};
+
+	MS2VideoRouter() = default;
+	MS2VideoRouter(const MS2VideoRouter &) = delete;
+	~MS2VideoRouter();
+
+	MS2VideoRouter &operator=(const MS2VideoRouter &) = delete;
+
+	/*
+	 * Add a stream to the router. It must be done before the stream is started, and the stream removed once it is stopped,
+	 * so that its RTP transport modifier is only used while the stream is a member.
+	 */
+	void addMember(MS2VideoStream *stream, SalStreamDir direction, int payloadType, const std::string &mimeType);
+	void removeMember(MS2VideoStream *stream);
+	void setFocus(StreamsGroup *sg);
+	// A receiver asked for a key frame, it is requested to the source of the stream. Main thread only, like the other methods.
+	void requestKeyFrame(MS2VideoStream *stream);
+	Stats getStats() const;
+
+	// The modifier of a stream is kept with its transport, it does nothing while the stream is not a member.
+	static RtpTransportModifier *createTransportModifier();
+private:
+	struct Member{
+		MS2VideoRouter *router = nullptr;
+		MS2VideoStream *stream = nullptr;
+		RtpTransportModifier *modifier = nullptr;
+		bool sends = false; // The participant sends video, thus can be a source.
+		bool receives = false;
+		int payloadType = -1;
+		std::string mimeType;
+		uint32_t ssrc = 0; // SSRC of the stream sent to the participant.
+		// Protected by the router mutex.
+		Member *source = nullptr;
+		std::vector<Member *> receivers;
+		MSQueue pendingPackets;
+		// Only used by the thread of the stream, to rewrite the forwarded packets.
+		uint32_t forwardedSsrc = 0;
+		uint16_t seqOffset = 0;
+		uint32_t tsOffset = 0;
+		uint16_t lastSeq = 0;
+		uint32_t lastTs = 0;
+		bool hasSent = false;
+	};
+
+	static constexpr int MaxPendingPackets = 500;
+	static constexpr int KeyFrameRequestInterval = 500; // ms
+
+	static int sOnSend(RtpTransportModifier *modifier, mblk_t *msg);
+	static int sOnReceive(RtpTransportModifier *modifier, mblk_t *msg);
+	static void sOnSchedule(RtpTransportModifier *modifier);
+	static void sDestroy(RtpTransportModifier *modifier);
+
+	void forward(Member &source, mblk_t *msg);
+	void sendPendingPackets(Member &receiver);
+	void rewrite(Member &receiver, mblk_t *msg);
+	// Returns the sources given to new receivers.
+	std::vector<Member *> updateSources();
+	bool setSource(Member &receiver, Member *source);
+	void requestKeyFrame(Member &source);
+	Member *findMember(const StreamsGroup *sg) const;
+
+	mutable std::mutex mMutex;
+	std::list<std::unique_ptr<Member>> mMembers;
+	Member *mFocus = nullptr;
+	Member *mPreviousFocus = nullptr;
+	std::map<const Member *, std::chrono::steady_clock::time_point> mLastKeyFrameRequests;
+	Stats mStats;
+};
+
 /**
  * A video mixer based on mediastreamer2.
  * It inherits from MS2VideoControl (which is in fact a VideoControlInterface) to let control the local participant, if any.
@@ -189,6 +327,10 @@ public:
 	void disconnectEndpoint(Stream *vs, MSVideoEndpoint *endpoint);
 	virtual void enableLocalParticipant(bool enabled) override;
 	void setFocus(StreamsGroup *sg);
+	// Null unless [video] conference_router_mode is enabled.
+	MS2VideoRouter *getRouter() const{
+		return mRouter.get();
+	}
 	~MS2VideoMixer();
 protected:
 	virtual void onSnapshotTaken(const std::string &filepath) override;
@@ -203,6 +345,7 @@ private:
 	VideoStream *mLocalParticipantStream = nullptr;
 	MSVideoEndpoint *mLocalEndpoint = nullptr;
 	RtpProfile *mLocalDummyProfile = nullptr;
+	std::unique_ptr<MS2VideoRouter> mRouter;
 	static constexpr int sVP8PayloadTypeNumber = 95;
 };
 
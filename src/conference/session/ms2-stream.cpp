@@ -23,6 +23,7 @@
 #include "media-session.h"
 #include "media-session-p.h"
 #include "core/core.h"
+#include "core/core-p.h"
 #include "c-wrapper/c-wrapper.h"
 #include "call/call.h"
 #include "conference/participant.h"
@@ -1208,6 +1209,10 @@ void MS2Stream::handleEvents () {
 						CallSessionListener *listener = getMediaSessionPrivate().getCallSessionListener();
 						listener->onTmmbrReceived(getMediaSession().getSharedFromThis(), (int)getIndex(), (int)rtcp_RTPFB_tmmbr_get_max_bitrate(evd->packet));
 					}
+				} else if (evd->packet && rtcp_is_PSFB(evd->packet)) {
+					rtcp_psfb_type_t type = rtcp_PSFB_get_type(evd->packet);
+					if (type == RTCP_PSFB_PLI || type == RTCP_PSFB_FIR)
+						onKeyFrameRequested();
 				}
 			} while (rtcp_next_packet(evd->packet));
 			rtcp_rewind(evd->packet);
@@ -1356,10 +1361,35 @@ void MS2Stream::finish(){
 		ortp_ev_queue_destroy(mOrtpEvQueue);
 		mOrtpEvQueue = nullptr;
 	}
+	releaseSharedTicker();
 	ms_media_stream_sessions_uninit(&mSessions);
 	Stream::finish();
 }
 
+void MS2Stream::useSharedTicker(){
+	MediaStream *ms = getMediaStream();
+	// A stream restarted after stop() keeps the ticker it got from its sessions.
+	if (!ms || ms->sessions.ticker)
+		return;
+	shared_ptr<MediaTickerPool> pool = getCore().getPrivate()->getMediaTickerPool();
+	if (!pool)
+		return;
+	mSharedTicker = pool->acquire(getType());
+	ms->sessions.ticker = mSharedTicker.get();
+}
+
+void MS2Stream::releaseSharedTicker(){
+	if (!mSharedTicker)
+		return;
+	// The ticker is still used by the streams of other calls, the pool destroys it with its last stream.
+	MediaStream *ms = getMediaStream();
+	if (ms && ms->sessions.ticker == mSharedTicker.get())
+		ms->sessions.ticker = nullptr;
+	if (mSessions.ticker == mSharedTicker.get())
+		mSessions.ticker = nullptr;
+	mSharedTicker = nullptr;
+}
+
 bool MS2Stream::avpfEnabled() const{
 	return media_stream_avpf_enabled(getMediaStream());
 }
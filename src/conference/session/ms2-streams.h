@@ -90,10 +90,17 @@ protected:
 	};
 	void getRtpDestination(const OfferAnswerContext &params, RtpAddressInfo *info);
 	void dtlsEncryptionChanged();
+	// To be called right before starting the media stream, so that its graph runs on a ticker of the core pool if enabled.
+	void useSharedTicker();
+	// Gives the shared ticker back, so that the media stream creates its own one when started.
+	void releaseSharedTicker();
+	// The remote party asked for a key frame with a RTCP PLI or FIR. Called from the main thread.
+	virtual void onKeyFrameRequested(){}
 	std::string mDtlsFingerPrint;
 	RtpProfile *mRtpProfile = nullptr;
 	RtpProfile *mRtpIoProfile = nullptr;
 	MSMediaStreamSessions mSessions;
+	std::shared_ptr<MSTicker> mSharedTicker; // Set when mSessions.ticker comes from the core pool.
 	OrtpEvQueue *mOrtpEvQueue = nullptr;
 	LinphoneCallStats *mStats = nullptr;
 	int mOutputBandwidth; // Target output bandwidth for the stream. 
@@ -268,11 +275,14 @@ public:
 
 	void oglRender();
 	MSWebCam * getVideoDevice(CallSession::State targetState)const;
+	// Created and added to the RTP transport of the stream on first use, for the MS2VideoRouter of the conference.
+	RtpTransportModifier *getRouterTransportModifier();
 
 	virtual ~MS2VideoStream();
 protected:
 	AudioStream *getPeerAudioStream();
 	virtual void onSnapshotTaken(const std::string &filepath) override;
+	virtual void onKeyFrameRequested() override;
 private:
 	virtual void handleEvent(const OrtpEvent *ev) override;
 	virtual void zrtpStarted(Stream *mainZrtpStream) override;
@@ -285,6 +295,8 @@ private:
 	MS2VideoMixer *getVideoMixer();
 	VideoStream *mStream = nullptr;
 	struct _MSVideoEndpoint *mConferenceEndpoint = nullptr;
+	RtpTransportModifier *mRouterModifier = nullptr; // Owned by the RTP transport.
+	bool mRouted = false;
 };
 
 /*
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "bctoolbox/port.h"
+
+#include "logger/logger.h"
+#include "rtp-port-pool.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+int RtpPortPool::allocate (pair<int, int> portRange) {
+	Range &range = getRange(portRange);
+
+	int slot = -1;
+	if (range.sequential) {
+		for (int candidate = 0; candidate < static_cast<int>(range.freeSlotPositions.size()); candidate++) {
+			if (range.freeSlotPositions[static_cast<size_t>(candidate)] == -1)
+				continue;
+			int port = range.base + 2 * candidate;
+			if (isPortTaken(port) || isPortTaken(port + 1)) {
+				mStats.collisions++;
+				continue;
+			}
+			slot = candidate;
+			break;
+		}
+	} else {
+		// The free pairs of the range are only taken by another range if the ranges overlap, retry a few times in this case.
+		for (int nbTries = 0; (nbTries < MaxTries) && !range.freeSlots.empty(); nbTries++) {
+			int candidate = range.freeSlots[bctbx_random() % range.freeSlots.size()];
+			int port = range.base + 2 * candidate;
+			if (isPortTaken(port) || isPortTaken(port + 1)) {
+				mStats.collisions++;
+				continue;
+			}
+			slot = candidate;
+			break;
+		}
+	}
+
+	if (slot == -1) {
+		mStats.failures++;
+		lError() << "Could not find any free port in range [" << portRange.first << ", " << portRange.second << "], "
+			<< mStats.allocatedPorts << " RTP/RTCP pairs are in use";
+		return -1;
+	}
+
+	takeSlot(range, slot);
+	int port = range.base + 2 * slot;
+	mTakenPorts[static_cast<size_t>(port)] = true;
+	mTakenPorts[static_cast<size_t>(port + 1)] = true;
+	mAllocations[port] = &range;
+
+	mStats.allocations++;
+	mStats.allocatedPorts++;
+	mStats.maxAllocatedPorts = max(mStats.maxAllocatedPorts, mStats.allocatedPorts);
+	return port;
+}
+
+void RtpPortPool::release (int rtpPort) {
+	auto it = mAllocations.find(rtpPort);
+	if (it == mAllocations.end())
+		return;
+
+	Range &range = *it->second;
+	size_t slot = static_cast<size_t>((rtpPort - range.base) / 2);
+	range.freeSlotPositions[slot] = static_cast<int>(range.freeSlots.size());
+	range.freeSlots.push_back(static_cast<int>(slot));
+	mTakenPorts[static_cast<size_t>(rtpPort)] = false;
+	mTakenPorts[static_cast<size_t>(rtpPort + 1)] = false;
+	mAllocations.erase(it);
+	mStats.allocatedPorts--;
+}
+
+list<RtpPortPool::RangeOccupancy> RtpPortPool::getOccupancy () const {
+	list<RangeOccupancy> occupancy;
+	for (const auto &range : mRanges) {
+		size_t capacity = range.second.freeSlotPositions.size();
+		occupancy.push_back(RangeOccupancy{ range.first.first, range.first.second, capacity, capacity - range.second.freeSlots.size() });
+	}
+	return occupancy;
+}
+
+// -----------------------------------------------------------------------------
+
+RtpPortPool::Range &RtpPortPool::getRange (pair<int, int> portRange) {
+	auto it = mRanges.find(portRange);
+	if (it != mRanges.end())
+		return it->second;
+
+	Range &range = mRanges[portRange];
+	range.base = portRange.first;
+	int nbSlots = 0;
+	if (portRange.first == portRange.second) {
+		range.sequential = true;
+		nbSlots = FixedPortSlots;
+	} else if (portRange.second > portRange.first) {
+		/* Same even offsets as a random pick in [0, second - first[: if the range starts with an odd number,
+		 * RTP ports are odd. */
+		nbSlots = (portRange.second - portRange.first + 1) / 2;
+	}
+	// Both ports of the last pair must be valid.
+	if (range.base < 1)
+		nbSlots = 0;
+	else
+		nbSlots = max(0, min(nbSlots, (MaxPort - range.base + 1) / 2));
+
+	range.freeSlots.resize(static_cast<size_t>(nbSlots));
+	range.freeSlotPositions.resize(static_cast<size_t>(nbSlots));
+	for (int slot = 0; slot < nbSlots; slot++) {
+		range.freeSlots[static_cast<size_t>(slot)] = slot;
+		range.freeSlotPositions[static_cast<size_t>(slot)] = slot;
+	}
+	return range;
+}
+
+bool RtpPortPool::isPortTaken (int port) const {
+	return port >= 0 && port <= MaxPort && mTakenPorts[static_cast<size_t>(port)];
+}
+
+void RtpPortPool::takeSlot (Range &range, int slot) {
+	size_t position = static_cast<size_t>(range.freeSlotPositions[static_cast<size_t>(slot)]);
+	int lastSlot = range.freeSlots.back();
+	range.freeSlots[position] = lastSlot;
+	range.freeSlotPositions[static_cast<size_t>(lastSlot)] = static_cast<int>(position);
+	range.freeSlots.pop_back();
+	range.freeSlotPositions[static_cast<size_t>(slot)] = -1;
+}
+
+LINPHONE_END_NAMESPACE
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_RTP_PORT_POOL_H_
+#define _L_RTP_PORT_POOL_H_
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+/*
+ * RTP/RTCP port pairs used by the streams of all the calls of a core.
+ * Each configured port range has its own list of free pairs, so that a stream gets its
+ * ports in constant time whatever the number of calls. A range whose bounds are equal
+ * is a fixed port: the pairs following it are then taken in order, like before the pool.
+ * Ports are kept until the stream releases them, so two streams never share a pair even
+ * when the audio, video and text ranges overlap.
+ */
+class LINPHONE_PUBLIC RtpPortPool {
+public:
+	struct Stats {
+		unsigned int allocatedPorts = 0; // RTP/RTCP pairs currently in use.
+		unsigned int maxAllocatedPorts = 0;
+		unsigned int allocations = 0;
+		unsigned int failures = 0; // Allocations that found no free pair in the range.
+		// Pairs skipped because they were taken through another overlapping range.
+		unsigned int collisions = 0;
+	};
+
+	struct RangeOccupancy {
+		int minPort;
+		int maxPort;
+		size_t capacity; // RTP/RTCP pairs of the range.
+		size_t used;
+	};
+
+	RtpPortPool () = default;
+	RtpPortPool (const RtpPortPool &) = delete;
+
+	RtpPortPool &operator= (const RtpPortPool &) = delete;
+
+	// Returns the RTP port of a free pair of the range (the RTCP port being the next one), -1 if there is none.
+	int allocate (std::pair<int, int> portRange);
+	void release (int rtpPort);
+
+	bool isAllocated (int rtpPort) const {
+		return mAllocations.find(rtpPort) != mAllocations.end();
+	}
+
+	const Stats &getStats () const {
+		return mStats;
+	}
+
+	std::list<RangeOccupancy> getOccupancy () const;
+
+private:
+	struct Range {
+		int base = 0;
+		bool sequential = false;
+		std::vector<int> freeSlots;
+		std::vector<int> freeSlotPositions; // Index of each slot in freeSlots, -1 if the slot is allocated.
+	};
+
+	static constexpr int MaxPort = 65535;
+	static constexpr int FixedPortSlots = 50;
+	static constexpr int MaxTries = 100;
+
+	Range &getRange (std::pair<int, int> portRange);
+	bool isPortTaken (int port) const;
+	void takeSlot (Range &range, int slot);
+
+	std::map<std::pair<int, int>, Range> mRanges;
+	// RTP port of each allocated pair and the range it has been taken from.
+	std::unordered_map<int, Range *> mAllocations;
+	std::vector<bool> mTakenPorts = std::vector<bool>(MaxPort + 1, false);
+	Stats mStats;
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_RTP_PORT_POOL_H_
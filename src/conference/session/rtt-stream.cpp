@@ -94,6 +94,7 @@ void MS2RTTStream::render(const OfferAnswerContext &params, CallSession::State t
 	unsigned int interval = getMediaSessionPrivate().getParams()->realtimeTextKeepaliveInterval();
 	getMediaSessionPrivate().getCurrentParams()->setRealtimeTextKeepaliveInterval(interval);
 	
+	useSharedTicker();
 	text_stream_start(mStream, textProfile, dest.rtpAddr.c_str(), dest.rtpPort, dest.rtcpAddr.c_str(), dest.rtcpPort, usedPt);
 	ms_filter_add_notify_callback(mStream->rttsink, sRealTimeTextCharacterReceived, this, false);
 	ms_filter_call_method(mStream->rttsource, MS_RTT_4103_SOURCE_SET_KEEP_ALIVE_INTERVAL, &interval);
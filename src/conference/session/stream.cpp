@@ -23,9 +23,10 @@
 #include "media-session.h"
 #include "media-session-p.h"
 #include "core/core.h"
+#include "core/core-p.h"
 #include "c-wrapper/c-wrapper.h"
-#include "call/call.h"
 #include "conference/participant.h"
+#include "rtp-port-pool.h"
 #include "utils/payload-type-handler.h"
 #include "conference/params/media-session-params-p.h"
 
@@ -117,64 +118,36 @@ void Stream::setRandomPortConfig () {
 	mPortConfig.rtcpPort = -1;
 }
 
-int Stream::selectRandomPort (pair<int, int> portRange) {
-	unsigned int rangeSize = static_cast<unsigned int>(portRange.second - portRange.first);
-	
-	for (int nbTries = 0; nbTries < 100; nbTries++) {
-		bool alreadyUsed = false;
-		unsigned int randomInRangeSize = (bctbx_random() % rangeSize) & (unsigned int)~0x1; /* Select an even number */
-		int triedPort = ((int)randomInRangeSize) + portRange.first;
-		/*If portRange.first is even, the triedPort will be even too. The one who configures a port range that starts with an odd number will
-		 * get odd RTP port numbers.*/
-		
-		for (const bctbx_list_t *elem = linphone_core_get_calls(getCCore()); elem != nullptr; elem = bctbx_list_next(elem)) {
-			LinphoneCall *lcall = static_cast<LinphoneCall *>(bctbx_list_get_data(elem));
-			shared_ptr<MediaSession> session = static_pointer_cast<MediaSession>(LinphonePrivate::Call::toCpp(lcall)->getActiveSession());
-			if (session->getPrivate()->getStreamsGroup().isPortUsed(triedPort)) {
-				alreadyUsed = true;
-				break;
-			}
-		}
-		if (!alreadyUsed){
-			lInfo() << "Port " << triedPort << " randomly taken from range [ " << portRange.first << " , " << portRange.second << "]";
-			return triedPort;
-		}
-	}
+int Stream::allocatePort (pair<int, int> portRange) {
+	releasePort();
+	shared_ptr<RtpPortPool> portPool = getCore().getPrivate()->rtpPortPool;
+	int port = portPool->allocate(portRange);
+	if (port == -1)
+		return -1;
 
-	lError() << "Could not find any free port!";
-	return -1;
-}
-
-int Stream::selectFixedPort (pair<int, int> portRange) {
-	for (int triedPort = portRange.first; triedPort < (portRange.first + 100); triedPort += 2) {
-		bool alreadyUsed = false;
-		for (const bctbx_list_t *elem = linphone_core_get_calls(getCCore()); elem != nullptr; elem = bctbx_list_next(elem)) {
-			LinphoneCall *lcall = static_cast<LinphoneCall *>(bctbx_list_get_data(elem));
-			shared_ptr<MediaSession> session = static_pointer_cast<MediaSession>(LinphonePrivate::Call::toCpp(lcall)->getActiveSession());
-			if (session->getPrivate()->getStreamsGroup().isPortUsed(triedPort)) {
-				alreadyUsed = true;
-				break;
-			}
-		}
-		if (!alreadyUsed)
-			return triedPort;
-	}
+	mPortPool = portPool;
+	mAllocatedPort = port;
+	if (portRange.first != portRange.second)
+		lInfo() << "Port " << port << " randomly taken from range [ " << portRange.first << " , " << portRange.second << "]";
+	return port;
+}
 
-	lError() << "Could not find any free port !";
-	return -1;
+void Stream::releasePort () {
+	if (mAllocatedPort == -1)
+		return;
+	shared_ptr<RtpPortPool> portPool = mPortPool.lock();
+	if (portPool)
+		portPool->release(mAllocatedPort);
+	mPortPool.reset();
+	mAllocatedPort = -1;
 }
 
 void Stream::setPortConfig(pair<int, int> portRange) {
 	if ((portRange.first <= 0) && (portRange.second <= 0)) {
 		setRandomPortConfig();
 	} else {
-		if (portRange.first == portRange.second) {
-			/* Fixed port */
-			mPortConfig.rtpPort = selectFixedPort(portRange);
-		} else {
-			/* Select random port in the specified range */
-			mPortConfig.rtpPort = selectRandomPort(portRange);
-		}
+		/* Fixed port (and the following ones if it is in use) or random port in the specified range */
+		mPortConfig.rtpPort = allocatePort(portRange);
 	}
 	if (mPortConfig.rtpPort == -1) setRandomPortConfig();
 	else mPortConfig.rtcpPort = mPortConfig.rtpPort + 1;
@@ -212,10 +185,6 @@ void Stream::fillMulticastMediaAddresses () {
 	}
 }
 
-bool Stream::isPortUsed(int port)const{
-	return port == mPortConfig.rtpPort || port == mPortConfig.rtcpPort;
-}
-
 IceService & Stream::getIceService()const{
 	return mStreamsGroup.getIceService();
 }
@@ -228,6 +197,11 @@ const string & Stream::getPublicIp() const{
 }
 
 void Stream::finish(){
+	releasePort();
+}
+
+Stream::~Stream(){
+	releasePort();
 }
 
 LINPHONE_END_NAMESPACE
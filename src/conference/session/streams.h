@@ -37,6 +37,7 @@ class MediaSession;
 class MediaSessionPrivate;
 class MediaSessionParams;
 class IceService;
+class RtpPortPool;
 class StreamMixer;
 class MixerSession;
 
@@ -134,7 +135,6 @@ public:
 	Core &getCore()const;
 	MediaSession &getMediaSession()const;
 	MediaSessionPrivate &getMediaSessionPrivate()const;
-	bool isPortUsed(int port) const;
 	IceService & getIceService()const;
 	State getState()const{ return mState;}
 	StreamsGroup &getGroup()const{ return mStreamsGroup;}
@@ -143,7 +143,7 @@ public:
 	int getStartCount()const{ return mStartCount; }
 	int getStopCount()const{ return mStopCount; }
 	const PortConfig &getPortConfig()const{ return mPortConfig; }
-	virtual ~Stream() = default;
+	virtual ~Stream();
 	static std::string stateToString(State st){
 		switch(st){
 			case Stopped:
@@ -170,8 +170,8 @@ protected:
 private:
 	void setMain();
 	void setPortConfig(std::pair<int, int> portRange);
-	int selectFixedPort(std::pair<int, int> portRange);
-	int selectRandomPort(std::pair<int, int> portRange);
+	int allocatePort(std::pair<int, int> portRange);
+	void releasePort();
 	void setPortConfig();
 	void setRandomPortConfig();
 	void fillMulticastMediaAddresses();
@@ -182,6 +182,8 @@ private:
 	StreamMixer *mMixer = nullptr;
 	bool mIsMain = false;
 	int mStopCount = 0; /* Count of stop() */
+	std::weak_ptr<RtpPortPool> mPortPool; /* The streams of a call may outlive the core. */
+	int mAllocatedPort = -1; /* RTP port taken from the pool, it may differ from mPortConfig.rtpPort with multicast. */
 };
 
 inline std::ostream &operator<<(std::ostream & ostr, SalStreamType type){
@@ -392,7 +394,6 @@ public:
 	MediaSession &getMediaSession()const{
 		return mMediaSession;
 	}
-	bool isPortUsed(int port)const;
 	IceService &getIceService()const;
 	bool allStreamsEncrypted () const;
 	// Returns true if at least one stream was started.
@@ -31,6 +31,10 @@ MS2VideoMixer::MS2VideoMixer(MixerSession & session) : StreamMixer(session), MS2
 	params.codec_mime_type = "VP8";
 	params.min_switch_interval = 3000;
 	mConference = ms_video_conference_new(mSession.getCCore()->factory, &params);
+	if (linphone_config_get_bool(linphone_core_get_config(mSession.getCCore()), "video", "conference_router_mode", FALSE)){
+		lInfo() << "MS2VideoMixer: video of the remote participants is forwarded without being transcoded.";
+		mRouter.reset(new MS2VideoRouter());
+	}
 }
 
 void MS2VideoMixer::connectEndpoint(Stream *vs, MSVideoEndpoint *endpoint, bool muted){
@@ -46,6 +50,12 @@ void MS2VideoMixer::disconnectEndpoint(Stream *vs, MSVideoEndpoint *endpoint){
 void MS2VideoMixer::setFocus(StreamsGroup *sg){
 	MSVideoEndpoint *ep = nullptr;
 	
+	if (mRouter){
+		// The local participant has no video in router mode.
+		if (sg) mRouter->setFocus(sg);
+		return;
+	}
+	
 	if (sg == nullptr){
 		ep = mLocalEndpoint;
 	}else{
@@ -147,6 +157,10 @@ void MS2VideoMixer::removeLocalParticipant(){
 
 
 void MS2VideoMixer::enableLocalParticipant(bool enabled){
+	if (enabled && mRouter){
+		lWarning() << "MS2VideoMixer: the local participant cannot send nor receive video in router mode.";
+		return;
+	}
 	if (enabled) addLocalParticipant();
 	else removeLocalParticipant();
 }
@@ -165,6 +179,11 @@ void MS2VideoMixer::onSnapshotTaken(const std::string &filepath){
 }
 
 MS2VideoMixer::~MS2VideoMixer(){
+	if (mRouter){
+		MS2VideoRouter::Stats stats = mRouter->getStats();
+		lInfo() << "MS2VideoMixer: " << stats.forwardedPackets << " packets forwarded, " << stats.droppedPackets
+			<< " dropped, " << stats.keyFrameRequests << " key frames requested.";
+	}
 	removeLocalParticipant();
 	ms_video_conference_destroy(mConference);
 }
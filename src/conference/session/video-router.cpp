@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <bctoolbox/port.h>
+
+#include "streams.h"
+#include "mixers.h"
+
+#include "logger/logger.h"
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+MS2VideoRouter::~MS2VideoRouter(){
+	for (auto &member : mMembers){
+		member->modifier->data = nullptr;
+		ms_queue_flush(&member->pendingPackets);
+	}
+}
+
+void MS2VideoRouter::addMember(MS2VideoStream *stream, SalStreamDir direction, int payloadType, const string &mimeType){
+	unique_ptr<Member> member(new Member());
+	member->router = this;
+	member->stream = stream;
+	member->modifier = stream->getRouterTransportModifier();
+	// Directions are the ones of the stream of the conference server.
+	member->sends = (direction == SalStreamSendRecv || direction == SalStreamRecvOnly);
+	member->receives = (direction == SalStreamSendRecv || direction == SalStreamSendOnly);
+	member->payloadType = payloadType;
+	member->mimeType = mimeType;
+	member->ssrc = rtp_session_get_send_ssrc(stream->getMediaStream()->sessions.rtp_session);
+	ms_queue_init(&member->pendingPackets);
+	member->modifier->data = member.get();
+	lInfo() << "MS2VideoRouter: adding " << *stream << " using " << mimeType << (member->sends ? ", source" : "")
+		<< (member->receives ? ", receiver" : "");
+
+	vector<Member *> sources;
+	{
+		lock_guard<mutex> lock(mMutex);
+		if (!mFocus && member->sends)
+			mFocus = member.get();
+		mMembers.push_back(move(member));
+		sources = updateSources();
+	}
+	for (Member *source : sources)
+		requestKeyFrame(*source);
+}
+
+void MS2VideoRouter::removeMember(MS2VideoStream *stream){
+	vector<Member *> sources;
+	{
+		lock_guard<mutex> lock(mMutex);
+		auto it = find_if(mMembers.begin(), mMembers.end(), [stream](const unique_ptr<Member> &member){
+			return member->stream == stream;
+		});
+		if (it == mMembers.end())
+			return;
+
+		Member *member = it->get();
+		lInfo() << "MS2VideoRouter: removing " << *stream;
+		setSource(*member, nullptr);
+		for (Member *receiver : member->receivers)
+			receiver->source = nullptr;
+		member->receivers.clear();
+		if (mPreviousFocus == member)
+			mPreviousFocus = nullptr;
+		if (mFocus == member){
+			mFocus = mPreviousFocus;
+			mPreviousFocus = nullptr;
+		}
+		mLastKeyFrameRequests.erase(member);
+		member->modifier->data = nullptr;
+		ms_queue_flush(&member->pendingPackets);
+		mMembers.erase(it);
+		sources = updateSources();
+	}
+	for (Member *source : sources)
+		requestKeyFrame(*source);
+}
+
+void MS2VideoRouter::setFocus(StreamsGroup *sg){
+	vector<Member *> sources;
+	{
+		lock_guard<mutex> lock(mMutex);
+		Member *member = findMember(sg);
+		if (!member){
+			lError() << "MS2VideoRouter: cannot find stream requested for focus.";
+			return;
+		}
+		if (member == mFocus)
+			return;
+		if (!member->sends){
+			lWarning() << "MS2VideoRouter: " << *member->stream << " does not send video, focus is kept.";
+			return;
+		}
+		mPreviousFocus = mFocus;
+		mFocus = member;
+		sources = updateSources();
+	}
+	for (Member *source : sources)
+		requestKeyFrame(*source);
+}
+
+void MS2VideoRouter::requestKeyFrame(MS2VideoStream *stream){
+	Member *source = nullptr;
+	{
+		lock_guard<mutex> lock(mMutex);
+		for (auto &member : mMembers){
+			if (member->stream == stream){
+				source = member->source;
+				break;
+			}
+		}
+	}
+	if (source)
+		requestKeyFrame(*source);
+}
+
+MS2VideoRouter::Stats MS2VideoRouter::getStats() const{
+	lock_guard<mutex> lock(mMutex);
+	return mStats;
+}
+
+RtpTransportModifier *MS2VideoRouter::createTransportModifier(){
+	RtpTransportModifier *modifier = ms_new0(RtpTransportModifier, 1);
+	modifier->t_process_on_send = sOnSend;
+	modifier->t_process_on_receive = sOnReceive;
+	modifier->t_process_on_schedule = sOnSchedule;
+	modifier->t_destroy = sDestroy;
+	return modifier;
+}
+
+// -----------------------------------------------------------------------------
+
+int MS2VideoRouter::sOnSend(RtpTransportModifier *modifier, mblk_t *msg){
+	return (int)msgdsize(msg);
+}
+
+int MS2VideoRouter::sOnReceive(RtpTransportModifier *modifier, mblk_t *msg){
+	Member *member = static_cast<Member *>(modifier->data);
+	int size = (int)msgdsize(msg);
+	if (member && member->sends && size >= RTP_FIXED_HEADER_SIZE){
+		const rtp_header_t *rtp = (const rtp_header_t *)msg->b_rptr;
+		// STUN packets have a version of 0.
+		if (rtp->version == 2 && (int)rtp->paytype == member->payloadType)
+			member->router->forward(*member, msg);
+	}
+	// The packet is still given to the stream, for its statistics and inactivity detection.
+	return size;
+}
+
+void MS2VideoRouter::sOnSchedule(RtpTransportModifier *modifier){
+	Member *member = static_cast<Member *>(modifier->data);
+	if (member)
+		member->router->sendPendingPackets(*member);
+}
+
+void MS2VideoRouter::sDestroy(RtpTransportModifier *modifier){
+	ms_free(modifier);
+}
+
+void MS2VideoRouter::forward(Member &source, mblk_t *msg){
+	lock_guard<mutex> lock(mMutex);
+	for (Member *receiver : source.receivers){
+		if (receiver->pendingPackets.q.q_mcount >= MaxPendingPackets){
+			freemsg(ms_queue_get(&receiver->pendingPackets));
+			mStats.droppedPackets++;
+		}
+		ms_queue_put(&receiver->pendingPackets, copymsg(msg));
+		mStats.forwardedPackets++;
+	}
+}
+
+void MS2VideoRouter::sendPendingPackets(Member &receiver){
+	MSQueue packets;
+	mblk_t *msg;
+	ms_queue_init(&packets);
+	{
+		lock_guard<mutex> lock(mMutex);
+		while ((msg = ms_queue_get(&receiver.pendingPackets)) != nullptr)
+			ms_queue_put(&packets, msg);
+	}
+	while ((msg = ms_queue_get(&packets)) != nullptr){
+		rewrite(receiver, msg);
+		meta_rtp_transport_modifier_inject_packet_to_send(receiver.modifier->transport, receiver.modifier, msg, 0);
+	}
+}
+
+void MS2VideoRouter::rewrite(Member &receiver, mblk_t *msg){
+	rtp_header_t *rtp = (rtp_header_t *)msg->b_rptr;
+	uint32_t ssrc = ntohl(rtp->ssrc);
+	uint16_t seq = ntohs(rtp->seq_number);
+	uint32_t ts = ntohl(rtp->timestamp);
+
+	if (!receiver.hasSent || ssrc != receiver.forwardedSsrc){
+		// New source: its packets follow the last ones sent to the receiver, one frame later at 30 fps.
+		receiver.seqOffset = static_cast<uint16_t>(receiver.lastSeq + 1 - seq);
+		receiver.tsOffset = receiver.lastTs + 3000 - ts;
+		receiver.forwardedSsrc = ssrc;
+	}
+	uint16_t outSeq = static_cast<uint16_t>(seq + receiver.seqOffset);
+	uint32_t outTs = ts + receiver.tsOffset;
+	// Reordered packets must not move the sequence backward.
+	if (!receiver.hasSent || static_cast<int16_t>(outSeq - receiver.lastSeq) > 0){
+		receiver.lastSeq = outSeq;
+		receiver.lastTs = outTs;
+	}
+	receiver.hasSent = true;
+
+	rtp->ssrc = htonl(receiver.ssrc);
+	rtp->seq_number = htons(outSeq);
+	rtp->timestamp = htonl(outTs);
+	rtp->paytype = static_cast<uint16_t>(receiver.payloadType);
+}
+
+vector<MS2VideoRouter::Member *> MS2VideoRouter::updateSources(){
+	vector<Member *> newSources;
+	for (auto &member : mMembers){
+		Member *receiver = member.get();
+		Member *source = nullptr;
+		if (receiver->receives){
+			auto isValidSource = [receiver](const Member *candidate){
+				return candidate && candidate != receiver && candidate->sends
+					&& strcasecmp(candidate->mimeType.c_str(), receiver->mimeType.c_str()) == 0;
+			};
+			source = (receiver == mFocus) ? mPreviousFocus : mFocus;
+			if (!isValidSource(source)){
+				// Any other participant using the same codec rather than no video at all.
+				source = nullptr;
+				for (auto &candidate : mMembers){
+					if (isValidSource(candidate.get())){
+						source = candidate.get();
+						break;
+					}
+				}
+			}
+		}
+		if (setSource(*receiver, source) && source
+			&& find(newSources.begin(), newSources.end(), source) == newSources.end())
+			newSources.push_back(source);
+	}
+	return newSources;
+}
+
+bool MS2VideoRouter::setSource(Member &receiver, Member *source){
+	if (receiver.source == source)
+		return false;
+	if (receiver.source){
+		auto &receivers = receiver.source->receivers;
+		receivers.erase(remove(receivers.begin(), receivers.end(), &receiver), receivers.end());
+	}
+	receiver.source = source;
+	if (source){
+		source->receivers.push_back(&receiver);
+		lInfo() << "MS2VideoRouter: " << *receiver.stream << " now receives " << *source->stream;
+	}
+	return true;
+}
+
+void MS2VideoRouter::requestKeyFrame(Member &source){
+	auto now = chrono::steady_clock::now();
+	{
+		lock_guard<mutex> lock(mMutex);
+		auto it = mLastKeyFrameRequests.find(&source);
+		if (it != mLastKeyFrameRequests.end() && now - it->second < chrono::milliseconds(KeyFrameRequestInterval))
+			return;
+		mLastKeyFrameRequests[&source] = now;
+		mStats.keyFrameRequests++;
+	}
+	source.stream->sendVfuRequest();
+}
+
+MS2VideoRouter::Member *MS2VideoRouter::findMember(const StreamsGroup *sg) const{
+	for (auto &member : mMembers){
+		if (&member->stream->getGroup() == sg)
+			return member.get();
+	}
+	return nullptr;
+}
+
+LINPHONE_END_NAMESPACE
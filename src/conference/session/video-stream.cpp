@@ -290,6 +290,14 @@ void MS2VideoStream::render(const OfferAnswerContext & ctx, CallSession::State t
 	video_stream_set_device_rotation(mStream, getCCore()->device_rotation);
 	video_stream_set_freeze_on_error(mStream, !!linphone_config_get_int(linphone_core_get_config(getCCore()), "video", "freeze_on_error", 1));
 	video_stream_use_video_preset(mStream, linphone_config_get_string(linphone_core_get_config(getCCore()), "video", "preset", nullptr));
+	useSharedTicker();
+	MS2VideoRouter *router = videoMixer ? videoMixer->getRouter() : nullptr;
+	if (router && !bundleEnabled()) {
+		// The packets of the stream are forwarded by the router. Its graph still receives and decodes them, for the
+		// statistics and inactivity detection, but renders nothing.
+		router->addMember(this, vstream.getDirection(), usedPt, rtp_profile_get_payload(videoProfile, usedPt)->mime_type);
+		mRouted = true;
+	}
 	if (getCCore()->video_conf.reuse_preview_source && source) {
 		lInfo() << "video_stream_start_with_source kept: " << source;
 		video_stream_start_with_source(mStream, videoProfile, dest.rtpAddr.c_str(), dest.rtpPort, dest.rtcpAddr.c_str(),
@@ -346,7 +354,7 @@ void MS2VideoStream::render(const OfferAnswerContext & ctx, CallSession::State t
 		lWarning() << "Video preview (" << source << ") not reused: destroying it";
 		ms_filter_destroy(source);
 	}
-	if (videoMixer){
+	if (videoMixer && !mRouted){
 		mConferenceEndpoint = ms_video_endpoint_get_from_stream(mStream, TRUE);
 		videoMixer->connectEndpoint(this, mConferenceEndpoint, (vstream.getDirection() == SalStreamRecvOnly));
 	}
@@ -364,6 +372,11 @@ void MS2VideoStream::stop(){
 		mConferenceEndpoint = nullptr;
 	}
 	video_stream_stop(mStream);
+	if (mRouted){
+		// Only now that the graph is stopped, as the transport modifier is used by the ticker of the stream until then.
+		getVideoMixer()->getRouter()->removeMember(this);
+		mRouted = false;
+	}
 	/* In mediastreamer2, stop actually stops and destroys. We immediately need to recreate the stream object for later use, keeping the 
 	 * sessions (for RTP, SRTP, ZRTP etc) that were setup at the beginning. */
 	mStream = video_stream_new_with_sessions(getCCore()->factory, &mSessions);
@@ -397,6 +410,21 @@ void MS2VideoStream::tryEarlyMediaForking(const OfferAnswerContext &ctx){
 	sendVfu();
 }
 
+RtpTransportModifier *MS2VideoStream::getRouterTransportModifier(){
+	if (!mRouterModifier){
+		mRouterModifier = MS2VideoRouter::createTransportModifier();
+		// Before the SRTP modifier, so that forwarded packets are decrypted on reception and encrypted again when sent.
+		meta_rtp_transport_prepend_modifier(getMetaRtpTransports().first, mRouterModifier);
+	}
+	return mRouterModifier;
+}
+
+void MS2VideoStream::onKeyFrameRequested(){
+	MS2VideoMixer *videoMixer = getVideoMixer();
+	if (mRouted && videoMixer)
+		videoMixer->getRouter()->requestKeyFrame(this);
+}
+
 void MS2VideoStream::oglRender(){
 	if (mStream && mStream->output && (ms_filter_get_id(mStream->output) == MS_OGL_ID))
 		ms_filter_call_method(mStream->output, MS_OGL_RENDER, nullptr);
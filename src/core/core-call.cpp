@@ -252,6 +252,16 @@ unsigned int Core::getCallCount () const {
 	return static_cast<unsigned int>(d->calls.size());
 }
 
+const RtpPortPool &Core::getRtpPortPool () const {
+	L_D();
+	return *d->rtpPortPool;
+}
+
+const MediaTickerPool *Core::getMediaTickerPool () const {
+	L_D();
+	return d->mediaTickerPool.get();
+}
+
 shared_ptr<Call> Core::getCurrentCall () const {
 	L_D();
 	return d->currentCall;
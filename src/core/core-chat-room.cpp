@@ -235,6 +235,21 @@ shared_ptr<AbstractChatRoom> CorePrivate::createBasicChatRoom (
 }
 
 shared_ptr<AbstractChatRoom> CorePrivate::searchChatRoom (const shared_ptr<ChatRoomParams> &params, const IdentityAddress &localAddress, const IdentityAddress &remoteAddress, const std::list<IdentityAddress> &participants) const {
+	// Build only the deferred chat rooms which may match: basic ones through their addresses, left group ones
+	// when a conference chat room may be returned.
+	if (!lazyChatRooms.empty()) {
+		if (!params || !params->isGroup()) {
+			if (remoteAddress.isValid())
+				materializeOneToOneChatRooms(getOneToOneChatRoomKey(localAddress, remoteAddress));
+			else if (!participants.empty())
+				materializeOneToOneChatRooms(getOneToOneChatRoomKey(localAddress, participants.front()));
+			else
+				materializeAllChatRooms();
+		}
+		if (!params || params->isGroup())
+			materializeLeftConferenceChatRooms(localAddress, remoteAddress);
+	}
+
 	for (auto it = chatRoomsById.begin(); it != chatRoomsById.end(); it++) {
 		const auto &chatRoom = it->second;
 		const IdentityAddress &curLocalAddress = chatRoom->getLocalAddress();
@@ -419,7 +434,10 @@ void CorePrivate::insertChatRoom (const shared_ptr<AbstractChatRoom> &chatRoom)
 		// Remove chat room from workaround cache.
 		noCreatedClientGroupChatRooms.erase(chatRoom.get());
 		lInfo() << "Insert chat room " << conferenceId << " to core map";
+		// A chat room created with the ID of a deferred one replaces it.
+		removeLazyChatRoom(conferenceId);
 		chatRoomsById[conferenceId] = chatRoom;
+		indexChatRoom(chatRoom, conferenceId);
 	}
 }
 
@@ -430,15 +448,31 @@ void CorePrivate::insertChatRoomWithDb (const shared_ptr<AbstractChatRoom> &chat
 
 void CorePrivate::loadChatRooms () {
 	chatRoomsById.clear();
+	clearChatRoomIndexes();
 #ifdef HAVE_ADVANCED_IM
 	if (remoteListEventHandler)
 		remoteListEventHandler->clearHandlers();
 #endif
 
+	clearLazyChatRooms();
+
 	if (!mainDb->isInitialized()) return;
-	for (auto &chatRoom : mainDb->getChatRooms()) {
+
+	L_Q();
+	bool lazyLoading = !!linphone_config_get_int(linphone_core_get_config(q->getCCore()), "misc", "lazy_chat_room_loading", 0);
+	uint64_t startTime = bctbx_get_cur_time_ms();
+
+	list<MainDb::ChatRoomDescriptor> descriptors;
+	size_t chatRoomsCount = 0;
+	for (auto &chatRoom : mainDb->getChatRooms(lazyLoading ? &descriptors : nullptr)) {
 		insertChatRoom(chatRoom);
+		chatRoomsCount++;
 	}
+	for (auto &descriptor : descriptors)
+		addLazyChatRoom(move(descriptor));
+
+	lInfo() << "Loaded " << chatRoomsCount << " chat rooms and deferred " << lazyChatRooms.size()
+		<< " in " << (bctbx_get_cur_time_ms() - startTime) << "ms.";
 	sendDeliveryNotifications();
 }
 
@@ -536,12 +570,16 @@ void CorePrivate::replaceChatRoom (const shared_ptr<AbstractChatRoom> &replacedC
 	const ConferenceId &replacedConferenceId = replacedChatRoom->getConferenceId();
 	const ConferenceId &newConferenceId = newChatRoom->getConferenceId();
 
+	unindexChatRoom(replacedChatRoom.get());
+	unindexChatRoom(newChatRoom.get());
 	if (replacedChatRoom->getCapabilities() & ChatRoom::Capabilities::Proxy) {
 		chatRoomsById.erase(replacedConferenceId);
 		chatRoomsById[newConferenceId] = replacedChatRoom;
+		indexChatRoom(replacedChatRoom, newConferenceId);
 	} else {
 		chatRoomsById.erase(replacedConferenceId);
 		chatRoomsById[newConferenceId] = newChatRoom;
+		indexChatRoom(newChatRoom, newConferenceId);
 	}
 }
 
@@ -604,11 +642,227 @@ void CorePrivate::updateChatRoomConferenceId (const shared_ptr<AbstractChatRoom>
 
 	chatRoomsById.erase(oldConferenceId);
 	chatRoomsById[newConferenceId] = chatRoom;
+	unindexChatRoom(chatRoom.get());
+	indexChatRoom(chatRoom, newConferenceId);
 
 	mainDb->updateChatRoomConferenceId(oldConferenceId, newConferenceId);
 #endif
 }
 
+string CorePrivate::getOneToOneChatRoomKey (const IdentityAddress &localAddress, const IdentityAddress &participantAddress) {
+	return localAddress.getAddressWithoutGruu().asString() + " " + participantAddress.getAddressWithoutGruu().asString();
+}
+
+void CorePrivate::indexChatRoom (const shared_ptr<AbstractChatRoom> &chatRoom, const ConferenceId &conferenceId) {
+	ChatRoomIndexKeys &keys = chatRoomIndexKeys[chatRoom.get()];
+	keys.peerAddress = conferenceId.getPeerAddress();
+	chatRoomsByPeerAddress.emplace(keys.peerAddress, chatRoom);
+
+	ChatRoom::CapabilitiesMask capabilities = chatRoom->getCapabilities();
+	if (!(capabilities & ChatRoom::Capabilities::OneToOne))
+		return;
+
+	// Capabilities are checked on lookup: a migrated basic chat room keeps the key of its peer but becomes a conference one.
+	if (!(capabilities & ChatRoom::Capabilities::Conference)) {
+		keys.oneToOneKey = getOneToOneChatRoomKey(chatRoom->getLocalAddress(), chatRoom->getPeerAddress());
+		oneToOneChatRoomsByAddresses.emplace(keys.oneToOneKey, chatRoom);
+	} else if (!chatRoom->getParticipants().empty()) {
+		keys.oneToOneKey = getOneToOneChatRoomKey(chatRoom->getLocalAddress(), chatRoom->getParticipants().front()->getAddress());
+		oneToOneChatRoomsByAddresses.emplace(keys.oneToOneKey, chatRoom);
+	} else {
+		pendingOneToOneChatRooms.push_back(chatRoom);
+	}
+}
+
+void CorePrivate::unindexChatRoom (const AbstractChatRoom *chatRoom) {
+	auto keysIt = chatRoomIndexKeys.find(chatRoom);
+	if (keysIt == chatRoomIndexKeys.end())
+		return;
+
+	const ChatRoomIndexKeys &keys = keysIt->second;
+	auto peerRange = chatRoomsByPeerAddress.equal_range(keys.peerAddress);
+	for (auto it = peerRange.first; it != peerRange.second; it++) {
+		if (it->second.get() == chatRoom) {
+			chatRoomsByPeerAddress.erase(it);
+			break;
+		}
+	}
+
+	if (keys.oneToOneKey.empty()) {
+		pendingOneToOneChatRooms.remove_if([chatRoom] (const shared_ptr<AbstractChatRoom> &pendingChatRoom) {
+			return pendingChatRoom.get() == chatRoom;
+		});
+	} else {
+		auto oneToOneRange = oneToOneChatRoomsByAddresses.equal_range(keys.oneToOneKey);
+		for (auto it = oneToOneRange.first; it != oneToOneRange.second; it++) {
+			if (it->second.get() == chatRoom) {
+				oneToOneChatRoomsByAddresses.erase(it);
+				break;
+			}
+		}
+	}
+	chatRoomIndexKeys.erase(keysIt);
+}
+
+void CorePrivate::reindexOneToOneChatRoom (const ConferenceId &conferenceId) {
+	auto it = chatRoomsById.find(conferenceId);
+	if (it == chatRoomsById.end())
+		return;
+
+	const shared_ptr<AbstractChatRoom> chatRoom = it->second;
+	ChatRoom::CapabilitiesMask capabilities = chatRoom->getCapabilities();
+	if (!(capabilities & ChatRoom::Capabilities::OneToOne) || !(capabilities & ChatRoom::Capabilities::Conference))
+		return;
+
+	unindexChatRoom(chatRoom.get());
+	indexChatRoom(chatRoom, conferenceId);
+}
+
+void CorePrivate::clearChatRoomIndexes () {
+	chatRoomsByPeerAddress.clear();
+	oneToOneChatRoomsByAddresses.clear();
+	pendingOneToOneChatRooms.clear();
+	chatRoomIndexKeys.clear();
+}
+
+void CorePrivate::indexPendingOneToOneChatRooms () const {
+	for (auto it = pendingOneToOneChatRooms.begin(); it != pendingOneToOneChatRooms.end();) {
+		const shared_ptr<AbstractChatRoom> &chatRoom = *it;
+		if (chatRoom->getParticipants().empty()) {
+			it++;
+			continue;
+		}
+
+		string key = getOneToOneChatRoomKey(chatRoom->getLocalAddress(), chatRoom->getParticipants().front()->getAddress());
+		chatRoomIndexKeys[chatRoom.get()].oneToOneKey = key;
+		oneToOneChatRoomsByAddresses.emplace(key, chatRoom);
+		it = pendingOneToOneChatRooms.erase(it);
+	}
+}
+
+void CorePrivate::addLazyChatRoom (MainDb::ChatRoomDescriptor &&descriptor) {
+	const ConferenceId conferenceId = descriptor.conferenceId;
+	if (descriptor.capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Basic))
+		lazyOneToOneChatRooms.emplace(getOneToOneChatRoomKey(conferenceId.getLocalAddress(), conferenceId.getPeerAddress()), conferenceId);
+	lazyChatRoomsByPeerAddress.emplace(conferenceId.getPeerAddress(), conferenceId);
+	lazyChatRooms.emplace(conferenceId, move(descriptor));
+}
+
+bool CorePrivate::removeLazyChatRoom (const ConferenceId &conferenceId, MainDb::ChatRoomDescriptor *descriptor) const {
+	auto it = lazyChatRooms.find(conferenceId);
+	if (it == lazyChatRooms.end())
+		return false;
+
+	if (it->second.capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Basic)) {
+		auto range = lazyOneToOneChatRooms.equal_range(getOneToOneChatRoomKey(conferenceId.getLocalAddress(), conferenceId.getPeerAddress()));
+		for (auto keyIt = range.first; keyIt != range.second; keyIt++) {
+			if (keyIt->second == conferenceId) {
+				lazyOneToOneChatRooms.erase(keyIt);
+				break;
+			}
+		}
+	}
+	auto range = lazyChatRoomsByPeerAddress.equal_range(conferenceId.getPeerAddress());
+	for (auto peerIt = range.first; peerIt != range.second; peerIt++) {
+		if (peerIt->second == conferenceId) {
+			lazyChatRoomsByPeerAddress.erase(peerIt);
+			break;
+		}
+	}
+
+	if (descriptor)
+		*descriptor = move(it->second);
+	lazyChatRooms.erase(it);
+	return true;
+}
+
+shared_ptr<AbstractChatRoom> CorePrivate::materializeChatRoom (const ConferenceId &conferenceId) const {
+	MainDb::ChatRoomDescriptor descriptor;
+	if (!removeLazyChatRoom(conferenceId, &descriptor))
+		return nullptr;
+
+	shared_ptr<AbstractChatRoom> chatRoom = mainDb->buildChatRoom(descriptor);
+	if (!chatRoom)
+		return nullptr;
+
+	lInfo() << "Chat room " << conferenceId << " loaded on demand.";
+	const_cast<CorePrivate *>(this)->insertChatRoom(chatRoom);
+	return chatRoom;
+}
+
+void CorePrivate::materializeOneToOneChatRooms (const string &oneToOneKey) const {
+	auto range = lazyOneToOneChatRooms.equal_range(oneToOneKey);
+	list<ConferenceId> conferenceIds;
+	for (auto it = range.first; it != range.second; it++)
+		conferenceIds.push_back(it->second);
+	for (const auto &conferenceId : conferenceIds)
+		materializeChatRoom(conferenceId);
+}
+
+void CorePrivate::materializeChatRooms (const IdentityAddress &peerAddress) const {
+	auto range = lazyChatRoomsByPeerAddress.equal_range(peerAddress);
+	list<ConferenceId> conferenceIds;
+	for (auto it = range.first; it != range.second; it++)
+		conferenceIds.push_back(it->second);
+	for (const auto &conferenceId : conferenceIds)
+		materializeChatRoom(conferenceId);
+}
+
+void CorePrivate::materializeLeftConferenceChatRooms (const IdentityAddress &localAddress, const IdentityAddress &peerAddress) const {
+	if (peerAddress.isValid()) {
+		auto range = lazyChatRoomsByPeerAddress.equal_range(peerAddress);
+		list<ConferenceId> conferenceIds;
+		for (auto it = range.first; it != range.second; it++)
+			conferenceIds.push_back(it->second);
+		for (const auto &conferenceId : conferenceIds) {
+			auto lazyIt = lazyChatRooms.find(conferenceId);
+			if (
+				lazyIt != lazyChatRooms.end() &&
+				(lazyIt->second.capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference))
+			)
+				materializeChatRoom(conferenceId);
+		}
+		return;
+	}
+
+	// Without the conference address, the participants of the chat rooms have to be known.
+	const IdentityAddress localAddressWithoutGruu = localAddress.getAddressWithoutGruu();
+	list<ConferenceId> conferenceIds;
+	for (const auto &lazyChatRoom : lazyChatRooms) {
+		if (
+			(lazyChatRoom.second.capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference)) &&
+			lazyChatRoom.first.getLocalAddress().getAddressWithoutGruu() == localAddressWithoutGruu
+		)
+			conferenceIds.push_back(lazyChatRoom.first);
+	}
+	for (const auto &conferenceId : conferenceIds)
+		materializeChatRoom(conferenceId);
+}
+
+void CorePrivate::materializeAllChatRooms () const {
+	if (lazyChatRooms.empty())
+		return;
+
+	DurationLogger durationLogger("Load " + Utils::toString(lazyChatRooms.size()) + " deferred chat rooms.");
+	list<ConferenceId> conferenceIds;
+	for (const auto &lazyChatRoom : lazyChatRooms)
+		conferenceIds.push_back(lazyChatRoom.first);
+	for (const auto &conferenceId : conferenceIds)
+		materializeChatRoom(conferenceId);
+}
+
+void CorePrivate::clearLazyChatRooms () {
+	lazyChatRooms.clear();
+	lazyOneToOneChatRooms.clear();
+	lazyChatRoomsByPeerAddress.clear();
+}
+
+void CorePrivate::setLazyChatRoomUnreadCount (const ConferenceId &conferenceId, int count) {
+	auto it = lazyChatRooms.find(conferenceId);
+	if (it != lazyChatRooms.end())
+		it->second.unreadChatMessageCount = count;
+}
+
 // -----------------------------------------------------------------------------
 
 static bool compare_chat_room (const shared_ptr<AbstractChatRoom>& first, const shared_ptr<AbstractChatRoom>& second) {
@@ -641,6 +895,8 @@ list<shared_ptr<AbstractChatRoom>> Core::getChatRooms () const {
 	bool hideEmptyChatRooms = !!linphone_config_get_int(config, "misc", "hide_empty_chat_rooms", 1);
 	bool hideChatRoomsFromRemovedProxyConfig = !!linphone_config_get_int(config, "misc", "hide_chat_rooms_from_removed_proxies", 1);
 
+	d->materializeAllChatRooms();
+
 	list<shared_ptr<AbstractChatRoom>> rooms;
 	for (auto it = d->chatRoomsById.begin(); it != d->chatRoomsById.end(); it++) {
 		const auto &chatRoom = it->second;
@@ -682,6 +938,10 @@ shared_ptr<AbstractChatRoom> Core::findChatRoom (const ConferenceId &conferenceI
 		return it->second;
 	}
 
+	shared_ptr<AbstractChatRoom> lazyChatRoom = d->materializeChatRoom(conferenceId);
+	if (lazyChatRoom)
+		return lazyChatRoom;
+
 	auto alreadyExhumedOneToOne = d->findExumedChatRoomFromPreviousConferenceId(conferenceId);
 	if (alreadyExhumedOneToOne) {
 		lWarning() << "Found conference id as already exhumed chat room with new conference ID " << alreadyExhumedOneToOne->getConferenceId() << ".";
@@ -697,8 +957,11 @@ shared_ptr<AbstractChatRoom> Core::findChatRoom (const ConferenceId &conferenceI
 list<shared_ptr<AbstractChatRoom>> Core::findChatRooms (const IdentityAddress &peerAddress) const {
 	L_D();
 
+	d->materializeChatRooms(peerAddress);
+
 	list<shared_ptr<AbstractChatRoom>> output;
-	for (auto it = d->chatRoomsById.begin(); it != d->chatRoomsById.end(); it++) {
+	auto range = d->chatRoomsByPeerAddress.equal_range(peerAddress);
+	for (auto it = range.first; it != range.second; it++) {
 		const auto &chatRoom = it->second;
 		if (chatRoom->getPeerAddress() == peerAddress) {
 			output.push_front(chatRoom);
@@ -716,7 +979,15 @@ shared_ptr<AbstractChatRoom> Core::findOneToOneChatRoom (
 	bool encrypted
 ) const {
 	L_D();
-	for (auto it = d->chatRoomsById.begin(); it != d->chatRoomsById.end(); it++) {
+	d->indexPendingOneToOneChatRooms();
+
+	const string key = CorePrivate::getOneToOneChatRoomKey(localAddress, participantAddress);
+	if (!conferenceOnly)
+		d->materializeOneToOneChatRooms(key);
+
+	// Only the chat rooms sharing the addresses without gruu can match, check them as before.
+	auto range = d->oneToOneChatRoomsByAddresses.equal_range(key);
+	for (auto it = range.first; it != range.second; it++) {
 		const auto &chatRoom = it->second;
 		const IdentityAddress &curLocalAddress = chatRoom->getLocalAddress();
 		ChatRoom::CapabilitiesMask capabilities = chatRoom->getCapabilities();
@@ -816,6 +1087,7 @@ void Core::deleteChatRoom (const shared_ptr<const AbstractChatRoom> &chatRoom) {
 	d->noCreatedClientGroupChatRooms.erase(chatRoom.get());
 	auto chatRoomsByIdIt = d->chatRoomsById.find(conferenceId);
 	if (chatRoomsByIdIt != d->chatRoomsById.end()) {
+		d->unindexChatRoom(chatRoomsByIdIt->second.get());
 		d->chatRoomsById.erase(chatRoomsByIdIt);
 		if (d->mainDb->isInitialized()) d->mainDb->deleteChatRoom(conferenceId);
 	} else {
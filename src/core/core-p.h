@@ -30,6 +30,8 @@
 #include "object/object-p.h"
 #include "sal/call-op.h"
 #include "auth-info/auth-stack.h"
+#include "conference/session/media-ticker-pool.h"
+#include "conference/session/rtp-port-pool.h"
 #include "conference/session/tone-manager.h"
 #include "utils/background-task.h"
 #include "call/audio-device/audio-device.h"
@@ -40,6 +42,7 @@ LINPHONE_BEGIN_NAMESPACE
 
 class CoreListener;
 class EncryptionEngine;
+class ImdnScheduler;
 class LocalConferenceListEventHandler;
 class RemoteConferenceListEventHandler;
 
@@ -91,6 +94,8 @@ public:
 	std::shared_ptr<AbstractChatRoom> createBasicChatRoom (const ConferenceId &conferenceId, AbstractChatRoom::CapabilitiesMask capabilities, const std::shared_ptr<ChatRoomParams> &params);
 
 	std::shared_ptr<ToneManager> getToneManager();
+	// Null unless [misc] shared_media_tickers is enabled.
+	std::shared_ptr<MediaTickerPool> getMediaTickerPool();
 
 	//Base
 	std::shared_ptr<AbstractChatRoom> createClientGroupChatRoom (
@@ -137,6 +142,11 @@ public:
 	void replaceChatRoom (const std::shared_ptr<AbstractChatRoom> &replacedChatRoom, const std::shared_ptr<AbstractChatRoom> &newChatRoom);
 
 	void updateChatRoomConferenceId (const std::shared_ptr<AbstractChatRoom> &chatRoom, ConferenceId newConferenceId);
+	// The key of a one to one conference chat room depends on its participant, it is recomputed when they change.
+	void reindexOneToOneChatRoom (const ConferenceId &conferenceId);
+	// Used by MainDb on the chat rooms which may be deferred by lazy loading.
+	bool removeLazyChatRoom (const ConferenceId &conferenceId, MainDb::ChatRoomDescriptor *descriptor = nullptr) const;
+	void setLazyChatRoomUnreadCount (const ConferenceId &conferenceId, int count);
 	std::shared_ptr<AbstractChatRoom> findExhumableOneToOneChatRoom (
 		const IdentityAddress &localAddress,
 		const IdentityAddress &participantAddress,
@@ -147,6 +157,7 @@ public:
 	belle_sip_main_loop_t *getMainLoop();
 	bool basicToFlexisipChatroomMigrationEnabled()const;
 	std::unique_ptr<MainDb> mainDb;
+	std::unique_ptr<ImdnScheduler> imdnScheduler;
 #ifdef HAVE_ADVANCED_IM
 	std::unique_ptr<RemoteConferenceListEventHandler> remoteListEventHandler;
 	std::unique_ptr<LocalConferenceListEventHandler> localListEventHandler;
@@ -181,12 +192,48 @@ private:
 
 	std::unordered_map<ConferenceId, std::shared_ptr<AbstractChatRoom>> chatRoomsById;
 
+	// Secondary indexes of chatRoomsById, updated by indexChatRoom() and unindexChatRoom().
+	struct ChatRoomIndexKeys {
+		IdentityAddress peerAddress;
+		std::string oneToOneKey; // Empty if the chat room is not in oneToOneChatRoomsByAddresses.
+	};
+	void indexChatRoom (const std::shared_ptr<AbstractChatRoom> &chatRoom, const ConferenceId &conferenceId);
+	void unindexChatRoom (const AbstractChatRoom *chatRoom);
+	void clearChatRoomIndexes ();
+	void indexPendingOneToOneChatRooms () const;
+	static std::string getOneToOneChatRoomKey (const IdentityAddress &localAddress, const IdentityAddress &participantAddress);
+
+	std::unordered_multimap<IdentityAddress, std::shared_ptr<AbstractChatRoom>> chatRoomsByPeerAddress;
+	// One to one chat rooms by local address and participant address (both without gruu).
+	mutable std::unordered_multimap<std::string, std::shared_ptr<AbstractChatRoom>> oneToOneChatRoomsByAddresses;
+	// One to one conference chat rooms whose participant is not known yet, they are indexed once it is.
+	mutable std::list<std::shared_ptr<AbstractChatRoom>> pendingOneToOneChatRooms;
+	mutable std::unordered_map<const AbstractChatRoom *, ChatRoomIndexKeys> chatRoomIndexKeys;
+
+	// Chat rooms left in database by loadChatRooms() when lazy loading is enabled, they are built on first access.
+	void addLazyChatRoom (MainDb::ChatRoomDescriptor &&descriptor);
+	std::shared_ptr<AbstractChatRoom> materializeChatRoom (const ConferenceId &conferenceId) const;
+	void materializeOneToOneChatRooms (const std::string &oneToOneKey) const;
+	void materializeChatRooms (const IdentityAddress &peerAddress) const;
+	void materializeLeftConferenceChatRooms (const IdentityAddress &localAddress, const IdentityAddress &peerAddress) const;
+	void materializeAllChatRooms () const;
+	void clearLazyChatRooms ();
+
+	mutable std::unordered_map<ConferenceId, MainDb::ChatRoomDescriptor> lazyChatRooms;
+	// Lazy basic chat rooms by the key of oneToOneChatRoomsByAddresses.
+	mutable std::unordered_multimap<std::string, ConferenceId> lazyOneToOneChatRooms;
+	mutable std::unordered_multimap<IdentityAddress, ConferenceId> lazyChatRoomsByPeerAddress;
+
 	std::unique_ptr<EncryptionEngine> imee;
 
 	std::list<std::string> specs;
 
 	std::shared_ptr<ToneManager> toneManager;
 
+	// Shared with the streams, that release their ports when they are destroyed.
+	std::shared_ptr<RtpPortPool> rtpPortPool = std::make_shared<RtpPortPool>();
+	std::shared_ptr<MediaTickerPool> mediaTickerPool;
+
 	// This is to keep a ref on a clientGroupChatRoom while it is being created
 	// Otherwise the chatRoom will be freed() before it is inserted
 	std::unordered_map<const AbstractChatRoom *, std::shared_ptr<const AbstractChatRoom>> noCreatedClientGroupChatRooms;
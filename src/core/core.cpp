@@ -38,6 +38,7 @@
 #include "address/address.h"
 #include "call/call.h"
 #include "chat/encryption/encryption-engine.h"
+#include "chat/notification/imdn-scheduler.h"
 #ifdef HAVE_LIME_X3DH
 #include "chat/encryption/lime-x3dh-encryption-engine.h"
 #endif
@@ -83,6 +84,7 @@ void CorePrivate::init () {
 	L_Q();
 
 	mainDb.reset(new MainDb(q->getSharedFromThis()));
+	imdnScheduler = makeUnique<ImdnScheduler>(q->getSharedFromThis());
 #ifdef HAVE_ADVANCED_IM
 	remoteListEventHandler = makeUnique<RemoteConferenceListEventHandler>(q->getSharedFromThis());
 	localListEventHandler = makeUnique<LocalConferenceListEventHandler>(q->getSharedFromThis());
@@ -301,6 +303,8 @@ void CorePrivate::uninit() {
 	}
 
 	chatRoomsById.clear();
+	clearChatRoomIndexes();
+	clearLazyChatRooms();
 
 	for (const auto &audioVideoConference : q->audioVideoConferenceById) {
 		// Terminate audio video conferences just before core is stopped
@@ -318,8 +322,14 @@ void CorePrivate::uninit() {
 	localListEventHandler.reset();
 #endif
 
+	if (imdnScheduler) {
+		imdnScheduler->flushPendingWrites();
+		imdnScheduler.reset();
+	}
+
 	Address::clearSipAddressesCache();
 	if (mainDb != nullptr) {
+		mainDb->flushPendingWrites();
 		mainDb->disconnect();
 	}
 }
@@ -447,6 +457,21 @@ std::shared_ptr<ToneManager> CorePrivate::getToneManager() {
 	return toneManager;
 }
 
+shared_ptr<MediaTickerPool> CorePrivate::getMediaTickerPool () {
+	L_Q();
+	LinphoneConfig *config = linphone_core_get_config(q->getCCore());
+	if (!linphone_config_get_bool(config, "misc", "shared_media_tickers", FALSE))
+		return nullptr;
+	if (!mediaTickerPool) {
+		int size = linphone_config_get_int(config, "misc", "shared_media_tickers_count", 0);
+		if (size <= 0)
+			size = static_cast<int>(ms_factory_get_cpu_count(q->getCCore()->factory));
+		lInfo() << "Streams are scheduled on a pool of " << size << " shared media tickers per media type";
+		mediaTickerPool = make_shared<MediaTickerPool>(static_cast<unsigned int>(size));
+	}
+	return mediaTickerPool;
+}
+
 int CorePrivate::ephemeralMessageTimerExpired (void *data, unsigned int revents) {
 	CorePrivate *d = static_cast<CorePrivate *>(data);
 	d->stopEphemeralMessageTimer();
@@ -712,6 +737,15 @@ bool Core::limeX3dhAvailable() const {
 #endif
 }
 
+// -----------------------------------------------------------------------------
+// IMDN.
+// -----------------------------------------------------------------------------
+
+ImdnScheduler *Core::getImdnScheduler () const {
+	L_D();
+	return d->imdnScheduler.get();
+}
+
 // -----------------------------------------------------------------------------
 // Specs.
 // -----------------------------------------------------------------------------
@@ -1181,6 +1215,11 @@ int Core::getUnreadChatMessageCount (const IdentityAddress &localAddress) const
 		if (addressToCompare.weakEqual(chatRoom->getLocalAddress().asAddress()))
 			count += chatRoom->getUnreadChatMessageCount();
 	}
+	// Deferred chat rooms are not built to be counted, their descriptors hold their unread count.
+	for (const auto &lazyChatRoom : d->lazyChatRooms) {
+		if (addressToCompare.weakEqual(lazyChatRoom.first.getLocalAddress().asAddress()))
+			count += lazyChatRoom.second.unreadChatMessageCount;
+	}
 	return count;
 }
 
@@ -1198,6 +1237,15 @@ int Core::getUnreadChatMessageCountFromActiveLocals () const {
 			}
 		}
 	}
+	for (const auto &lazyChatRoom : d->lazyChatRooms) {
+		for (auto it = linphone_core_get_proxy_config_list(getCCore()); it != NULL; it = it->next) {
+			LinphoneProxyConfig *cfg = (LinphoneProxyConfig *)it->data;
+			const LinphoneAddress *identityAddr = linphone_proxy_config_get_identity_address(cfg);
+			if (L_GET_CPP_PTR_FROM_C_OBJECT(identityAddr)->weakEqual(lazyChatRoom.first.getLocalAddress().asAddress())) {
+				count += lazyChatRoom.second.unreadChatMessageCount;
+			}
+		}
+	}
 	return count;
 }
 
@@ -50,6 +50,9 @@ class ConferenceParams;
 class CorePrivate;
 class IdentityAddress;
 class EncryptionEngine;
+class ImdnScheduler;
+class MediaTickerPool;
+class RtpPortPool;
 class ChatMessage;
 class ChatRoom;
 class PushNotificationMessage;
@@ -124,6 +127,10 @@ public:
 	const std::list<std::shared_ptr<Call>> &getCalls () const;
 	unsigned int getCallCount () const;
 	std::shared_ptr<Call> getCurrentCall () const;
+	// RTP/RTCP ports used by the streams of the calls, with their occupancy statistics.
+	const RtpPortPool &getRtpPortPool () const;
+	// Tickers running the media streams when [misc] shared_media_tickers is enabled, null otherwise.
+	const MediaTickerPool *getMediaTickerPool () const;
 	LinphoneStatus pauseAllCalls ();
 	void soundcardActivateAudioSession (bool active);
 	void soundcardConfigureAudioSession ();
@@ -197,6 +204,13 @@ public:
 	bool limeX3dhEnabled () const;
 	bool limeX3dhAvailable () const;
 
+	// ---------------------------------------------------------------------------
+	// IMDN.
+	// ---------------------------------------------------------------------------
+
+	// Null while the core is not started.
+	ImdnScheduler *getImdnScheduler () const;
+
 	// ---------------------------------------------------------------------------
 	// Specs.
 	// ---------------------------------------------------------------------------
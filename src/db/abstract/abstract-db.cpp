@@ -112,6 +112,9 @@ bool AbstractDb::forceReconnect () {
 	constexpr int retryCount = 2;
 	lInfo() << "Trying sql backend reconnect...";
 
+	// Prepared statements belong to the connection being closed.
+	d->dbSession.clearPreparedStatements();
+
 	try {
 		for (int i = 0; i < retryCount; ++i) {
 			try {
@@ -30,20 +30,28 @@
 
 #define L_DB_TRANSACTION L_DB_TRANSACTION_C(this)
 
+// Transaction whose commit may be delayed and grouped with others when the write-behind mode is enabled.
+#define L_DB_WRITE_BEHIND_TRANSACTION \
+	LinphonePrivate::DbTransactionInfo().set(__func__, this, true) * [&](SmartTransaction &tr)
+
 LINPHONE_BEGIN_NAMESPACE
 
 class SmartTransaction {
 public:
-	SmartTransaction (soci::session *session, const char *name) :
-	mSession(session), mName(name), mIsCommitted(false) {
+	SmartTransaction (MainDbPrivate *mainDb, const char *name, bool writeBehind = false) :
+	mMainDb(mainDb), mName(name), mIsCommitted(false) {
 		lDebug() << "Start transaction " << this << " in MainDb::" << mName << ".";
-		mSession->begin();
+		mMainDb->beginTransaction(writeBehind);
 	}
 
 	~SmartTransaction () {
 		if (!mIsCommitted) {
 			lDebug() << "Rollback transaction " << this << " in MainDb::" << mName << ".";
-			mSession->rollback();
+			try {
+				mMainDb->rollbackTransaction();
+			} catch (const std::exception &e) {
+				lError() << "Unable to rollback transaction " << this << " in MainDb::" << mName << ": `" << e.what() << "`.";
+			}
 		}
 	}
 
@@ -55,11 +63,11 @@ public:
 
 		lDebug() << "Commit transaction " << this << " in MainDb::" << mName << ".";
 		mIsCommitted = true;
-		mSession->commit();
+		mMainDb->commitTransaction();
 	}
 
 private:
-	soci::session *mSession;
+	MainDbPrivate *mMainDb;
 	const char *mName;
 	bool mIsCommitted;
 
@@ -67,14 +75,16 @@ private:
 };
 
 struct DbTransactionInfo {
-	DbTransactionInfo &set (const char *_name, const MainDb *_mainDb) {
+	DbTransactionInfo &set (const char *_name, const MainDb *_mainDb, bool _writeBehind = false) {
 		name = _name;
 		mainDb = const_cast<MainDb *>(_mainDb);
+		writeBehind = _writeBehind;
 		return *this;
 	}
 
 	const char *name = nullptr;
 	MainDb *mainDb = nullptr;
+	bool writeBehind = false;
 };
 
 template<typename Function>
@@ -93,10 +103,11 @@ public:
 	DbTransaction (DbTransactionInfo &info, Function &&function) : mFunction(std::move(function)) {
 		MainDb *mainDb = info.mainDb;
 		const char *name = info.name;
-		soci::session *session = mainDb->getPrivate()->dbSession.getBackendSession();
+		const bool writeBehind = info.writeBehind;
+		MainDbPrivate *d = mainDb->getPrivate();
 
 		try {
-			SmartTransaction tr(session, name);
+			SmartTransaction tr(d, name, writeBehind);
 			mResult = exec<InternalReturnType>(tr);
 		} catch (const soci::soci_error &e) {
 			lWarning() << "Caught exception in MainDb::" << name << "(" << e.what() << ").";
@@ -106,7 +117,7 @@ public:
 				mainDb->forceReconnect()
 			) {
 				try {
-					SmartTransaction tr(session, name);
+					SmartTransaction tr(d, name, writeBehind);
 					mResult = exec<InternalReturnType>(tr);
 				} catch (const std::exception &e) {
 					lError() << "Unable to execute query after reconnect in MainDb::" << name << "(" << e.what() << ").";
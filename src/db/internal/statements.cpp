@@ -109,6 +109,20 @@ namespace Statements {
 			LEFT JOIN sip_address AS participant_sip_address ON participant_sip_address.id = participant_sip_address_id
 			LEFT JOIN sip_address AS reply_sender_address ON reply_sender_address.id = reply_sender_address_id
 			WHERE chat_room_id = :1
+		)",
+
+		/* SelectUnreadChatMessageCount */ R"(
+			SELECT COUNT(*)
+			FROM conference_chat_message_event
+			WHERE marked_as_read == 0
+		)",
+
+		/* SelectChatRoomUnreadChatMessageCount */ R"(
+			SELECT COUNT(*)
+			FROM conference_chat_message_event
+			WHERE event_id IN (
+				SELECT event_id FROM conference_event WHERE chat_room_id = :1
+			) AND marked_as_read == 0
 		)"
 	};
 
@@ -34,6 +34,8 @@ namespace Statements {
 		SelectOneToOneChatRoomId,
 		SelectConferenceEvent,
 		SelectConferenceEvents,
+		SelectUnreadChatMessageCount,
+		SelectChatRoomUnreadChatMessageCount,
 		SelectCount
 	};
 
@@ -22,6 +22,8 @@
 
 #include <unordered_map>
 
+#include <belle-sip/types.h>
+
 #include "linphone/utils/utils.h"
 
 #include "abstract/abstract-db-p.h"
@@ -41,6 +43,14 @@ public:
 	mutable std::unordered_map<long long, std::weak_ptr<ChatMessage>> storageIdToChatMessage;
 	mutable std::unordered_map<long long, ConferenceId> storageIdToConferenceId;
 
+	// ---------------------------------------------------------------------------
+	// Transactions API, used by SmartTransaction.
+	// ---------------------------------------------------------------------------
+
+	void beginTransaction (bool writeBehind);
+	void commitTransaction ();
+	void rollbackTransaction ();
+
 private:
 	// ---------------------------------------------------------------------------
 	// Misc helpers.
@@ -48,6 +58,7 @@ private:
 
 	std::shared_ptr<AbstractChatRoom> findChatRoom (const ConferenceId &conferenceId) const;
 	std::shared_ptr<MediaConference::Conference> findAudioVideoConference (const ConferenceId &conferenceId) const;
+	std::shared_ptr<AbstractChatRoom> buildChatRoom (const MainDb::ChatRoomDescriptor &descriptor) const;
 
 
 	// ---------------------------------------------------------------------------
@@ -200,6 +211,49 @@ private:
 
 	void invalidConferenceEventsFromQuery (const std::string &query, long long chatRoomId);
 
+	// ---------------------------------------------------------------------------
+	// Chat messages API.
+	// ---------------------------------------------------------------------------
+
+	// Fetch the contents of several chat messages with a few set-based queries.
+	// The chat messages must not be read-only.
+	void fetchChatMessagesContents (const std::list<std::shared_ptr<ChatMessage>> &chatMessages) const;
+
+	// Load in one pass the contents of the chat messages of a history page which are not loaded yet.
+	void loadChatMessagesContents (const std::list<std::shared_ptr<EventLog>> &events) const;
+
+	// ---------------------------------------------------------------------------
+	// Write-behind.
+	// ---------------------------------------------------------------------------
+
+	// In write-behind mode, the transactions of MainDb are savepoints of a group transaction.
+	// Only addEvent, updateEvent and setChatMessageParticipantState may leave their writes pending:
+	// the group is committed after writeBehindMaxPendingWrites of them, writeBehindDelayMs or any other write.
+	// Reads on the session see the pending writes, so caches stay consistent.
+	// A group whose commit fails stays opened and is committed again on the next flush, up to
+	// MaxWriteBehindCommitRetries times; it is then rolled back, its writes are reported as lost and
+	// the events it inserted lose their storage ids.
+	bool flushPendingWrites ();
+	void dropPendingWrites ();
+	void resetWriteBehind ();
+	void startWriteBehindTimer ();
+
+	static constexpr unsigned int MaxWriteBehindCommitRetries = 3;
+	static constexpr unsigned int WriteBehindFlushRetryDelayMs = 50;
+
+	bool writeBehindEnabled = false;
+	unsigned int writeBehindMaxPendingWrites = 0;
+	unsigned int writeBehindDelayMs = 0;
+
+	bool groupTransactionOpened = false;
+	int transactionDepth = 0;
+	bool writeBehindTransaction = false;
+	unsigned int pendingWrites = 0;
+	std::vector<long long> pendingEventIds;
+	unsigned int commitRetries = 0;
+	belle_sip_source_t *writeBehindTimer = nullptr;
+	MainDb::WriteBehindStats writeBehindStats;
+
 	// ---------------------------------------------------------------------------
 	// Versions.
 	// ---------------------------------------------------------------------------
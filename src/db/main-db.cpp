@@ -23,6 +23,7 @@
 #endif
 
 #include <ctime>
+#include <thread>
 
 #include "linphone/utils/algorithm.h"
 #include "linphone/utils/static-string.h"
@@ -62,7 +63,7 @@ LINPHONE_BEGIN_NAMESPACE
 
 #ifdef HAVE_DB_STORAGE
 namespace {
-	constexpr unsigned int ModuleVersionEvents = makeVersion(1, 0, 16);
+	constexpr unsigned int ModuleVersionEvents = makeVersion(1, 0, 17);
 	constexpr unsigned int ModuleVersionFriends = makeVersion(1, 0, 0);
 	constexpr unsigned int ModuleVersionLegacyFriendsImport = makeVersion(1, 0, 0);
 	constexpr unsigned int ModuleVersionLegacyHistoryImport = makeVersion(1, 0, 0);
@@ -511,11 +512,10 @@ long long MainDbPrivate::selectSipAddressId (const string &sipAddress) const {
 #ifdef HAVE_DB_STORAGE
 	long long sipAddressId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectSipAddressId),
-		soci::use(sipAddress), soci::into(sipAddressId);
-
-	return session->got_data() ? sipAddressId : -1;
+	return dbSession.executePreparedStatement(
+		Statements::SelectSipAddressId, Statements::get(Statements::SelectSipAddressId),
+		soci::use(sipAddress), soci::into(sipAddressId)
+	) ? sipAddressId : -1;
 #else
 	return -1;
 #endif
@@ -525,11 +525,10 @@ long long MainDbPrivate::selectChatRoomId (long long peerSipAddressId, long long
 #ifdef HAVE_DB_STORAGE
 	long long chatRoomId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectChatRoomId),
-		soci::use(peerSipAddressId), soci::use(localSipAddressId), soci::into(chatRoomId);
-
-	return session->got_data() ? chatRoomId : -1;
+	return dbSession.executePreparedStatement(
+		Statements::SelectChatRoomId, Statements::get(Statements::SelectChatRoomId),
+		soci::use(peerSipAddressId), soci::use(localSipAddressId), soci::into(chatRoomId)
+	) ? chatRoomId : -1;
 #else
 	return -1;
 #endif
@@ -584,11 +583,10 @@ long long MainDbPrivate::selectChatRoomParticipantId (long long chatRoomId, long
 #ifdef HAVE_DB_STORAGE
 	long long chatRoomParticipantId;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectChatRoomParticipantId),
-		soci::use(chatRoomId), soci::use(participantSipAddressId), soci::into(chatRoomParticipantId);
-
-	return session->got_data() ? chatRoomParticipantId : -1;
+	return dbSession.executePreparedStatement(
+		Statements::SelectChatRoomParticipantId, Statements::get(Statements::SelectChatRoomParticipantId),
+		soci::use(chatRoomId), soci::use(participantSipAddressId), soci::into(chatRoomParticipantId)
+	) ? chatRoomParticipantId : -1;
 #else
 	return -1;
 #endif
@@ -600,13 +598,12 @@ long long MainDbPrivate::selectOneToOneChatRoomId (long long sipAddressIdA, long
 	const int encryptedCapability = int(ChatRoom::Capabilities::Encrypted);
 	const int expectedCapabilities = encrypted ? encryptedCapability : 0;
 
-	soci::session *session = dbSession.getBackendSession();
-	*session << Statements::get(Statements::SelectOneToOneChatRoomId),
+	return dbSession.executePreparedStatement(
+		Statements::SelectOneToOneChatRoomId, Statements::get(Statements::SelectOneToOneChatRoomId),
 		soci::use(sipAddressIdA, "1"), soci::use(sipAddressIdB, "2"),
 		soci::use(encryptedCapability, "3"), soci::use(expectedCapabilities, "4"),
-		soci::into(chatRoomId);
-
-	return session->got_data() ? chatRoomId : -1;
+		soci::into(chatRoomId)
+	) ? chatRoomId : -1;
 #else
 	return -1;
 #endif
@@ -1443,6 +1440,356 @@ void MainDbPrivate::invalidConferenceEventsFromQuery (const string &query, long
 #endif
 }
 
+// -----------------------------------------------------------------------------
+// Transactions API.
+// -----------------------------------------------------------------------------
+
+void MainDbPrivate::beginTransaction (bool writeBehind) {
+#ifdef HAVE_DB_STORAGE
+	soci::session *session = dbSession.getBackendSession();
+	if (!writeBehindEnabled) {
+		session->begin();
+		return;
+	}
+
+	if (transactionDepth == 0)
+		writeBehindTransaction = writeBehind;
+	if (!groupTransactionOpened) {
+		session->begin();
+		groupTransactionOpened = true;
+	}
+	// MySQL replaces a savepoint by another one of the same name, so each depth has its own.
+	*session << "SAVEPOINT smart_transaction_" << transactionDepth;
+	transactionDepth++;
+#endif
+}
+
+void MainDbPrivate::commitTransaction () {
+#ifdef HAVE_DB_STORAGE
+	soci::session *session = dbSession.getBackendSession();
+	if (!writeBehindEnabled) {
+		session->commit();
+		return;
+	}
+
+	transactionDepth--;
+	*session << "RELEASE SAVEPOINT smart_transaction_" << transactionDepth;
+	if (transactionDepth > 0)
+		return;
+
+	pendingWrites++;
+	// Only the writes allowed to be delayed wait for the group, the others commit it right away.
+	if (!writeBehindTransaction || pendingWrites >= writeBehindMaxPendingWrites)
+		flushPendingWrites();
+	else
+		startWriteBehindTimer();
+#endif
+}
+
+void MainDbPrivate::rollbackTransaction () {
+#ifdef HAVE_DB_STORAGE
+	soci::session *session = dbSession.getBackendSession();
+	if (!writeBehindEnabled) {
+		session->rollback();
+		return;
+	}
+
+	transactionDepth--;
+	*session << "ROLLBACK TO SAVEPOINT smart_transaction_" << transactionDepth;
+	*session << "RELEASE SAVEPOINT smart_transaction_" << transactionDepth;
+
+	// Do not keep the group transaction opened after a read.
+	if (transactionDepth == 0 && pendingWrites == 0) {
+		groupTransactionOpened = false;
+		session->rollback();
+	}
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Write-behind.
+// -----------------------------------------------------------------------------
+
+bool MainDbPrivate::flushPendingWrites () {
+#ifdef HAVE_DB_STORAGE
+	L_Q();
+
+	if (writeBehindTimer) {
+		q->getCore()->destroyTimer(writeBehindTimer);
+		writeBehindTimer = nullptr;
+	}
+
+	if (!groupTransactionOpened)
+		return true;
+	if (transactionDepth > 0)
+		return false;
+
+	const unsigned int count = pendingWrites;
+	soci::session *session = dbSession.getBackendSession();
+	try {
+		session->commit();
+		lDebug() << "MainDb: " << count << " pending writes committed.";
+		writeBehindStats.committedWrites += count;
+		groupTransactionOpened = false;
+		pendingWrites = 0;
+		pendingEventIds.clear();
+		commitRetries = 0;
+		return true;
+	} catch (const exception &e) {
+		writeBehindStats.failedCommits++;
+		if (commitRetries < MaxWriteBehindCommitRetries) {
+			commitRetries++;
+			lWarning() << "MainDb: unable to commit " << count << " pending writes (`" << e.what() << "`), retry " <<
+				commitRetries << "/" << MaxWriteBehindCommitRetries << " scheduled.";
+			startWriteBehindTimer();
+			return false;
+		}
+		lError() << "MainDb: unable to commit " << count << " pending writes after " << commitRetries <<
+			" retries, they are lost: `" << e.what() << "`.";
+	}
+
+	try {
+		session->rollback();
+	} catch (const exception &) {}
+	dropPendingWrites();
+	return false;
+#else
+	return true;
+#endif
+}
+
+void MainDbPrivate::dropPendingWrites () {
+#ifdef HAVE_DB_STORAGE
+	writeBehindStats.lostWrites += pendingWrites;
+
+	// The events inserted by the group do not exist anymore and their ids may be given to other rows.
+	for (long long eventId : pendingEventIds) {
+		shared_ptr<EventLog> eventLog = getEventFromCache(eventId);
+		if (eventLog)
+			const_cast<EventLogPrivate *>(eventLog->getPrivate())->resetStorageId();
+		shared_ptr<ChatMessage> chatMessage = getChatMessageFromCache(eventId);
+		if (chatMessage)
+			chatMessage->getPrivate()->resetStorageId();
+	}
+
+	// The caches may reference rows which have just been rolled back.
+	storageIdToEvent.clear();
+	storageIdToChatMessage.clear();
+	storageIdToConferenceId.clear();
+	unreadChatMessageCountCache.clear();
+
+	groupTransactionOpened = false;
+	pendingWrites = 0;
+	pendingEventIds.clear();
+	commitRetries = 0;
+#endif
+}
+
+void MainDbPrivate::startWriteBehindTimer () {
+#ifdef HAVE_DB_STORAGE
+	L_Q();
+
+	if (writeBehindTimer)
+		return;
+	writeBehindTimer = q->getCore()->createTimer([this]() {
+		flushPendingWrites();
+		return false;
+	}, writeBehindDelayMs, "MainDb write-behind");
+#endif
+}
+
+void MainDbPrivate::resetWriteBehind () {
+#ifdef HAVE_DB_STORAGE
+	L_Q();
+
+	if (groupTransactionOpened) {
+		if (pendingWrites > 0)
+			lError() << "MainDb: " << pendingWrites << " pending writes lost.";
+		dropPendingWrites();
+	}
+
+	if (writeBehindTimer) {
+		q->getCore()->destroyTimer(writeBehindTimer);
+		writeBehindTimer = nullptr;
+	}
+
+	transactionDepth = 0;
+
+	LinphoneConfig *config = linphone_core_get_config(q->getCore()->getCCore());
+	writeBehindEnabled = !!linphone_config_get_bool(config, "storage", "write_behind_enabled", FALSE);
+	writeBehindMaxPendingWrites = (unsigned int)max(1, linphone_config_get_int(config, "storage", "write_behind_max_pending_writes", 100));
+	writeBehindDelayMs = (unsigned int)max(0, linphone_config_get_int(config, "storage", "write_behind_delay_ms", 500));
+	if (writeBehindEnabled)
+		lInfo() << "MainDb: write-behind enabled (max pending writes: " << writeBehindMaxPendingWrites <<
+			", delay: " << writeBehindDelayMs << "ms).";
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// Chat messages API.
+// -----------------------------------------------------------------------------
+
+#ifdef HAVE_DB_STORAGE
+template<typename T>
+static void fetchContentsAppData (
+	soci::session *session,
+	const string &contentIdsQuery,
+	const unordered_map<long long, Content *> &contents,
+	T &data
+) {
+	const string query = "SELECT chat_message_content_id, name, data FROM chat_message_content_app_data"
+		" WHERE chat_message_content_id IN (" + contentIdsQuery + ")";
+
+	long long contentId;
+	string name;
+	soci::statement statement = (session->prepare << query, soci::into(contentId), soci::into(name), soci::into(data));
+	statement.execute();
+	while (statement.fetch()) {
+		auto it = contents.find(contentId);
+		if (it != contents.cend())
+			it->second->setAppData(name, blobToString(data));
+	}
+}
+#endif
+
+void MainDbPrivate::fetchChatMessagesContents (const list<shared_ptr<ChatMessage>> &chatMessages) const {
+#ifdef HAVE_DB_STORAGE
+	// Keep the IN (...) lists far below the maximum length of a SQL statement.
+	static constexpr size_t MaxChatMessagesPerQuery = 500;
+
+	L_Q();
+
+	soci::session *session = dbSession.getBackendSession();
+
+	auto it = chatMessages.cbegin();
+	while (it != chatMessages.cend()) {
+		unordered_map<long long, shared_ptr<ChatMessage>> chatMessagesById;
+		string eventIds;
+		for (; it != chatMessages.cend() && chatMessagesById.size() < MaxChatMessagesPerQuery; ++it) {
+			const long long &eventId = (*it)->getStorageId();
+			if (!chatMessagesById.emplace(eventId, *it).second)
+				continue;
+			if (!eventIds.empty())
+				eventIds += ",";
+			eventIds += Utils::toString(eventId);
+		}
+
+		const string contentIdsQuery = "SELECT id FROM chat_message_content WHERE event_id IN (" + eventIds + ")";
+
+		// 1 - Fetch contents' file informations if they exist.
+		struct FileInfo {
+			string name;
+			int size;
+			string path;
+			int duration;
+		};
+		unordered_map<long long, FileInfo> fileInfos;
+		{
+			const string query = "SELECT chat_message_content_id, name, size, path, duration FROM chat_message_file_content"
+				" WHERE chat_message_content_id IN (" + contentIdsQuery + ")";
+			soci::rowset<soci::row> rows = (session->prepare << query);
+			for (const auto &row : rows)
+				fileInfos[dbSession.resolveId(row, 0)] = FileInfo{
+					row.get<string>(1), row.get<int>(2), row.get<string>(3), row.get<int>(4)
+				};
+		}
+
+		// 2 - Fetch contents and their types, in insertion order.
+		list<pair<shared_ptr<ChatMessage>, Content *>> contents;
+		unordered_map<long long, Content *> contentsById;
+		{
+			const string query = "SELECT chat_message_content.id, event_id, content_type.value, body, body_encoding_type"
+				" FROM chat_message_content, content_type"
+				" WHERE event_id IN (" + eventIds + ") AND content_type_id = content_type.id"
+				" ORDER BY chat_message_content.id";
+			soci::rowset<soci::row> rows = (session->prepare << query);
+			for (const auto &row : rows) {
+				const long long &contentId = dbSession.resolveId(row, 0);
+				auto chatMessageIt = chatMessagesById.find(dbSession.resolveId(row, 1));
+				if (chatMessageIt == chatMessagesById.cend())
+					continue;
+
+				ContentType contentType(row.get<string>(2));
+				Content *content;
+				if (contentType == ContentType::FileTransfer)
+					content = new FileTransferContent();
+				else {
+					auto fileInfoIt = fileInfos.find(contentId);
+					if (fileInfoIt != fileInfos.cend()) {
+						const FileInfo &fileInfo = fileInfoIt->second;
+						FileContent *fileContent = new FileContent();
+						fileContent->setFileName(fileInfo.name);
+						fileContent->setFileSize(size_t(fileInfo.size));
+						fileContent->setFilePath(fileInfo.path);
+						fileContent->setFileDuration(fileInfo.duration);
+						content = fileContent;
+					} else
+						content = new Content();
+				}
+
+				content->setContentType(contentType);
+				if (row.get<int>(4) == 1)
+					content->setBodyFromUtf8(row.get<string>(3));
+				else
+					content->setBodyFromLocale(row.get<string>(3));
+
+				contents.emplace_back(chatMessageIt->second, content);
+				contentsById[contentId] = content;
+			}
+		}
+
+		if (contents.empty())
+			continue;
+
+		// 3 - Fetch contents' app data.
+		// TODO: Do not test backend, encapsulate!!!
+		if (q->getBackend() == MainDb::Backend::Sqlite3) {
+			soci::blob data(*session);
+			fetchContentsAppData(session, contentIdsQuery, contentsById, data);
+		} else {
+			string data;
+			fetchContentsAppData(session, contentIdsQuery, contentsById, data);
+		}
+
+		// 4 - Fill the chat messages.
+		unordered_map<long long, shared_ptr<ChatMessage>> fileTransferChatMessages;
+		for (const auto &content : contents) {
+			content.first->addContent(content.second);
+			if (content.second->getContentType() == ContentType::FileTransfer)
+				fileTransferChatMessages[content.first->getStorageId()] = content.first;
+		}
+
+		// 5 - Load external body url from body into FileTransferContent if needed.
+		for (const auto &chatMessage : fileTransferChatMessages)
+			chatMessage.second->getPrivate()->loadFileTransferUrlFromBodyToContent();
+	}
+#endif
+}
+
+void MainDbPrivate::loadChatMessagesContents (const list<shared_ptr<EventLog>> &events) const {
+#ifdef HAVE_DB_STORAGE
+	list<shared_ptr<ChatMessage>> chatMessages;
+	for (const auto &event : events) {
+		if (event->getType() != EventLog::Type::ConferenceChatMessage)
+			continue;
+
+		shared_ptr<ChatMessage> chatMessage = static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage();
+		ChatMessagePrivate *dChatMessage = chatMessage->getPrivate();
+		if (dChatMessage->areContentsLoaded())
+			continue;
+
+		dChatMessage->markContentsAsLoaded();
+		dChatMessage->setIsReadOnly(false);
+		chatMessages.push_back(chatMessage);
+	}
+
+	fetchChatMessagesContents(chatMessages);
+
+	for (const auto &chatMessage : chatMessages)
+		chatMessage->getPrivate()->setIsReadOnly(true);
+#endif
+}
+
 // -----------------------------------------------------------------------------
 // Versions.
 // -----------------------------------------------------------------------------
@@ -1637,6 +1984,11 @@ void MainDbPrivate::updateSchema () {
 	if (version < makeVersion(1, 0, 16)) {
 		*session << "ALTER TABLE chat_message_file_content ADD COLUMN duration INT NOT NULL DEFAULT -1";
 	}
+
+	if (version < makeVersion(1, 0, 17)) {
+		// Allows history pagination to seek on (chat_room_id, event_id) instead of scanning all the events of a chat room.
+		*session << "CREATE INDEX conference_event_chat_room_index ON conference_event (chat_room_id, event_id)";
+	}
 #endif
 }
 
@@ -1918,6 +2270,9 @@ void MainDb::init () {
 #ifdef HAVE_DB_STORAGE
 	L_D();
 
+	// Reconnection drops the group transaction, if any.
+	d->resetWriteBehind();
+
 	Backend backend = getBackend();
 
 	const string charset = backend == Mysql ? "DEFAULT CHARSET=utf8mb4" : "";
@@ -2332,7 +2687,7 @@ bool MainDb::addEvent (const shared_ptr<EventLog> &eventLog) {
 		return false;
 	}
 
-	return L_DB_TRANSACTION {
+	return L_DB_WRITE_BEHIND_TRANSACTION {
 		L_D();
 
 		long long eventId = -1;
@@ -2394,6 +2749,8 @@ bool MainDb::addEvent (const shared_ptr<EventLog> &eventLog) {
 		if (eventId >= 0) {
 			tr.commit();
 			d->cache(eventLog, eventId);
+			if (d->groupTransactionOpened)
+				d->pendingEventIds.push_back(eventId);
 
 			if (type == EventLog::Type::ConferenceChatMessage)
 				d->cache(static_pointer_cast<ConferenceChatMessageEvent>(eventLog)->getChatMessage(), eventId);
@@ -2415,7 +2772,7 @@ bool MainDb::updateEvent (const shared_ptr<EventLog> &eventLog) {
 		return false;
 	}
 
-	return L_DB_TRANSACTION {
+	return L_DB_WRITE_BEHIND_TRANSACTION {
 		L_D();
 
 		switch (eventLog->getType()) {
@@ -2655,14 +3012,6 @@ int MainDb::getUnreadChatMessageCount (const ConferenceId &conferenceId) const {
 			return *count;
 	}
 
-	string query = "SELECT COUNT(*) FROM conference_chat_message_event WHERE";
-	if (conferenceId.isValid())
-		query += " event_id IN ("
-			"  SELECT event_id FROM conference_event WHERE chat_room_id = :chatRoomId"
-			") AND";
-
-	query += " marked_as_read == 0 ";
-
 	/*
 	DurationLogger durationLogger(
 		"Get unread chat messages count of: (peer=" + conferenceId.getPeerAddress().asString() +
@@ -2673,13 +3022,17 @@ int MainDb::getUnreadChatMessageCount (const ConferenceId &conferenceId) const {
 	return L_DB_TRANSACTION {
 		int count = 0;
 
-		soci::session *session = d->dbSession.getBackendSession();
-
 		if (!conferenceId.isValid())
-			*session << query, soci::into(count);
+			d->dbSession.executePreparedStatement(
+				Statements::SelectUnreadChatMessageCount, Statements::get(Statements::SelectUnreadChatMessageCount),
+				soci::into(count)
+			);
 		else {
 			const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
-			*session << query, soci::use(dbChatRoomId), soci::into(count);
+			d->dbSession.executePreparedStatement(
+				Statements::SelectChatRoomUnreadChatMessageCount, Statements::get(Statements::SelectChatRoomUnreadChatMessageCount),
+				soci::use(dbChatRoomId), soci::into(count)
+			);
 		}
 
 		d->unreadChatMessageCountCache.insert(conferenceId, count);
@@ -2717,6 +3070,7 @@ void MainDb::markChatMessagesAsRead (const ConferenceId &conferenceId) const {
 
 		tr.commit();
 		d->unreadChatMessageCountCache.insert(conferenceId, 0);
+		getCore()->getPrivate()->setLazyChatRoomUnreadCount(conferenceId, 0);
 	};
 #endif
 }
@@ -2945,7 +3299,7 @@ void MainDb::setChatMessageParticipantState (
 	time_t stateChangeTime
 ) {
 #ifdef HAVE_DB_STORAGE
-	L_DB_TRANSACTION {
+	L_DB_WRITE_BEHIND_TRANSACTION {
 		L_D();
 		d->setChatMessageParticipantState(eventLog, participantAddress, state, stateChangeTime);
 		tr.commit();
@@ -3219,6 +3573,74 @@ list<shared_ptr<EventLog>> MainDb::getHistoryRange (
 			if (event)
 				events.push_front(event);
 		}
+		d->loadChatMessagesContents(events);
+
+		return events;
+	};
+#else
+	return list<shared_ptr<EventLog>>();
+#endif
+}
+
+list<shared_ptr<EventLog>> MainDb::getHistoryBefore (
+	const ConferenceId &conferenceId,
+	const shared_ptr<const EventLog> &lastEvent,
+	int nLast,
+	FilterMask mask
+) const {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+
+	if (!lastEvent)
+		return getHistoryRange(conferenceId, 0, nLast, mask);
+
+	list<shared_ptr<EventLog>> events;
+
+	const EventLogPrivate *dEventLog = lastEvent->getPrivate();
+	if (!dEventLog->dbKey.isValid()) {
+		lWarning() << "Unable to get history before an event which is not stored.";
+		return events;
+	}
+
+	const long long lastEventId = static_cast<MainDbKey &>(dEventLog->dbKey).getPrivate()->storageId;
+
+	// Seek directly to the cursor instead of skipping rows with an OFFSET.
+	string query = Statements::get(Statements::SelectConferenceEvents) + buildSqlEventFilter({
+		ConferenceCallFilter, ConferenceChatMessageFilter, ConferenceInfoFilter, ConferenceInfoNoDeviceFilter, ConferenceChatMessageSecurityFilter
+	}, mask, "AND");
+	query += " AND conference_event_view.id < :2";
+	query += " ORDER BY event_id DESC";
+
+	if (nLast > 0)
+		query += " LIMIT " + Utils::toString(nLast);
+	else
+		query += " LIMIT " + d->dbSession.noLimitValue();
+
+	/*
+	DurationLogger durationLogger(
+		"Get history before event of: (peer=" + conferenceId.getPeerAddress().asString() +
+		", local=" + conferenceId.getLocalAddress().asString() +
+		", lastEventId=" + Utils::toString(lastEventId) + ", nLast=" + Utils::toString(nLast) + ")."
+	);
+	*/
+
+	return L_DB_TRANSACTION {
+		L_D();
+
+		shared_ptr<AbstractChatRoom> chatRoom = d->findChatRoom(conferenceId);
+		if (!chatRoom)
+			return events;
+
+		const long long &dbChatRoomId = d->selectChatRoomId(conferenceId);
+		soci::rowset<soci::row> rows = (
+			d->dbSession.getBackendSession()->prepare << query, soci::use(dbChatRoomId), soci::use(lastEventId)
+		);
+		for (const auto &row : rows) {
+			shared_ptr<EventLog> event = d->selectGenericConferenceEvent(chatRoom, row);
+			if (event)
+				events.push_front(event);
+		}
+		d->loadChatMessagesContents(events);
 
 		return events;
 	};
@@ -3277,96 +3699,21 @@ void MainDb::cleanHistory (const ConferenceId &conferenceId, FilterMask mask) {
 		*d->dbSession.getBackendSession() << query2, soci::use(dbChatRoomId);
 		tr.commit();
 
-		if (!mask || (mask & ConferenceChatMessageFilter))
+		if (!mask || (mask & ConferenceChatMessageFilter)) {
 			d->unreadChatMessageCountCache.insert(conferenceId, 0);
+			getCore()->getPrivate()->setLazyChatRoomUnreadCount(conferenceId, 0);
+		}
 	};
 #endif
 }
 
 // -----------------------------------------------------------------------------
 
-#ifdef HAVE_DB_STORAGE
-template<typename T>
-static void fetchContentAppData (soci::session *session, Content &content, long long contentId, T &data) {
-	static const string query = "SELECT name, data FROM chat_message_content_app_data"
-		" WHERE chat_message_content_id = :contentId";
-
-	string name;
-	soci::statement statement = (session->prepare << query, soci::use(contentId), soci::into(name), soci::into(data));
-	statement.execute();
-	while (statement.fetch())
-		content.setAppData(name, blobToString(data));
-}
-#endif
-
 void MainDb::loadChatMessageContents (const shared_ptr<ChatMessage> &chatMessage) {
 #ifdef HAVE_DB_STORAGE
 	L_DB_TRANSACTION {
 		L_D();
-
-		soci::session *session = d->dbSession.getBackendSession();
-
-		bool hasFileTransferContent = false;
-
-		ChatMessagePrivate *dChatMessage = chatMessage->getPrivate();
-		const long long &eventId = chatMessage->getStorageId();
-
-		static const string query = "SELECT chat_message_content.id, content_type.id, content_type.value, body, body_encoding_type"
-			" FROM chat_message_content, content_type"
-			" WHERE event_id = :eventId AND content_type_id = content_type.id";
-		soci::rowset<soci::row> rows = (session->prepare << query, soci::use(eventId));
-		for (const auto &row : rows) {
-			ContentType contentType(row.get<string>(2));
-			const long long &contentId = d->dbSession.resolveId(row, 0);
-			Content *content;
-			int bodyEncodingType = row.get<int>(4);
-
-			if (contentType == ContentType::FileTransfer) {
-				hasFileTransferContent = true;
-				content = new FileTransferContent();
-			} else {
-				// 1.1 - Fetch contents' file informations if they exist
-				string name;
-				int size;
-				string path;
-				int duration;
-
-				*session << "SELECT name, size, path, duration FROM chat_message_file_content"
-					" WHERE chat_message_content_id = :contentId",
-					soci::into(name), soci::into(size), soci::into(path), soci::into(duration), soci::use(contentId);
-				if (session->got_data()) {
-					FileContent *fileContent = new FileContent();
-					fileContent->setFileName(name);
-					fileContent->setFileSize(size_t(size));
-					fileContent->setFilePath(path);
-					fileContent->setFileDuration(duration);
-					content = fileContent;
-				} else {
-					content = new Content();
-				}
-			}
-
-			content->setContentType(contentType);
-			if(bodyEncodingType == 1)
-				content->setBodyFromUtf8(row.get<string>(3));
-			else
-				content->setBodyFromLocale(row.get<string>(3));
-
-			// 1.2 - Fetch contents' app data.
-			// TODO: Do not test backend, encapsulate!!!
-			if (getBackend() == MainDb::Backend::Sqlite3) {
-				soci::blob data(*session);
-				fetchContentAppData(session, *content, contentId, data);
-			} else {
-				string data;
-				fetchContentAppData(session, *content, contentId, data);
-			}
-			chatMessage->addContent(content);
-		}
-
-		// 2 - Load external body url from body into FileTransferContent if needed.
-		if (hasFileTransferContent)
-			dChatMessage->loadFileTransferUrlFromBodyToContent();
+		d->fetchChatMessagesContents({ chatMessage });
 	};
 #endif
 }
@@ -3402,9 +3749,177 @@ void MainDb::disableDisplayNotificationRequired (const std::shared_ptr<const Eve
 #endif
 }
 
+void MainDb::disableNotificationsRequired (const list<long long> &deliveredEventIds, const list<long long> &displayedEventIds) {
+#ifdef HAVE_DB_STORAGE
+	// Keep the IN (...) lists far below the maximum length of a SQL statement.
+	static constexpr size_t MaxEventIdsPerQuery = 500;
+
+	if (deliveredEventIds.empty() && displayedEventIds.empty())
+		return;
+
+	L_DB_TRANSACTION {
+		L_D();
+		soci::session *session = d->dbSession.getBackendSession();
+		auto update = [session](const list<long long> &eventIds, const string &assignments) {
+			auto it = eventIds.cbegin();
+			while (it != eventIds.cend()) {
+				string ids;
+				for (size_t count = 0; it != eventIds.cend() && count < MaxEventIdsPerQuery; ++it, ++count) {
+					if (!ids.empty())
+						ids += ",";
+					ids += Utils::toString(*it);
+				}
+				*session << "UPDATE conference_chat_message_event SET " + assignments + " WHERE event_id IN (" + ids + ")";
+			}
+		};
+		update(deliveredEventIds, "delivery_notification_required = 0");
+		update(displayedEventIds, "delivery_notification_required = 0, display_notification_required = 0");
+		tr.commit();
+	};
+#endif
+}
+
 // -----------------------------------------------------------------------------
 
-list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms () const {
+shared_ptr<AbstractChatRoom> MainDbPrivate::buildChatRoom (const MainDb::ChatRoomDescriptor &descriptor) const {
+#ifdef HAVE_DB_STORAGE
+	L_Q();
+
+	shared_ptr<Core> core = q->getCore();
+	const ConferenceId &conferenceId = descriptor.conferenceId;
+	const long long &dbChatRoomId = descriptor.dbId;
+	int capabilities = descriptor.capabilities;
+	const string &subject = descriptor.subject;
+
+	shared_ptr<AbstractChatRoom> chatRoom;
+	shared_ptr<ChatRoomParams> params = ChatRoomParams::fromCapabilities(capabilities);
+	if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Basic)) {
+		chatRoom = core->getPrivate()->createBasicChatRoom(conferenceId, capabilities, params);
+		chatRoom->setSubject(subject);
+	} else if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference)) {
+#ifdef HAVE_ADVANCED_IM
+		list<shared_ptr<Participant>> participants;
+
+		static const string query = "SELECT chat_room_participant.id, sip_address.value, is_admin"
+			" FROM sip_address, chat_room, chat_room_participant"
+			" WHERE chat_room.id = :chatRoomId"
+			" AND sip_address.id = chat_room_participant.participant_sip_address_id"
+			" AND chat_room_participant.chat_room_id = chat_room.id";
+
+		// Fetch participants.
+		soci::session *session = dbSession.getBackendSession();
+		soci::rowset<soci::row> rows = (session->prepare << query, soci::use(dbChatRoomId));
+		shared_ptr<Participant> me;
+		for (const auto &row : rows) {
+			shared_ptr<Participant> participant = Participant::create(nullptr, IdentityAddress(row.get<string>(1)));
+			participant->setAdmin(!!row.get<int>(2));
+
+			// Fetch devices.
+			{
+				const long long &participantId = dbSession.resolveId(row, 0);
+				static const string query = "SELECT sip_address.value, state, name FROM chat_room_participant_device, sip_address"
+					" WHERE chat_room_participant_id = :participantId"
+					" AND participant_device_sip_address_id = sip_address.id";
+
+				soci::rowset<soci::row> rows = (session->prepare << query, soci::use(participantId));
+				for (const auto &row : rows) {
+					shared_ptr<ParticipantDevice> device = participant->addDevice(IdentityAddress(row.get<string>(0)), row.get<string>(2, ""));
+					device->setState(ParticipantDevice::State(static_cast<unsigned int>(row.get<int>(1, 0))));
+				}
+			}
+
+			if (participant->getAddress() == conferenceId.getLocalAddress().getAddressWithoutGruu())
+				me = participant;
+			else
+				participants.push_back(participant);
+		}
+
+		Conference *conference = nullptr;
+		if (!linphone_core_conference_server_enabled(core->getCCore())) {
+			bool hasBeenLeft = descriptor.hasBeenLeft;
+			if (!me) {
+				lError() << "Unable to find me in: (peer=" + conferenceId.getPeerAddress().asString() +
+					", local=" + conferenceId.getLocalAddress().asString() + ").";
+				return nullptr;
+			}
+			shared_ptr<ClientGroupChatRoom> clientGroupChatRoom(new ClientGroupChatRoom(
+				core,
+				conferenceId,
+				me,
+				capabilities,
+				params,
+				subject,
+				move(participants),
+				descriptor.lastNotifyId,
+				hasBeenLeft
+			));
+			chatRoom = clientGroupChatRoom;
+			conference = clientGroupChatRoom->getConference().get();
+			chatRoom->setState(ConferenceInterface::State::Instantiated);
+			chatRoom->enableEphemeral(descriptor.ephemeralEnabled, false);
+			chatRoom->setEphemeralLifetime(descriptor.ephemeralLifetime, false);
+			chatRoom->setState(hasBeenLeft
+				? ConferenceInterface::State::Terminated
+				: ConferenceInterface::State::Created
+			);
+
+			if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::OneToOne)) {
+				// TODO: load previous IDs if any
+				static const string query = "SELECT sip_address.value FROM one_to_one_chat_room_previous_conference_id, sip_address"
+					" WHERE chat_room_id = :chatRoomId"
+					" AND sip_address_id = sip_address.id";
+				soci::rowset<soci::row> rows = (session->prepare << query, soci::use(dbChatRoomId));
+				for (const auto &row : rows) {
+					ConferenceId previousId = ConferenceId(ConferenceAddress(row.get<string>(0)), conferenceId.getLocalAddress());
+					if (previousId != conferenceId) {
+						lInfo() << "Keeping around previous chat room ID [" << previousId << "] in case BYE is received for exhumed chat room [" << conferenceId << "]";
+						clientGroupChatRoom->getPrivate()->addConferenceIdToPreviousList(previousId);
+					}
+				}
+			}
+
+		} else {
+			auto serverGroupChatRoom = std::make_shared<ServerGroupChatRoom>(
+				core,
+				conferenceId.getPeerAddress(),
+				capabilities,
+				params,
+				subject,
+				move(participants),
+				descriptor.lastNotifyId
+			);
+			chatRoom = serverGroupChatRoom;
+			conference = serverGroupChatRoom->getConference().get();
+			chatRoom->setState(ConferenceInterface::State::Instantiated);
+			chatRoom->enableEphemeral(descriptor.ephemeralEnabled, false);
+			chatRoom->setEphemeralLifetime(descriptor.ephemeralLifetime, false);
+			chatRoom->setState(ConferenceInterface::State::Created);
+		}
+		for (auto participant : chatRoom->getParticipants())
+			participant->setConference(conference);
+#else
+		lWarning() << "Advanced IM such as group chat is disabled!";
+#endif
+	}
+
+	if (!chatRoom)
+		return nullptr; // Not fetched.
+
+	AbstractChatRoomPrivate *dChatRoom = chatRoom->getPrivate();
+	dChatRoom->setCreationTime(descriptor.creationTime);
+	dChatRoom->setLastUpdateTime(descriptor.lastUpdateTime);
+	dChatRoom->setIsEmpty(descriptor.isEmpty);
+
+	lDebug() << "Found chat room in DB: (peer=" <<
+		conferenceId.getPeerAddress().asString() << ", local=" << conferenceId.getLocalAddress().asString() << ").";
+
+	return chatRoom;
+#else
+	return nullptr;
+#endif
+}
+
+list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms (list<ChatRoomDescriptor> *lazyChatRooms) const {
 #ifdef HAVE_DB_STORAGE
 	static const string query = "SELECT chat_room.id, peer_sip_address.value, local_sip_address.value,"
 		" creation_time, last_update_time, capabilities, subject, last_notify_id, flags, last_message_id,"
@@ -3413,6 +3928,12 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms () const {
 		" WHERE chat_room.peer_sip_address_id = peer_sip_address.id AND chat_room.local_sip_address_id = local_sip_address.id"
 		" ORDER BY last_update_time DESC";
 
+	// Unread counts of all chat rooms in one query, used to fill the descriptors of the lazy chat rooms.
+	static const string unreadCountQuery = "SELECT chat_room_id, COUNT(*)"
+		" FROM conference_event, conference_chat_message_event"
+		" WHERE conference_event.id = conference_chat_message_event.event_id AND marked_as_read == 0"
+		" GROUP BY chat_room_id";
+
 	DurationLogger durationLogger("Get chat rooms.");
 
 	return L_DB_TRANSACTION {
@@ -3420,9 +3941,17 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms () const {
 
 		list<shared_ptr<AbstractChatRoom>> chatRooms;
 		shared_ptr<Core> core = getCore();
+		const bool conferenceServerEnabled = !!linphone_core_conference_server_enabled(core->getCCore());
 
 		soci::session *session = d->dbSession.getBackendSession();
 
+		unordered_map<long long, int> unreadCounts;
+		if (lazyChatRooms) {
+			soci::rowset<soci::row> rows = (session->prepare << unreadCountQuery);
+			for (const auto &row : rows)
+				unreadCounts[d->dbSession.resolveId(row, 0)] = row.get<int>(1);
+		}
+
 		soci::rowset<soci::row> rows = (session->prepare << query);
 		for (const auto &row : rows) {
 			ConferenceId conferenceId = ConferenceId(
@@ -3436,139 +3965,44 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms () const {
 				continue;
 			}
 
-			const long long &dbChatRoomId = d->dbSession.resolveId(row, 0);
-			d->cache(conferenceId, dbChatRoomId);
-
-			time_t creationTime = d->dbSession.getTime(row, 3);
-			time_t lastUpdateTime = d->dbSession.getTime(row, 4);
-			int capabilities = row.get<int>(5);
-			string subject = row.get<string>(6, "");
-			const long long &lastMessageId = d->dbSession.resolveId(row, 9);
-
-			shared_ptr<ChatRoomParams> params = ChatRoomParams::fromCapabilities(capabilities);
-			if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Basic)) {
-				chatRoom = core->getPrivate()->createBasicChatRoom(conferenceId, capabilities, params);
-				chatRoom->setSubject(subject);
-			} else if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference)) {
-#ifdef HAVE_ADVANCED_IM
-				list<shared_ptr<Participant>> participants;
-
-				static const string query = "SELECT chat_room_participant.id, sip_address.value, is_admin"
-					" FROM sip_address, chat_room, chat_room_participant"
-					" WHERE chat_room.id = :chatRoomId"
-					" AND sip_address.id = chat_room_participant.participant_sip_address_id"
-					" AND chat_room_participant.chat_room_id = chat_room.id";
-
-				// Fetch participants.
-				unsigned int lastNotifyId = getBackend() == Backend::Mysql
-					? row.get<unsigned int>(7, 0)
-					: static_cast<unsigned int>(row.get<int>(7, 0));
-				soci::rowset<soci::row> rows = (session->prepare << query, soci::use(dbChatRoomId));
-				shared_ptr<Participant> me;
-				for (const auto &row : rows) {
-					shared_ptr<Participant> participant = Participant::create(nullptr, IdentityAddress(row.get<string>(1)));
-					participant->setAdmin(!!row.get<int>(2));
-
-					// Fetch devices.
-					{
-						const long long &participantId = d->dbSession.resolveId(row, 0);
-						static const string query = "SELECT sip_address.value, state, name FROM chat_room_participant_device, sip_address"
-							" WHERE chat_room_participant_id = :participantId"
-							" AND participant_device_sip_address_id = sip_address.id";
-
-						soci::rowset<soci::row> rows = (session->prepare << query, soci::use(participantId));
-						for (const auto &row : rows) {
-							shared_ptr<ParticipantDevice> device = participant->addDevice(IdentityAddress(row.get<string>(0)), row.get<string>(2, ""));
-							device->setState(ParticipantDevice::State(static_cast<unsigned int>(row.get<int>(1, 0))));
-						}
-					}
-
-					if (participant->getAddress() == conferenceId.getLocalAddress().getAddressWithoutGruu())
-						me = participant;
-					else
-						participants.push_back(participant);
-				}
-
-				Conference *conference = nullptr;
-				if (!linphone_core_conference_server_enabled(core->getCCore())) {
-					bool hasBeenLeft = !!row.get<int>(8, 0);
-					if (!me) {
-						lError() << "Unable to find me in: (peer=" + conferenceId.getPeerAddress().asString() +
-							", local=" + conferenceId.getLocalAddress().asString() + ").";
-						continue;
-					}
-					shared_ptr<ClientGroupChatRoom> clientGroupChatRoom(new ClientGroupChatRoom(
-						core,
-						conferenceId,
-						me,
-						capabilities,
-						params,
-						subject,
-						move(participants),
-						lastNotifyId,
-						hasBeenLeft
-					));
-					chatRoom = clientGroupChatRoom;
-					conference = clientGroupChatRoom->getConference().get();
-					chatRoom->setState(ConferenceInterface::State::Instantiated);
-					chatRoom->enableEphemeral(!!row.get<int>(10, 0), false);
-					chatRoom->setEphemeralLifetime((long)row.get<double>(11), false);
-					chatRoom->setState(hasBeenLeft
-						? ConferenceInterface::State::Terminated
-						: ConferenceInterface::State::Created
-					);
-
-					if (capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::OneToOne)) {
-						// TODO: load previous IDs if any
-						static const string query = "SELECT sip_address.value FROM one_to_one_chat_room_previous_conference_id, sip_address"
-							" WHERE chat_room_id = :chatRoomId"
-							" AND sip_address_id = sip_address.id";
-						soci::rowset<soci::row> rows = (session->prepare << query, soci::use(dbChatRoomId));
-						for (const auto &row : rows) {
-							ConferenceId previousId = ConferenceId(ConferenceAddress(row.get<string>(0)), conferenceId.getLocalAddress());
-							if (previousId != conferenceId) {
-								lInfo() << "Keeping around previous chat room ID [" << previousId << "] in case BYE is received for exhumed chat room [" << conferenceId << "]";
-								clientGroupChatRoom->getPrivate()->addConferenceIdToPreviousList(previousId);
-							}
-						}
-					}
-
-				} else {
-					auto serverGroupChatRoom = std::make_shared<ServerGroupChatRoom>(
-						core,
-						conferenceId.getPeerAddress(),
-						capabilities,
-						params,
-						subject,
-						move(participants),
-						lastNotifyId
-					);
-					chatRoom = serverGroupChatRoom;
-					conference = serverGroupChatRoom->getConference().get();
-					chatRoom->setState(ConferenceInterface::State::Instantiated);
-					chatRoom->enableEphemeral(!!row.get<int>(10, 0), false);
-					chatRoom->setEphemeralLifetime((long)row.get<double>(11), false);
-					chatRoom->setState(ConferenceInterface::State::Created);
-				}
-				for (auto participant : chatRoom->getParticipants())
-					participant->setConference(conference);
-#else
-				lWarning() << "Advanced IM such as group chat is disabled!";
-#endif
+			ChatRoomDescriptor descriptor;
+			descriptor.dbId = d->dbSession.resolveId(row, 0);
+			descriptor.conferenceId = conferenceId;
+			d->cache(conferenceId, descriptor.dbId);
+
+			descriptor.creationTime = d->dbSession.getTime(row, 3);
+			descriptor.lastUpdateTime = d->dbSession.getTime(row, 4);
+			descriptor.capabilities = row.get<int>(5);
+			descriptor.subject = row.get<string>(6, "");
+			descriptor.lastNotifyId = getBackend() == Backend::Mysql
+				? row.get<unsigned int>(7, 0)
+				: static_cast<unsigned int>(row.get<int>(7, 0));
+			descriptor.hasBeenLeft = !!row.get<int>(8, 0);
+			descriptor.isEmpty = d->dbSession.resolveId(row, 9) == 0;
+			descriptor.ephemeralEnabled = !!row.get<int>(10, 0);
+			descriptor.ephemeralLifetime = (long)row.get<double>(11);
+
+			// Active conference chat rooms must exist to be subscribed to, and one to one ones to be
+			// found when their conference is exhumed. Others can wait until they are accessed.
+			int capabilities = descriptor.capabilities;
+			bool canBeLazy = lazyChatRooms && !conferenceServerEnabled && (
+				(capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Basic)) || (
+					(capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::Conference)) &&
+					!(capabilities & ChatRoom::CapabilitiesMask(ChatRoom::Capabilities::OneToOne)) &&
+					descriptor.hasBeenLeft
+				)
+			);
+			if (canBeLazy) {
+				auto it = unreadCounts.find(descriptor.dbId);
+				descriptor.unreadChatMessageCount = it == unreadCounts.end() ? 0 : it->second;
+				d->unreadChatMessageCountCache.insert(conferenceId, descriptor.unreadChatMessageCount);
+				lazyChatRooms->push_back(move(descriptor));
+				continue;
 			}
 
-			if (!chatRoom)
-				continue; // Not fetched.
-
-			AbstractChatRoomPrivate *dChatRoom = chatRoom->getPrivate();
-			dChatRoom->setCreationTime(creationTime);
-			dChatRoom->setLastUpdateTime(lastUpdateTime);
-			dChatRoom->setIsEmpty(lastMessageId == 0);
-
-			lDebug() << "Found chat room in DB: (peer=" <<
-				conferenceId.getPeerAddress().asString() << ", local=" << conferenceId.getLocalAddress().asString() << ").";
-
-			chatRooms.push_back(chatRoom);
+			chatRoom = d->buildChatRoom(descriptor);
+			if (chatRoom)
+				chatRooms.push_back(chatRoom);
 		}
 
 		tr.commit();
@@ -3580,6 +4014,22 @@ list<shared_ptr<AbstractChatRoom>> MainDb::getChatRooms () const {
 #endif
 }
 
+shared_ptr<AbstractChatRoom> MainDb::buildChatRoom (const ChatRoomDescriptor &descriptor) const {
+#ifdef HAVE_DB_STORAGE
+	DurationLogger durationLogger("Build chat room " + descriptor.conferenceId.getPeerAddress().asString() + ".");
+
+	// Only reads are done here and this may be called while a transaction is opened
+	// (chat rooms are built on demand when an event refers to them), so do not open a new one.
+	L_D();
+	try {
+		return d->buildChatRoom(descriptor);
+	} catch (const exception &e) {
+		lError() << "Unable to build chat room " << descriptor.conferenceId << ": `" << e.what() << "`.";
+	}
+#endif
+	return nullptr;
+}
+
 void MainDbPrivate::insertNewPreviousConferenceId(const ConferenceId& currentConfId, const ConferenceId& previousConfId) {
 #ifdef HAVE_DB_STORAGE
 	const long long &previousConferenceSipAddressId = selectSipAddressId(previousConfId.getPeerAddress().asString());
@@ -3655,6 +4105,8 @@ void MainDb::deleteChatRoom (const ConferenceId &conferenceId) {
 
 		tr.commit();
 		d->unreadChatMessageCountCache.insert(conferenceId, 0);
+		// A deferred chat room must not be built from the deleted row.
+		getCore()->getPrivate()->removeLazyChatRoom(conferenceId);
 	};
 #endif
 }
@@ -3906,6 +4358,30 @@ void MainDb::deleteChatRoomParticipantDevice (
 	
 // -----------------------------------------------------------------------------
 
+bool MainDb::flushPendingWrites () {
+#ifdef HAVE_DB_STORAGE
+	L_D();
+	// Used when the writes must reach the database now, so the retries are done here after a short delay.
+	const unsigned int retryDelayMs = MainDbPrivate::WriteBehindFlushRetryDelayMs;
+	for (unsigned int attempt = 0; attempt <= MainDbPrivate::MaxWriteBehindCommitRetries; attempt++) {
+		if (attempt > 0)
+			this_thread::sleep_for(chrono::milliseconds(retryDelayMs));
+		if (d->flushPendingWrites())
+			return true;
+		if (!d->groupTransactionOpened || d->transactionDepth > 0)
+			break;
+	}
+	return false;
+#else
+	return true;
+#endif
+}
+
+const MainDb::WriteBehindStats &MainDb::getWriteBehindStats () const {
+	L_D();
+	return d->writeBehindStats;
+}
+
 bool MainDb::import (Backend, const string &parameters) {
 #ifdef HAVE_DB_STORAGE
 	L_D();
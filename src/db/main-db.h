@@ -71,6 +71,22 @@ public:
 		time_t timestamp = 0;
 	};
 
+	// Lightweight view of a chat_room row, enough to build the chat room later with buildChatRoom().
+	struct ChatRoomDescriptor {
+		long long dbId = -1;
+		ConferenceId conferenceId;
+		time_t creationTime = 0;
+		time_t lastUpdateTime = 0;
+		int capabilities = 0;
+		std::string subject;
+		unsigned int lastNotifyId = 0;
+		bool hasBeenLeft = false;
+		bool isEmpty = true;
+		bool ephemeralEnabled = false;
+		long ephemeralLifetime = 0;
+		int unreadChatMessageCount = 0;
+	};
+
 	MainDb (const std::shared_ptr<Core> &core);
 
 	// ---------------------------------------------------------------------------
@@ -154,6 +170,14 @@ public:
 		int end,
 		FilterMask mask = NoFilter
 	) const;
+	// Keyset pagination: returns the nLast events stored before lastEvent, sorted from oldest to most recent.
+	// Unlike getHistoryRange, the cost does not depend on the depth of the page in the history.
+	std::list<std::shared_ptr<EventLog>> getHistoryBefore (
+		const ConferenceId &conferenceId,
+		const std::shared_ptr<const EventLog> &lastEvent,
+		int nLast,
+		FilterMask mask = NoFilter
+	) const;
 
 	int getHistorySize (const ConferenceId &conferenceId, FilterMask mask = NoFilter) const;
 
@@ -167,12 +191,17 @@ public:
 
 	void disableDeliveryNotificationRequired (const std::shared_ptr<const EventLog> &eventLog);
 	void disableDisplayNotificationRequired (const std::shared_ptr<const EventLog> &eventLog);
+	// Same as above for several chat messages at once, in a single transaction.
+	void disableNotificationsRequired (const std::list<long long> &deliveredEventIds, const std::list<long long> &displayedEventIds);
 
 	// ---------------------------------------------------------------------------
 	// Chat rooms.
 	// ---------------------------------------------------------------------------
 
-	std::list<std::shared_ptr<AbstractChatRoom>> getChatRooms () const;
+	// If lazyChatRooms is given, the chat rooms that can be built on demand are returned there
+	// as descriptors instead of being built.
+	std::list<std::shared_ptr<AbstractChatRoom>> getChatRooms (std::list<ChatRoomDescriptor> *lazyChatRooms = nullptr) const;
+	std::shared_ptr<AbstractChatRoom> buildChatRoom (const ChatRoomDescriptor &descriptor) const;
 	void insertChatRoom (const std::shared_ptr<AbstractChatRoom> &chatRoom, unsigned int notifyId = 0);
 	void deleteChatRoom (const ConferenceId &conferenceId);
 	void updateChatRoomConferenceId (const ConferenceId oldConferenceId, const ConferenceId &newConferenceId);
@@ -221,6 +250,17 @@ public:
 	// Import legacy calls/messages from old db.
 	bool import (Backend backend, const std::string &parameters) override;
 
+	struct WriteBehindStats {
+		unsigned int committedWrites = 0;
+		unsigned int failedCommits = 0; // Commits of a group which failed, the group being retried afterwards.
+		unsigned int lostWrites = 0; // Writes of the groups which could not be committed after all the retries.
+	};
+
+	// Commit now the writes delayed by the write-behind mode, if any. Returns false if they could not be committed.
+	bool flushPendingWrites ();
+
+	const WriteBehindStats &getWriteBehindStats () const;
+
 protected:
 	void init () override;
 
@@ -17,6 +17,8 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <unordered_map>
+
 #include "linphone/utils/utils.h"
 
 #include "sqlite3_bctbx_vfs.h"
@@ -38,6 +40,9 @@ public:
 	} backend = Backend::None;
 
 	std::unique_ptr<soci::session> backendSession;
+
+	// Must be destroyed before the backend session.
+	mutable std::unordered_map<int, std::unique_ptr<soci::statement>> preparedStatements;
 };
 
 DbSession::DbSession () : mPrivate(new DbSessionPrivate) {}
@@ -292,4 +297,24 @@ time_t DbSession::getTime (const soci::row &row, int col) const {
 	return 0;
 }
 
+// -----------------------------------------------------------------------------
+
+soci::statement &DbSession::getPreparedStatement (int id, const char *query) const {
+	L_D();
+
+	auto it = d->preparedStatements.find(id);
+	if (it != d->preparedStatements.end())
+		return *it->second;
+
+	std::unique_ptr<soci::statement> statement = makeUnique<soci::statement>(*d->backendSession);
+	statement->alloc();
+	statement->prepare(query);
+	return *d->preparedStatements.emplace(id, std::move(statement)).first->second;
+}
+
+void DbSession::clearPreparedStatements () {
+	L_D();
+	d->preparedStatements.clear();
+}
+
 LINPHONE_END_NAMESPACE
@@ -20,6 +20,8 @@
 #ifndef _L_DB_SESSION_H_
 #define _L_DB_SESSION_H_
 
+#include <initializer_list>
+
 #include <soci/soci.h>
 
 #include "linphone/utils/general.h"
@@ -62,7 +64,36 @@ public:
 
 	std::time_t getTime (const soci::row &row, int col) const;
 
+	// Execute a statement which is prepared only once per session and cached under the given id.
+	// Variables are bound again on each call and unbound afterwards, so the statement can be reused
+	// with other values. Returns true if a row was fetched.
+	template<typename... Exchanges>
+	bool executePreparedStatement (int id, const char *query, Exchanges &&...exchanges) const {
+		soci::statement &statement = getPreparedStatement(id, query);
+		StatementBinding binding(statement);
+		(void)std::initializer_list<int>{ (statement.exchange(std::forward<Exchanges>(exchanges)), 0)... };
+		statement.define_and_bind();
+		statement.execute(true);
+		return statement.got_data();
+	}
+
+	void clearPreparedStatements ();
+
 private:
+	class StatementBinding {
+	public:
+		explicit StatementBinding (soci::statement &statement) : mStatement(statement) {}
+
+		~StatementBinding () {
+			mStatement.bind_clean_up();
+		}
+
+	private:
+		soci::statement &mStatement;
+	};
+
+	soci::statement &getPreparedStatement (int id, const char *query) const;
+
 	DbSessionPrivate *mPrivate;
 
 	L_DECLARE_PRIVATE(DbSession);
@@ -22,6 +22,8 @@
 #include "sal/call-op.h"
 #include "content/content-manager.h"
 
+#include <functional>
+
 #include <bctoolbox/defs.h>
 #include <belle-sip/provider.h>
 
@@ -198,6 +200,20 @@ void SalCallOp::fillSessionExpiresHeaders(belle_sip_request_t *invite, belle_sip
 	fillSessionExpiresHeaders(invite, refresher, 0);
 }
 
+void SalCallOp::updateIncomingConfigurationIndexes (const vector<bool> &unchangedStreams) {
+	auto &indexes = mIncomingNegotiationCache.configurationIndexes;
+	// A reused stream was not negotiated again, so its descriptions are set back to the configurations chosen previously.
+	for (size_t i = 0; i < mRemoteMedia->streams.size(); i++) {
+		if ((i < unchangedStreams.size()) && unchangedStreams[i] && (i < indexes.size())) {
+			mLocalMedia->streams[i].cfgIndex = indexes[i].first;
+			mRemoteMedia->streams[i].cfgIndex = indexes[i].second;
+		}
+	}
+	indexes.clear();
+	for (size_t i = 0; i < mRemoteMedia->streams.size(); i++)
+		indexes.emplace_back(mLocalMedia->streams[i].cfgIndex, mRemoteMedia->streams[i].cfgIndex);
+}
+
 // RFC4028
 void SalCallOp::fillSessionExpiresHeaders(belle_sip_request_t *invite, belle_sip_header_session_expires_refresher_t refresher, int delta) {
 	if (mRoot->mSessionExpiresEnabled) {
@@ -300,8 +316,8 @@ Content SalCallOp::extractBody (belle_sip_message_t *message) {
 	return body;
 }
 
-int SalCallOp::parseSdpBody (const Content &body, belle_sdp_session_description_t **sessionDesc, SalReason *error) {
-	*sessionDesc = nullptr;
+int SalCallOp::parseSdpBody (const Content &body, std::shared_ptr<SalMediaDescription> &media, SalReason *error) {
+	media = nullptr;
 	*error = SalReasonNone;
 
 	if (mSdpHandling == SalOpSDPSimulateError) {
@@ -318,16 +334,57 @@ int SalCallOp::parseSdpBody (const Content &body, belle_sdp_session_description_
 	string strBody = body.getBodyAsString();
 	if (strBody.empty())
 		return 0;
-	*sessionDesc = belle_sdp_session_description_parse(strBody.c_str());
-	if (!*sessionDesc) {
+
+	size_t hash = std::hash<string>()(strBody);
+	if (mRemoteSdpCache.media && (hash == mRemoteSdpCache.hash) && (strBody == mRemoteSdpCache.body)) {
+		lInfo() << "SDP of op " << this << " is the same as the previous one, not parsing it again";
+		media = make_shared<SalMediaDescription>(*mRemoteSdpCache.media);
+		return 0;
+	}
+
+	belle_sdp_session_description_t *sessionDesc = belle_sdp_session_description_parse(strBody.c_str());
+	if (!sessionDesc) {
 		lError() << "Failed to parse SDP message";
 		*error = SalReasonNotAcceptable;
 		return -1;
 	}
+	media = make_shared<SalMediaDescription>(sessionDesc);
+	belle_sip_object_unref(sessionDesc);
 
+	// A copy is kept, the description given to the upper layers may be modified.
+	mRemoteSdpCache.hash = hash;
+	mRemoteSdpCache.body = move(strBody);
+	mRemoteSdpCache.media = make_shared<SalMediaDescription>(*media);
 	return 0;
 }
 
+bool SalCallOp::SdpSections::isSectionEqual (const SdpSections &other, size_t index) const {
+	return (index < sections.size()) && (index < other.sections.size())
+		&& (hashes[index] == other.hashes[index]) && (sections[index] == other.sections[index]);
+}
+
+SalCallOp::SdpSections SalCallOp::splitSdp (const Content &body) {
+	SdpSections sdp;
+	if (body.getContentType() != ContentType::Sdp)
+		return sdp;
+
+	const string text = body.getBodyAsString();
+	sdp.sections.emplace_back();
+	for (size_t start = 0; start < text.size();) {
+		size_t end = text.find('\n', start);
+		end = (end == string::npos) ? text.size() : end + 1;
+		if (text.compare(start, 2, "m=") == 0)
+			sdp.sections.emplace_back();
+		// The version of the origin changes whatever the part of the SDP that changed.
+		if ((sdp.sections.size() > 1) || (text.compare(start, 2, "o=") != 0))
+			sdp.sections.back().append(text, start, end - start);
+		start = end;
+	}
+	for (const auto &section : sdp.sections)
+		sdp.hashes.push_back(std::hash<string>()(section));
+	return sdp;
+}
+
 std::string SalCallOp::setAddrTo0000 (const std::string & value) {
 	if (ms_is_ipv6(value.c_str()))
 		return "::0";
@@ -350,7 +407,13 @@ void SalCallOp::sdpProcess () {
 	} else {
 		if (mSdpAnswer)
 			belle_sip_object_unref(mSdpAnswer);
-		mResult = OfferAnswerEngine::initiateIncoming(mRoot->mFactory, mLocalMedia, mRemoteMedia, mRoot->mOneMatchingCodec);
+		vector<bool> unchangedStreams = updateIncomingNegotiationCache();
+		size_t reusedStreams = 0;
+		mResult = OfferAnswerEngine::initiateIncoming(mRoot->mFactory, mLocalMedia, mRemoteMedia, mRoot->mOneMatchingCodec,
+			mIncomingNegotiationCache.result, unchangedStreams, &reusedStreams);
+		mReusedStreamsCount += reusedStreams;
+		updateIncomingConfigurationIndexes(unchangedStreams);
+		mIncomingNegotiationCache.result = make_shared<SalMediaDescription>(*mResult);
 		// For backward compatibility purpose
 		if (mCnxIpTo0000IfSendOnlyEnabled && mResult->hasDir(SalStreamSendOnly)) {
 			mResult->addr = setAddrTo0000(mResult->addr);
@@ -389,6 +452,44 @@ void SalCallOp::sdpProcess () {
 	}
 }
 
+vector<bool> SalCallOp::updateIncomingNegotiationCache () {
+	auto &cache = mIncomingNegotiationCache;
+	SdpSections previousLocal = move(cache.local);
+	SdpSections previousRemote = move(cache.remote);
+	vector<list<LinphoneMediaEncryption>> previousLocalEncryptions = move(cache.localEncryptions);
+
+	// The m-lines are only compared when nothing else the negotiation depends on changed.
+	bool comparable = cache.result
+		&& (cache.acceptBundles == mLocalMedia->accept_bundles)
+		&& (cache.capabilityNegotiation == mLocalMedia->supportCapabilityNegotiation())
+		&& (cache.oneMatchingCodec == mRoot->mOneMatchingCodec);
+
+	cache.local = splitSdp(mLocalBody);
+	cache.remote = splitSdp(mRemoteBody);
+	cache.localEncryptions.clear();
+	for (const auto &stream : mLocalMedia->streams)
+		cache.localEncryptions.push_back(stream.getSupportedEncryptions());
+	cache.acceptBundles = mLocalMedia->accept_bundles;
+	cache.capabilityNegotiation = mLocalMedia->supportCapabilityNegotiation();
+	cache.oneMatchingCodec = mRoot->mOneMatchingCodec;
+
+	vector<bool> unchangedStreams(mRemoteMedia->streams.size(), false);
+	comparable = comparable
+		&& cache.local.isSectionEqual(previousLocal, 0)
+		&& cache.remote.isSectionEqual(previousRemote, 0)
+		&& (cache.remote.sections.size() == mRemoteMedia->streams.size() + 1);
+	if (!comparable)
+		return unchangedStreams;
+
+	for (size_t i = 0; i < unchangedStreams.size(); i++) {
+		unchangedStreams[i] = cache.local.isSectionEqual(previousLocal, i + 1)
+			&& cache.remote.isSectionEqual(previousRemote, i + 1)
+			&& (i < cache.localEncryptions.size()) && (i < previousLocalEncryptions.size())
+			&& (cache.localEncryptions[i] == previousLocalEncryptions[i]);
+	}
+	return unchangedStreams;
+}
+
 // RFC4028
 void SalCallOp::handleSessionTimersFromResponse (belle_sip_response_t *response) {
 	if (mRoot->mSessionExpiresEnabled) {
@@ -427,14 +528,12 @@ void SalCallOp::handleBodyFromResponse (belle_sip_response_t *response) {
 	}
 
 	if (sdpBody.getContentType() == ContentType::Sdp) {
-		belle_sdp_session_description_t *sdp = nullptr;
+		std::shared_ptr<SalMediaDescription> media;
 		SalReason reason;
-		if (parseSdpBody(sdpBody, &sdp, &reason) == 0) {
-			if (sdp) {
-
-				mRemoteMedia = std::make_shared<SalMediaDescription>(sdp);
+		if (parseSdpBody(sdpBody, media, &reason) == 0) {
+			if (media) {
+				mRemoteMedia = media;
 				mRemoteBody = move(sdpBody);
-				belle_sip_object_unref(sdp);
 			} // If no SDP in response, what can we do?
 		}
 		// Process sdp in any case to reset result media description
@@ -746,15 +845,14 @@ SalReason SalCallOp::processBodyForInvite (belle_sip_request_t *invite) {
 	}
 
 	if ((sdpBody.getContentType() == ContentType::Sdp) || (sdpBody.getContentType().isEmpty() && sdpBody.isEmpty())) {
-		belle_sdp_session_description_t *sdp;
-		if (parseSdpBody(sdpBody, &sdp, &reason) == 0) {
-			if (sdp) {
+		std::shared_ptr<SalMediaDescription> media;
+		if (parseSdpBody(sdpBody, media, &reason) == 0) {
+			if (media) {
 				mSdpOffering = false;
-				mRemoteMedia = std::make_shared<SalMediaDescription>(sdp);
+				mRemoteMedia = media;
 				// Make some sanity check about the received SDP
 				if (!isMediaDescriptionAcceptable(mRemoteMedia))
 					reason = SalReasonNotAcceptable;
-				belle_sip_object_unref(sdp);
 			} else {
 				mSdpOffering = true; // INVITE without SDP
 			}
@@ -790,12 +888,11 @@ SalReason SalCallOp::processBodyForAck (belle_sip_request_t *ack) {
 	}
 
 	if (sdpBody.getContentType() == ContentType::Sdp) {
-		belle_sdp_session_description_t *sdp;
-		if (parseSdpBody(sdpBody, &sdp, &reason) == 0) {
-			if (sdp) {
-				mRemoteMedia = std::make_shared<SalMediaDescription>(sdp);
+		std::shared_ptr<SalMediaDescription> media;
+		if (parseSdpBody(sdpBody, media, &reason) == 0) {
+			if (media) {
+				mRemoteMedia = media;
 				sdpProcess();
-				belle_sip_object_unref(sdp);
 			} else {
 				lWarning() << "SDP expected in ACK but not found";
 			}
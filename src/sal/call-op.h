@@ -43,6 +43,8 @@ public:
 	const std::shared_ptr<SalMediaDescription> & getRemoteMediaDescription () { return mRemoteMedia; }
 	const Content &getRemoteBody () const { return mRemoteBody; }
 	std::shared_ptr<SalMediaDescription> & getFinalMediaDescription ();
+	// Number of streams taken from a previous negotiation since the op was created, because their m-lines did not change.
+	size_t getReusedStreamsCount () const { return mReusedStreamsCount; }
 
 	int call (const std::string &from, const std::string &to, const std::string &subject);
 	int notifyRinging (bool earlyMedia, const LinphoneSupportLevel supportLevel100Rel);
@@ -85,8 +87,18 @@ private:
 	void callTerminated (belle_sip_server_transaction_t *serverTransaction, int statusCode, belle_sip_request_t *cancelRequest);
 	void resetDescriptions ();
 
-	int parseSdpBody (const Content &body, belle_sdp_session_description_t **sessionDesc, SalReason *error);
+	// SDP body split into its session part, without the origin line, then one section per m-line.
+	struct SdpSections {
+		std::vector<std::string> sections;
+		std::vector<size_t> hashes;
+
+		bool isSectionEqual (const SdpSections &other, size_t index) const;
+	};
+
+	int parseSdpBody (const Content &body, std::shared_ptr<SalMediaDescription> &media, SalReason *error);
 	void sdpProcess ();
+	std::vector<bool> updateIncomingNegotiationCache ();
+	void updateIncomingConfigurationIndexes (const std::vector<bool> &unchangedStreams);
 	void handleBodyFromResponse (belle_sip_response_t *response);
 	void handleSessionTimersFromResponse(belle_sip_response_t *response);
 	SalReason processBodyForInvite (belle_sip_request_t *invite);
@@ -106,6 +118,7 @@ private:
 	void processNotify (const belle_sip_request_event_t *event, belle_sip_server_transaction_t *serverTransaction);
 	bool checkForOrphanDialogOn2xx(belle_sip_dialog_t *dialog);
 
+	static SdpSections splitSdp (const Content &body);
 	static std::string setAddrTo0000 (const std::string & value);
 	static bool isMediaDescriptionAcceptable (std::shared_ptr<SalMediaDescription> & md);
 	static bool isAPendingIncomingInviteTransaction (belle_sip_transaction_t *transaction);
@@ -141,6 +154,27 @@ private:
 	Content mRemoteBody;
 	std::list<Content> mAdditionalLocalBodies;
 	std::list<Content> mAdditionalRemoteBodies;
+
+	// Last remote SDP body parsed, reused as is when the peer sends the same one again (session refreshes).
+	struct {
+		size_t hash = 0;
+		std::string body;
+		std::shared_ptr<SalMediaDescription> media;
+	} mRemoteSdpCache;
+
+	// Last incoming offer/answer, so that only the m-lines changed since are negotiated again.
+	struct {
+		SdpSections local;
+		SdpSections remote;
+		std::vector<std::list<LinphoneMediaEncryption>> localEncryptions; // Not part of the local SDP.
+		bool acceptBundles = false;
+		bool capabilityNegotiation = false;
+		bool oneMatchingCodec = false;
+		std::shared_ptr<SalMediaDescription> result; // Before being completed with the remote parameters.
+		// Local and remote configuration indexes chosen for each stream, which initiateIncoming() only sets when negotiating.
+		std::vector<std::pair<PotentialCfgGraph::media_description_config::key_type, PotentialCfgGraph::media_description_config::key_type>> configurationIndexes;
+	} mIncomingNegotiationCache;
+	size_t mReusedStreamsCount = 0;
 };
 
 LINPHONE_END_NAMESPACE
@@ -891,10 +891,14 @@ std::shared_ptr<SalMediaDescription> OfferAnswerEngine::initiateOutgoing(MSFacto
 **/
 std::shared_ptr<SalMediaDescription> OfferAnswerEngine::initiateIncoming(MSFactory *factory, const std::shared_ptr<SalMediaDescription> local_capabilities,
 					std::shared_ptr<SalMediaDescription> remote_offer,
-					bool one_matching_codec){
+					bool one_matching_codec,
+					const std::shared_ptr<SalMediaDescription> &previous_result,
+					const std::vector<bool> &unchanged_streams,
+					size_t *reused_streams_count){
 
 	auto result = std::make_shared<SalMediaDescription>(local_capabilities->supportCapabilityNegotiation(), local_capabilities->tcapLinesMerged());
 	size_t i;
+	size_t reused_streams = 0;
 
 	if (!remote_offer->bundles.empty() && local_capabilities->accept_bundles){
 		/* Copy the bundle offering to the result media description. */
@@ -911,6 +915,11 @@ std::shared_ptr<SalMediaDescription> OfferAnswerEngine::initiateIncoming(MSFacto
 		if (i >= local_capabilities->streams.size()) {
 			local_capabilities->streams.resize((i + 1));
 		}
+		if (previous_result && (i < unchanged_streams.size()) && unchanged_streams[i] && (i < previous_result->streams.size())) {
+			result->streams.push_back(previous_result->streams[i]);
+			reused_streams++;
+			continue;
+		}
 		const SalStreamDescription & ls = local_capabilities->streams[i];
 		SalStreamDescription & rs = remote_offer->streams[i];
 		SalStreamDescription stream;
@@ -985,6 +994,11 @@ std::shared_ptr<SalMediaDescription> OfferAnswerEngine::initiateIncoming(MSFacto
 		}
 	}
 
+	if (reused_streams > 0)
+		lInfo() << "Offer/answer: " << reused_streams << " of " << remote_offer->streams.size() << " streams unchanged since the previous offer, not negotiated again";
+	if (reused_streams_count)
+		*reused_streams_count = reused_streams;
+
 	return result;
 }
 
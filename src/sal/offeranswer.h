@@ -52,9 +52,15 @@ class OfferAnswerEngine {
 		 * Returns a media description to run the streams with, based on the local capabilities and
 		 * and the received offer.
 		 * The returned media description is an answer and should be sent to the offerer.
+		 * The streams flagged in unchanged_streams are taken from previous_result instead of being negotiated again,
+		 * their local and remote m-lines being the same as when previous_result was computed.
+		 * If not null, reused_streams_count is set to the number of streams taken from previous_result.
 		**/
 		static std::shared_ptr<SalMediaDescription> initiateIncoming(MSFactory* factory, const std::shared_ptr<SalMediaDescription> local_capabilities,
-							std::shared_ptr<SalMediaDescription> remote_offer, bool one_matching_codec);
+							std::shared_ptr<SalMediaDescription> remote_offer, bool one_matching_codec,
+							const std::shared_ptr<SalMediaDescription> &previous_result = nullptr,
+							const std::vector<bool> &unchanged_streams = std::vector<bool>(),
+							size_t *reused_streams_count = nullptr);
 
 	private:
 
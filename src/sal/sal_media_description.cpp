@@ -71,6 +71,9 @@ SalMediaDescription::SalMediaDescription(const SalMediaDescription & other) {
 
 	capabilityNegotiationSupported = other.capabilityNegotiationSupported;
 	mergeTcapLines = other.mergeTcapLines;
+	acaps = other.acaps;
+	tcaps = other.tcaps;
+	haveLimeIk = other.haveLimeIk;
 }
 
 SalMediaDescription::SalMediaDescription(belle_sdp_session_description_t  *sdp) : SalMediaDescription(false, false) {
@@ -78,7 +78,7 @@ SalStreamDescription::SalStreamDescription(const SalStreamDescription & other){
 	ice_ufrag = other.ice_ufrag;
 	ice_pwd = other.ice_pwd;
 	ice_mismatch = other.ice_mismatch;
-
+	supportedEncryption = other.supportedEncryption;
 }
 
 SalStreamDescription::SalStreamDescription(const SalMediaDescription * salMediaDesc, const belle_sdp_session_description_t  *sdp, const belle_sdp_media_description_t *media_desc) : SalStreamDescription() {
@@ -704,6 +704,7 @@ SalStreamDescription &SalStreamDescription::operator=(const SalStreamDescription
 	ice_ufrag = other.ice_ufrag;
 	ice_pwd = other.ice_pwd;
 	ice_mismatch = other.ice_mismatch;
+	supportedEncryption = other.supportedEncryption;
 
 	return *this;
 }
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "friend-search-index.h"
+
+#include "linphone/core.h"
+#include "logger/logger.h"
+#include "private.h"
+
+// =============================================================================
+
+using namespace std;
+
+LINPHONE_BEGIN_NAMESPACE
+
+void FriendSearchIndex::addFriend (LinphoneFriend *lf) {
+	if (mEntries.find(lf) != mEntries.end()) {
+		updateFriend(lf);
+		return;
+	}
+	insertEntry(lf, ++mSequence);
+}
+
+void FriendSearchIndex::removeFriend (const LinphoneFriend *lf) {
+	auto it = mEntries.find(lf);
+	if (it == mEntries.end())
+		return;
+
+	for (const auto &gram : it->second.grams) {
+		auto postingIt = mPostings.find(gram);
+		if (postingIt == mPostings.end())
+			continue;
+
+		vector<LinphoneFriend *> &posting = postingIt->second;
+		auto friendIt = find(posting.begin(), posting.end(), lf);
+		if (friendIt != posting.end()) {
+			*friendIt = posting.back();
+			posting.pop_back();
+		}
+		if (posting.empty())
+			mPostings.erase(postingIt);
+	}
+	mEntries.erase(it);
+}
+
+void FriendSearchIndex::updateFriend (LinphoneFriend *lf) {
+	auto it = mEntries.find(lf);
+	if (it == mEntries.end())
+		return;
+
+	// Keep the original sequence so that the friend keeps its rank in lookups.
+	uint64_t sequence = it->second.sequence;
+	removeFriend(lf);
+	insertEntry(lf, sequence);
+}
+
+void FriendSearchIndex::clear () {
+	mEntries.clear();
+	mPostings.clear();
+}
+
+bool FriendSearchIndex::canLookup (const string &filter) {
+	return filter.size() >= 2;
+}
+
+vector<LinphoneFriend *> FriendSearchIndex::lookup (LinphoneCore *lc, const string &filter) {
+	vector<LinphoneFriend *> result;
+
+	string phoneNormalizationKey = getPhoneNormalizationKey(lc);
+	if (phoneNormalizationKey != mPhoneNormalizationKey) {
+		mPhoneNormalizationKey = phoneNormalizationKey;
+		if (!mEntries.empty())
+			rebuild();
+	}
+
+	vector<Gram> filterGrams;
+	string normalizedFilter = normalize(filter.c_str());
+	if (normalizedFilter.size() == 2) {
+		appendGrams(normalizedFilter, filterGrams);
+	} else {
+		// Trigrams are selective enough, bigrams of the filter would only add lookups.
+		vector<Gram> grams;
+		appendGrams(normalizedFilter, grams);
+		for (const auto &gram : grams) {
+			if ((gram >> 24) == 3)
+				filterGrams.push_back(gram);
+		}
+	}
+	sort(filterGrams.begin(), filterGrams.end());
+	filterGrams.erase(unique(filterGrams.begin(), filterGrams.end()), filterGrams.end());
+	if (filterGrams.empty())
+		return result;
+
+	// Start from the smallest posting list and check the other grams on each candidate.
+	const vector<LinphoneFriend *> *smallestPosting = nullptr;
+	for (const auto &gram : filterGrams) {
+		auto postingIt = mPostings.find(gram);
+		if (postingIt == mPostings.end())
+			return result;
+		if (!smallestPosting || postingIt->second.size() < smallestPosting->size())
+			smallestPosting = &postingIt->second;
+	}
+
+	vector<pair<uint64_t, LinphoneFriend *>> candidates;
+	for (LinphoneFriend *lf : *smallestPosting) {
+		const Entry &entry = mEntries.at(lf);
+		bool matches = all_of(filterGrams.cbegin(), filterGrams.cend(), [&entry](Gram gram) {
+			return binary_search(entry.grams.cbegin(), entry.grams.cend(), gram);
+		});
+		if (matches)
+			candidates.emplace_back(entry.sequence, lf);
+	}
+
+	// Friend lists prepend new friends, keep the same order.
+	sort(candidates.begin(), candidates.end(), [](const pair<uint64_t, LinphoneFriend *> &a, const pair<uint64_t, LinphoneFriend *> &b) {
+		return a.first > b.first;
+	});
+	result.reserve(candidates.size());
+	for (const auto &candidate : candidates)
+		result.push_back(candidate.second);
+	return result;
+}
+
+// -----------------------------------------------------------------------------
+
+string FriendSearchIndex::normalize (const char *value) {
+	string normalized = value ? value : "";
+	transform(normalized.begin(), normalized.end(), normalized.begin(), [](unsigned char c) { return tolower(c); });
+	return normalized;
+}
+
+void FriendSearchIndex::appendGrams (const string &value, vector<Gram> &grams) {
+	const size_t size = value.size();
+	for (size_t i = 0; i + 2 <= size; i++) {
+		Gram bigram = (Gram(2) << 24) | (Gram((unsigned char)value[i]) << 16) | (Gram((unsigned char)value[i + 1]) << 8);
+		grams.push_back(bigram);
+		if (i + 3 <= size)
+			grams.push_back((Gram(3) << 24) | (bigram & 0x00ffff00) | Gram((unsigned char)value[i + 2]));
+	}
+}
+
+vector<FriendSearchIndex::Gram> FriendSearchIndex::computeGrams (const LinphoneFriend *lf) {
+	vector<Gram> grams;
+
+	// Same fields as the ones checked by MagicSearch::searchInFriend().
+	if (linphone_core_vcard_supported() && linphone_friend_get_vcard(lf))
+		appendGrams(normalize(linphone_vcard_get_full_name(linphone_friend_get_vcard(lf))), grams);
+
+	const bctbx_list_t *addresses = linphone_friend_get_addresses(lf);
+	for (const bctbx_list_t *it = addresses; it != nullptr && it->data != nullptr; it = bctbx_list_next(it)) {
+		const LinphoneAddress *lAddress = static_cast<const LinphoneAddress *>(bctbx_list_get_data(it));
+		appendGrams(normalize(linphone_address_get_username(lAddress)), grams);
+		appendGrams(normalize(linphone_address_get_display_name(lAddress)), grams);
+	}
+	// Without vCard support the list is built on each call.
+	if (!linphone_core_vcard_supported())
+		bctbx_list_free((bctbx_list_t *)addresses);
+
+	LinphoneProxyConfig *proxy = lf->lc ? linphone_core_get_default_proxy_config(lf->lc) : nullptr;
+	bctbx_list_t *phoneNumbers = linphone_friend_get_phone_numbers(lf);
+	for (const bctbx_list_t *it = phoneNumbers; it != nullptr && it->data != nullptr; it = bctbx_list_next(it)) {
+		const char *number = static_cast<const char *>(bctbx_list_get_data(it));
+		appendGrams(normalize(number), grams);
+		if (proxy) {
+			char *normalizedNumber = linphone_proxy_config_normalize_phone_number(proxy, number);
+			if (normalizedNumber) {
+				appendGrams(normalize(normalizedNumber), grams);
+				bctbx_free(normalizedNumber);
+			}
+		}
+
+		const LinphonePresenceModel *presence = linphone_friend_get_presence_model_for_uri_or_tel(lf, number);
+		char *contact = presence ? linphone_presence_model_get_contact(presence) : nullptr;
+		if (contact) {
+			appendGrams(normalize(contact), grams);
+			bctbx_free(contact);
+		}
+	}
+	if (phoneNumbers) bctbx_list_free(phoneNumbers);
+
+	sort(grams.begin(), grams.end());
+	grams.erase(unique(grams.begin(), grams.end()), grams.end());
+	return grams;
+}
+
+string FriendSearchIndex::getPhoneNormalizationKey (LinphoneCore *lc) {
+	LinphoneProxyConfig *proxy = lc ? linphone_core_get_default_proxy_config(lc) : nullptr;
+	if (!proxy)
+		return string();
+
+	const char *dialPrefix = linphone_proxy_config_get_dial_prefix(proxy);
+	return string(linphone_proxy_config_get_dial_escape_plus(proxy) ? "1" : "0") + (dialPrefix ? dialPrefix : "");
+}
+
+void FriendSearchIndex::insertEntry (LinphoneFriend *lf, uint64_t sequence) {
+	// Friends of a list share its core, the key of the first one holds for the others.
+	if (mEntries.empty())
+		mPhoneNormalizationKey = getPhoneNormalizationKey(lf->lc);
+
+	Entry &entry = mEntries[lf];
+	entry.sequence = sequence;
+	entry.grams = computeGrams(lf);
+	for (const auto &gram : entry.grams)
+		mPostings[gram].push_back(lf);
+}
+
+void FriendSearchIndex::rebuild () {
+	lInfo() << "FriendSearchIndex: phone number normalization changed, re-indexing " << mEntries.size() << " friends.";
+	mPostings.clear();
+	for (auto &entry : mEntries) {
+		LinphoneFriend *lf = const_cast<LinphoneFriend *>(entry.first);
+		entry.second.grams = computeGrams(lf);
+		for (const auto &gram : entry.second.grams)
+			mPostings[gram].push_back(lf);
+	}
+}
+
+LINPHONE_END_NAMESPACE
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _L_FRIEND_SEARCH_INDEX_H_
+#define _L_FRIEND_SEARCH_INDEX_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "linphone/types.h"
+#include "linphone/utils/general.h"
+
+// =============================================================================
+
+LINPHONE_BEGIN_NAMESPACE
+
+/*
+ * N-gram index over the searchable fields of the friends of one LinphoneFriendList
+ * (vCard full name, SIP addresses username and display name, phone numbers and their
+ * presence contact). It is maintained incrementally by the friend list and lets
+ * MagicSearch only evaluate the friends that may contain the searched filter instead of
+ * scanning the whole list on each keystroke.
+ * The index may return false positives (candidates are then checked by MagicSearch), never
+ * false negatives as long as friends are modified through the LinphoneFriend API.
+ */
+class FriendSearchIndex {
+public:
+	FriendSearchIndex () = default;
+	FriendSearchIndex (const FriendSearchIndex &) = delete;
+
+	FriendSearchIndex &operator= (const FriendSearchIndex &) = delete;
+
+	void addFriend (LinphoneFriend *lf);
+	void removeFriend (const LinphoneFriend *lf);
+	// Re-index a friend already known by the index, does nothing otherwise.
+	void updateFriend (LinphoneFriend *lf);
+	void clear ();
+
+	size_t size () const {
+		return mEntries.size();
+	}
+
+	/**
+	 * Tell if the index is able to narrow a search on the given filter.
+	 * Filters shorter than a bigram match (almost) every friend and must be handled with a full scan.
+	 * @param[in] filter word we search
+	 **/
+	static bool canLookup (const std::string &filter);
+
+	/**
+	 * Phone numbers are indexed normalized with the default proxy config of lc, the whole index is
+	 * rebuilt first if the default proxy config or its dial settings changed since.
+	 * @param[in] lc core whose default proxy config normalizes the phone numbers of the friends
+	 * @param[in] filter word we search, must satisfy canLookup()
+	 * @return the friends whose searchable fields may contain filter, most recently indexed first
+	 **/
+	std::vector<LinphoneFriend *> lookup (LinphoneCore *lc, const std::string &filter);
+
+private:
+	using Gram = uint32_t;
+
+	struct Entry {
+		uint64_t sequence;
+		std::vector<Gram> grams; // Sorted, without duplicates.
+	};
+
+	static std::string normalize (const char *value);
+	static void appendGrams (const std::string &value, std::vector<Gram> &grams);
+	static std::vector<Gram> computeGrams (const LinphoneFriend *lf);
+	// Identifies the settings used by linphone_proxy_config_normalize_phone_number().
+	static std::string getPhoneNormalizationKey (LinphoneCore *lc);
+
+	void insertEntry (LinphoneFriend *lf, uint64_t sequence);
+	void rebuild ();
+
+	std::unordered_map<const LinphoneFriend *, Entry> mEntries;
+	std::unordered_map<Gram, std::vector<LinphoneFriend *>> mPostings;
+	uint64_t mSequence = 0;
+	std::string mPhoneNormalizationKey;
+};
+
+LINPHONE_END_NAMESPACE
+
+#endif // ifndef _L_FRIEND_SEARCH_INDEX_H_
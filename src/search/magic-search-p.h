@@ -41,6 +41,7 @@ private:
 	belle_sip_source_t * mIteration;
 
 	std::shared_ptr< std::list<SearchResult>> mCacheResult;
+	bool mPartialCache; // The cache only holds the best results of a limited search, it can't be used to continue a search
 	SearchAsyncData mAsyncData;
 
 	L_DECLARE_PUBLIC(MagicSearch);
@@ -17,11 +17,14 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "friend-search-index.h"
 #include "magic-search-p.h"
 #include "search-async-data.h"
 
 #include <bctoolbox/list.h>
 #include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "c-wrapper/c-wrapper.h"
 #include "c-wrapper/internal/c-tools.h"
@@ -51,6 +54,7 @@ MagicSearch::MagicSearch (const std::shared_ptr<Core> &core) : CoreAccessor(core
 	d->mDelimiter = "+_-";
 	d->mUseDelimiter = true;
 	d->mCacheResult = nullptr;
+	d->mPartialCache = false;
 	d->mIteration = nullptr;
 	d->mAutoResetCache = TRUE;
 }
@@ -213,7 +217,7 @@ list<SearchResult> MagicSearch::getContactListFromFilter (const string &filter,
 	L_D();
 	std::shared_ptr<list<SearchResult> > resultList;
 
-	if (getSearchCache() != nullptr && !filter.empty()) {
+	if (getSearchCache() != nullptr && !d->mPartialCache && !filter.empty()) {
 		resultList = continueSearch(filter, withDomain);
 		resetSearchCache();
 	} else {
@@ -229,7 +233,7 @@ bool MagicSearch::getContactListFromFilterStartAsync (const string &filter, cons
 	L_D();
 	std::shared_ptr<list<SearchResult>> returnList = nullptr;
 
-	if (getSearchCache() != nullptr && !filter.empty()) {
+	if (getSearchCache() != nullptr && !d->mPartialCache && !filter.empty()) {
 		returnList = continueSearch(filter, withDomain);
 		resetSearchCache();
 	} else {
@@ -312,24 +316,25 @@ static bool findAddress (const list<SearchResult> &list, const LinphoneAddress *
 list<SearchResult> MagicSearch::getAddressFromCallLog (
 	const string &filter,
 	const string &withDomain,
-	const list<SearchResult> &currentList
+	const unordered_set<string> &excludedAddresses
 ) const {
 	list<SearchResult> resultList;
 	const bctbx_list_t *callLog = linphone_core_get_call_logs(this->getCore()->getCCore());
 
 	// For all call log or when we reach the search limit
 	for (const bctbx_list_t *f = callLog ; f != nullptr ; f = bctbx_list_next(f)) {
+		keepBestResults(resultList, filter, getSearchLimit());
 		LinphoneCallLog *log = static_cast<LinphoneCallLog*>(f->data);
 		const LinphoneAddress *addr = (linphone_call_log_get_dir(log) == LinphoneCallDir::LinphoneCallIncoming) ?
 		linphone_call_log_get_from_address(log) : linphone_call_log_get_to_address(log);
 		if (addr && linphone_call_log_get_status(log) != LinphoneCallAborted) {
 			if (filter.empty() && withDomain.empty()) {
-				if (findAddress(currentList, addr)) continue;
+				if (excludedAddresses.count(getAddressKey(addr))) continue;
 				resultList.push_back(SearchResult(0, addr, "", nullptr));
 			} else {
 				unsigned int weight = searchInAddress(addr, filter, withDomain);
 				if (weight > getMinWeight()) {
-					if (findAddress(currentList, addr)) continue;
+					if (excludedAddresses.count(getAddressKey(addr))) continue;
 					resultList.push_back(SearchResult(weight, addr, "", nullptr));
 				}
 			}
@@ -342,13 +347,14 @@ list<SearchResult> MagicSearch::getAddressFromCallLog (
 list<SearchResult> MagicSearch::getAddressFromGroupChatRoomParticipants (
 	const string &filter,
 	const string &withDomain,
-	const list<SearchResult> &currentList
+	const unordered_set<string> &excludedAddresses
 ) const {
 	list<SearchResult> resultList;
 	const bctbx_list_t *chatRooms = linphone_core_get_chat_rooms(this->getCore()->getCCore());
 
 	// For all call log or when we reach the search limit
 	for (const bctbx_list_t *f = chatRooms ; f != nullptr ; f = bctbx_list_next(f)) {
+		keepBestResults(resultList, filter, getSearchLimit());
 		LinphoneChatRoom *room = static_cast<LinphoneChatRoom*>(f->data);
 		if (linphone_chat_room_get_capabilities(room) & LinphoneChatRoomCapabilitiesConference) {
 			bctbx_list_t *participants = linphone_chat_room_get_participants(room);
@@ -356,12 +362,12 @@ list<SearchResult> MagicSearch::getAddressFromGroupChatRoomParticipants (
 				LinphoneParticipant *participant = static_cast<LinphoneParticipant*>(p->data);
 				const LinphoneAddress *addr = linphone_address_clone(linphone_participant_get_address(participant));
 				if (filter.empty() && withDomain.empty()) {
-					if (findAddress(currentList, addr)) continue;
+					if (excludedAddresses.count(getAddressKey(addr))) continue;
 					resultList.push_back(SearchResult(0, addr, "", nullptr));
 				} else {
 					unsigned int weight = searchInAddress(addr, filter, withDomain);
 					if (weight > getMinWeight()) {
-						if (findAddress(currentList, addr)) continue;
+						if (excludedAddresses.count(getAddressKey(addr))) continue;
 						resultList.push_back(SearchResult(weight, addr, "", nullptr));
 					}
 				}
@@ -373,12 +379,12 @@ list<SearchResult> MagicSearch::getAddressFromGroupChatRoomParticipants (
 		} else if (linphone_chat_room_get_capabilities(room) & LinphoneChatRoomCapabilitiesBasic) {
 			LinphoneAddress *addr = linphone_address_clone(linphone_chat_room_get_peer_address(room));
 			if (filter.empty()) {
-				if (findAddress(currentList, addr)) continue;
+				if (excludedAddresses.count(getAddressKey(addr))) continue;
 				resultList.push_back(SearchResult(0, addr, "", nullptr));
 			} else {
 				unsigned int weight = searchInAddress(addr, filter, withDomain);
 				if (weight > getMinWeight()) {
-					if (findAddress(currentList, addr)) continue;
+					if (excludedAddresses.count(getAddressKey(addr))) continue;
 					resultList.push_back(SearchResult(weight, addr, "", nullptr));
 				}
 			}
@@ -457,27 +463,31 @@ void MagicSearch::beginNewSearchAsync (const string &filter, const string &withD
 	const bctbx_list_t *friend_lists = linphone_core_get_friends_lists(this->getCore()->getCCore());
 	asyncData->clear();
 	list<SearchResult> friendsList;
+	// The friends dropped by the search limit must not come back as addresses of the other providers. The kept ones
+	// are merged with the results of the other providers by mergeResults().
+	unordered_set<string> excludedAddresses;
 	for (const bctbx_list_t *fl = friend_lists ; fl != nullptr ; fl = bctbx_list_next(fl)) {
-		LinphoneFriendList *fList = static_cast<LinphoneFriendList*>(fl->data);
-		// For all friends or when we reach the search limit
-		for (bctbx_list_t *f = fList->friends ; f != nullptr ; f = bctbx_list_next(f)) {
-			list<SearchResult> fResults = searchInFriend(static_cast<LinphoneFriend*>(f->data), filter, withDomain);
-			addResultsToResultsList(fResults, friendsList);
-		}
+		list<SearchResult> fResults = searchInFriendList(static_cast<LinphoneFriendList*>(fl->data), filter, withDomain, &excludedAddresses);
+		addResultsToResultsList(fResults, friendsList);
+		keepBestResults(friendsList, filter, getSearchLimit(), &excludedAddresses);
 	}
 	asyncData->createResult(friendsList);
 #ifdef LDAP_ENABLED
 	getAddressFromLDAPServerStartAsync(filter, withDomain, asyncData);
 #endif
-	asyncData->createResult(getAddressFromCallLog(filter, withDomain, list<SearchResult>()));
-	asyncData->createResult(getAddressFromGroupChatRoomParticipants(filter, withDomain, list<SearchResult>()));
+	asyncData->createResult(getAddressFromCallLog(filter, withDomain, excludedAddresses));
+	asyncData->createResult(getAddressFromGroupChatRoomParticipants(filter, withDomain, excludedAddresses));
 }
 
 void MagicSearch::mergeResults (const std::string& filter, const std::string withDomain, SearchAsyncData * asyncData) {
+	L_D();
 	std::shared_ptr<list<SearchResult>> resultList = std::make_shared<list<SearchResult>>();
 	for(auto it = asyncData->mProviderResults.begin() ; it != asyncData->mProviderResults.end() ; ++it){
 		addResultsToResultsList(*it, *resultList, filter, withDomain);
 	}
+	// Only the best results are sorted. If the limit is reached, some results may have been dropped.
+	keepBestResults(*resultList, filter);
+	d->mPartialCache = getLimitedSearch() && resultList->size() >= getSearchLimit();
 	resultList->sort([](const SearchResult& lsr, const SearchResult& rsr) {
 		string name1 = getDisplayNameFromSearchResult(lsr);
 		string name2 = getDisplayNameFromSearchResult(rsr);
@@ -522,29 +532,37 @@ void MagicSearch::mergeResults (const std::string& filter, const std::string wit
 }
 
 std::shared_ptr<list<SearchResult>> MagicSearch::beginNewSearch (const string &filter, const string &withDomain) {
+	L_D();
 	list<SearchResult> clResults, crResults;
 	list<list<SearchResult>> multiClResults;
 	std::shared_ptr<list<SearchResult>> resultList = std::make_shared<list<SearchResult>>();
 	const bctbx_list_t *friend_lists = linphone_core_get_friends_lists(this->getCore()->getCCore());
 
+	// The friends dropped by the search limit must not come back as addresses of the other providers.
+	unordered_set<string> excludedAddresses;
 	for (const bctbx_list_t *fl = friend_lists ; fl != nullptr ; fl = bctbx_list_next(fl)) {
-		LinphoneFriendList *fList = static_cast<LinphoneFriendList*>(fl->data);
-		// For all friends or when we reach the search limit
-		for (bctbx_list_t *f = fList->friends ; f != nullptr ; f = bctbx_list_next(f)) {
-			list<SearchResult> fResults = searchInFriend(static_cast<LinphoneFriend*>(f->data), filter, withDomain);
-			addResultsToResultsList(fResults, *resultList);
-		}
+		list<SearchResult> fResults = searchInFriendList(static_cast<LinphoneFriendList*>(fl->data), filter, withDomain, &excludedAddresses);
+		addResultsToResultsList(fResults, *resultList);
+		keepBestResults(*resultList, filter, getSearchLimit(), &excludedAddresses);
 	}
 #ifdef LDAP_ENABLED
 	multiClResults = getAddressFromLDAPServer(filter, withDomain);
 	for(auto it = multiClResults.begin() ; it != multiClResults.end() ; ++it)
 		addResultsToResultsList(*it, *resultList, filter, withDomain);
 #endif
-	clResults = getAddressFromCallLog(filter, withDomain, *resultList);
+	for (const auto &result : *resultList)
+		excludedAddresses.insert(getAddressKey(result.getAddress()));
+	clResults = getAddressFromCallLog(filter, withDomain, excludedAddresses);
+	for (const auto &result : clResults)
+		excludedAddresses.insert(getAddressKey(result.getAddress()));
 	addResultsToResultsList(clResults, *resultList);
-	crResults = getAddressFromGroupChatRoomParticipants(filter, withDomain, *resultList);
+	crResults = getAddressFromGroupChatRoomParticipants(filter, withDomain, excludedAddresses);
 	addResultsToResultsList(crResults, *resultList);
 
+	// Only the best results are sorted. If the limit is reached, some results may have been dropped.
+	keepBestResults(*resultList, filter);
+	d->mPartialCache = getLimitedSearch() && resultList->size() >= getSearchLimit();
+
 	resultList->sort([](const SearchResult& lsr, const SearchResult& rsr) {
 		string name1 = getDisplayNameFromSearchResult(lsr);
 		string name2 = getDisplayNameFromSearchResult(rsr);
@@ -613,6 +631,31 @@ std::shared_ptr<list<SearchResult>> MagicSearch::continueSearch (const string &f
 	return resultList;
 }
 
+list<SearchResult> MagicSearch::searchInFriendList (
+	const LinphoneFriendList *fList,
+	const string &filter,
+	const string &withDomain,
+	unordered_set<string> *droppedAddresses
+) const {
+	list<SearchResult> resultList;
+	// A non-zero minimum weight makes every friend a result, the index can't narrow the search then.
+	if (fList->search_index && getMinWeight() == 0 && FriendSearchIndex::canLookup(filter)) {
+		for (const LinphoneFriend *lFriend : fList->search_index->lookup(fList->lc, filter)) {
+			list<SearchResult> fResults = searchInFriend(lFriend, filter, withDomain);
+			addResultsToResultsList(fResults, resultList);
+			keepBestResults(resultList, filter, getSearchLimit(), droppedAddresses);
+		}
+	} else {
+		// For all friends
+		for (const bctbx_list_t *f = fList->friends ; f != nullptr ; f = bctbx_list_next(f)) {
+			list<SearchResult> fResults = searchInFriend(static_cast<LinphoneFriend*>(f->data), filter, withDomain);
+			addResultsToResultsList(fResults, resultList);
+			keepBestResults(resultList, filter, getSearchLimit(), droppedAddresses);
+		}
+	}
+	return resultList;
+}
+
 list<SearchResult> MagicSearch::searchInFriend (const LinphoneFriend *lFriend, const string &filter, const string &withDomain) const{
 	list<SearchResult> friendResult;
 	string phoneNumber = "";
@@ -787,6 +830,67 @@ void MagicSearch::addResultsToResultsList (std::list<SearchResult> &results, std
 	}
 }
 
+bool MagicSearch::keepBestResults (
+	list<SearchResult> &resultList,
+	const string &filter,
+	size_t margin,
+	unordered_set<string> *droppedAddresses
+) const {
+	if (!getLimitedSearch() || resultList.size() <= getSearchLimit() + margin)
+		return false;
+
+	struct Candidate {
+		unsigned int weight;
+		string name;
+		vector<list<SearchResult>::iterator> its; // The result and its duplicates.
+	};
+	vector<Candidate> candidates;
+	unordered_map<string, size_t> candidateIndexes;
+	candidates.reserve(resultList.size());
+	for (auto it = resultList.begin(); it != resultList.end(); ++it) {
+		// Same criteria as uniqueItemsList().
+		string key = getAddressKey(it->getAddress()) + "|" + it->getPhoneNumber() + "|" + to_string(it->getCapabilities());
+
+		// Without filter every result matches, only the alphabetical order is relevant.
+		unsigned int weight = filter.empty() ? 0 : it->getWeight();
+		auto indexIt = candidateIndexes.find(key);
+		if (indexIt != candidateIndexes.end()) {
+			Candidate &candidate = candidates[indexIt->second];
+			candidate.weight = max(candidate.weight, weight);
+			candidate.its.push_back(it);
+			continue;
+		}
+
+		string name = getDisplayNameFromSearchResult(*it);
+		transform(name.begin(), name.end(), name.begin(), [](unsigned char c){ return tolower(c); });
+		candidateIndexes.emplace(move(key), candidates.size());
+		candidates.push_back({weight, move(name), {it}});
+	}
+	if (candidates.size() <= getSearchLimit())
+		return false;
+
+	// Highest weights first, then the alphabetical order used to sort the results.
+	auto limitIterator = candidates.begin() + (ptrdiff_t)getSearchLimit();
+	nth_element(candidates.begin(), limitIterator, candidates.end(), [](const Candidate &lc, const Candidate &rc) {
+		return lc.weight != rc.weight ? lc.weight > rc.weight : lc.name < rc.name;
+	});
+	for (auto it = limitIterator; it != candidates.end(); ++it) {
+		for (auto resultIt : it->its) {
+			if (droppedAddresses && resultIt->getAddress())
+				droppedAddresses->insert(getAddressKey(resultIt->getAddress()));
+			resultList.erase(resultIt);
+		}
+	}
+	return true;
+}
+
+string MagicSearch::getAddressKey (const LinphoneAddress *lAddress) {
+	if (!lAddress)
+		return string();
+	return string(L_C_TO_STRING(linphone_address_get_username(lAddress))) + "@" +
+		L_C_TO_STRING(linphone_address_get_domain(lAddress)) + ":" + to_string(linphone_address_get_port(lAddress));
+}
+
 void MagicSearch::uniqueItemsList (list<SearchResult> &list) const {
 	list.unique([](const SearchResult& lsr, const SearchResult& rsr){
 		bool sip_addresses = false;
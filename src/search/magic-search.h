@@ -24,6 +24,7 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <unordered_set>
 
 #include "core/core.h"
 #include "core/core-accessor.h"
@@ -92,6 +93,7 @@ public:
 
 	/**
 	 * Set the number of the maximum SearchResult which will be return
+	 * When the search is limited, the results with the highest weight are kept
 	 * @param[in] limit
 	 **/
 	void setSearchLimit (const unsigned int limit);
@@ -170,28 +172,28 @@ private:
 	 * Get all addresses from call log
 	 * @param[in] filter word we search
 	 * @param[in] withDomain domain which we want to search only
-	 * @param[in] currentList current list where we will check if address already exist
+	 * @param[in] excludedAddresses keys, as given by getAddressKey(), of the addresses which must not be returned
 	 * @return all addresses from call log which match in a SearchResult list
 	 * @private
 	 **/
 	std::list<SearchResult> getAddressFromCallLog (
 		const std::string &filter,
 		const std::string &withDomain,
-		const std::list<SearchResult> &currentList
+		const std::unordered_set<std::string> &excludedAddresses
 	) const;
 
 	/**
 	 * Get all addresses from chat rooms participants
 	 * @param[in] filter word we search
 	 * @param[in] withDomain domain which we want to search only
-	 * @param[in] currentList current list where we will check if address already exist
+	 * @param[in] excludedAddresses keys, as given by getAddressKey(), of the addresses which must not be returned
 	 * @return all address from chat rooms participants which match in a SearchResult list
 	 * @private
 	 **/
 	std::list<SearchResult> getAddressFromGroupChatRoomParticipants (
 		const std::string &filter,
 		const std::string &withDomain,
-		const std::list<SearchResult> &currentList
+		const std::unordered_set<std::string> &excludedAddresses
 	) const;
 
 #ifdef LDAP_ENABLED
@@ -232,6 +234,23 @@ private:
 	 **/
 	std::shared_ptr<std::list<SearchResult> > continueSearch (const std::string &filter, const std::string &withDomain) const;
 
+	/**
+	 * Search informations in the friends of a friend list
+	 * Only the friends returned by the search index of the list are checked when the filter is long enough
+	 * @param[in] fList friend list whose friends will be check
+	 * @param[in] filter word we search
+	 * @param[in] withDomain domain which we want to search only
+	 * @param[out] droppedAddresses if not null, receives the address keys of the matching results dropped by the search limit
+	 * @return list of result from the friend list
+	 * @private
+	 **/
+	std::list<SearchResult> searchInFriendList (
+		const LinphoneFriendList *fList,
+		const std::string &filter,
+		const std::string &withDomain,
+		std::unordered_set<std::string> *droppedAddresses = nullptr
+	) const;
+
 	/**
 	 * Search informations in friend given
 	 * @param[in] lFriend friend whose informations will be check
@@ -271,6 +290,32 @@ private:
 
 	void addResultsToResultsList (std::list<SearchResult> &results, std::list<SearchResult> &srL) const;
 
+	/**
+	 * Keep only the getSearchLimit() results with the highest weight when the search is limited
+	 * The order of the kept results is preserved. Results which uniqueItemsList() would merge use one slot
+	 * and are all kept.
+	 * @param[in] resultList results to reduce
+	 * @param[in] filter word we search
+	 * @param[in] margin number of results allowed over the search limit before reducing, to amortize the cost while scanning
+	 * @param[out] droppedAddresses if not null, receives the address keys of the dropped results
+	 * @return true if some results were dropped
+	 * @private
+	 **/
+	bool keepBestResults (
+		std::list<SearchResult> &resultList,
+		const std::string &filter,
+		size_t margin = 0,
+		std::unordered_set<std::string> *droppedAddresses = nullptr
+	) const;
+
+	/**
+	 * Return a key identifying an address the way linphone_address_weak_equal() compares them
+	 * @param[in] lAddress address whose key is computed, may be null
+	 * @return the key, empty for a null address
+	 * @private
+	 **/
+	static std::string getAddressKey (const LinphoneAddress *lAddress);
+
 	void uniqueItemsList (std::list<SearchResult> &list) const;
 	enum{
 		STATE_START,
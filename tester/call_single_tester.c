@@ -373,6 +373,102 @@ end:
 	linphone_core_manager_destroy(pauline);
 }
 
+static void call_with_shared_media_tickers(void) {
+	LinphoneCoreManager* marie;
+	LinphoneCoreManager* pauline;
+	int i;
+
+	marie = linphone_core_manager_new( "marie_rc");
+	pauline = linphone_core_manager_new(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc");
+	linphone_config_set_int(linphone_core_get_config(marie->lc), "misc", "shared_media_tickers", 1);
+	linphone_config_set_int(linphone_core_get_config(marie->lc), "misc", "shared_media_tickers_count", 2);
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_count(marie->lc), 0, int, "%d");
+
+	if (!BC_ASSERT_TRUE(call(marie,pauline))) goto end;
+
+	/* Testers play and record files: the audio stream runs on a shared ticker. */
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_count(marie->lc), 1, int, "%d");
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_count(pauline->lc), 0, int, "%d");
+	liblinphone_tester_check_rtcp(marie,pauline);
+	for (i = 0; i < linphone_core_get_media_ticker_count(marie->lc); i++) {
+		float load = linphone_core_get_media_ticker_load(marie->lc, i);
+		BC_ASSERT_TRUE(load >= 0 && load < 100);
+	}
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_load(marie->lc, 1), 0, float, "%f");
+
+	end_call(marie, pauline);
+	/* The ticker is destroyed with its last stream. */
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_count(marie->lc), 0, int, "%d");
+end:
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
+static void calls_paused_resumed_with_shared_media_tickers(void) {
+	LinphoneCoreManager* marie = linphone_core_manager_new("marie_rc");
+	LinphoneCoreManager* pauline = linphone_core_manager_new(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc");
+	LinphoneCoreManager* laure = linphone_core_manager_new("laure_rc_udp");
+	LinphoneCall *marie_call_pauline, *pauline_called_by_marie, *marie_call_laure, *laure_called_by_marie;
+	MSSndCardManager *sndcard_manager;
+	bctbx_list_t *lcs = NULL;
+	stats initial_marie_stat;
+	int i;
+
+	lcs = bctbx_list_append(lcs, marie->lc);
+	lcs = bctbx_list_append(lcs, pauline->lc);
+	lcs = bctbx_list_append(lcs, laure->lc);
+	linphone_config_set_int(linphone_core_get_config(marie->lc), "misc", "shared_media_tickers", 1);
+	linphone_config_set_int(linphone_core_get_config(marie->lc), "misc", "shared_media_tickers_count", 2);
+
+	if (!BC_ASSERT_TRUE(call(marie,pauline))) goto end;
+	marie_call_pauline = linphone_core_get_current_call(marie->lc);
+	pauline_called_by_marie = linphone_core_get_current_call(pauline->lc);
+	BC_ASSERT_TRUE(pause_call_1(marie,marie_call_pauline,pauline,pauline_called_by_marie));
+
+	if (!BC_ASSERT_TRUE(call(marie,laure))) goto end;
+	marie_call_laure = linphone_core_get_current_call(marie->lc);
+	laure_called_by_marie = linphone_core_get_current_call(laure->lc);
+
+	/* Each stream is placed on its own ticker while the pool has an idle one. */
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_count(marie->lc), 2, int, "%d");
+
+	/* Paused and resumed streams stay spread over the pool. */
+	BC_ASSERT_TRUE(pause_call_1(marie,marie_call_laure,laure,laure_called_by_marie));
+	initial_marie_stat = marie->stat;
+	linphone_call_resume(marie_call_pauline);
+	BC_ASSERT_TRUE(wait_for_list(lcs,&marie->stat.number_of_LinphoneCallStreamsRunning,initial_marie_stat.number_of_LinphoneCallStreamsRunning+1,5000));
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_count(marie->lc), 2, int, "%d");
+	for (i = 0; i < linphone_core_get_media_ticker_count(marie->lc); i++) {
+		float load = linphone_core_get_media_ticker_load(marie->lc, i);
+		BC_ASSERT_TRUE(load >= 0 && load < 100);
+	}
+
+	/* A stream resumed with a sound card leaves its shared ticker. */
+	sndcard_manager = ms_factory_get_snd_card_manager(linphone_core_get_ms_factory(marie->lc));
+	ms_snd_card_manager_register_desc(sndcard_manager, &dummy_test_snd_card_desc);
+	linphone_core_reload_sound_devices(marie->lc);
+	linphone_core_set_capture_device(marie->lc, DUMMY_TEST_SOUNDCARD);
+	linphone_core_set_playback_device(marie->lc, DUMMY_TEST_SOUNDCARD);
+	linphone_core_set_use_files(marie->lc, FALSE);
+
+	BC_ASSERT_TRUE(pause_call_1(marie,marie_call_pauline,pauline,pauline_called_by_marie));
+	initial_marie_stat = marie->stat;
+	linphone_call_resume(marie_call_laure);
+	BC_ASSERT_TRUE(wait_for_list(lcs,&marie->stat.number_of_LinphoneCallStreamsRunning,initial_marie_stat.number_of_LinphoneCallStreamsRunning+1,5000));
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_count(marie->lc), 1, int, "%d");
+
+	initial_marie_stat = marie->stat;
+	linphone_core_terminate_all_calls(marie->lc);
+	BC_ASSERT_TRUE(wait_for_list(lcs,&marie->stat.number_of_LinphoneCallReleased,initial_marie_stat.number_of_LinphoneCallReleased+2,10000));
+	/* The tickers are destroyed with their last stream. */
+	BC_ASSERT_EQUAL(linphone_core_get_media_ticker_count(marie->lc), 0, int, "%d");
+end:
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+	linphone_core_manager_destroy(laure);
+	bctbx_list_free(lcs);
+}
+
 static void call_with_timed_out_bye(void) {
 	LinphoneCoreManager* marie;
 	LinphoneCoreManager* pauline;
@@ -5718,6 +5814,8 @@ test_t call_tests[] = {
 	TEST_NO_TAG("Simple call without soundcard", simple_call_without_soundcard),
 	TEST_NO_TAG("Simple call with multipart INVITE body", simple_call_with_multipart_invite_body),
 	TEST_NO_TAG("Call terminated automatically by linphone_core_destroy", automatic_call_termination),
+	TEST_NO_TAG("Call with shared media tickers", call_with_shared_media_tickers),
+	TEST_NO_TAG("Calls paused and resumed with shared media tickers", calls_paused_resumed_with_shared_media_tickers),
 	TEST_NO_TAG("Call with http proxy", call_with_http_proxy),
 	TEST_NO_TAG("Call with timed-out bye", call_with_timed_out_bye),
 	TEST_NO_TAG("Direct call over IPv6", direct_call_over_ipv6),
@@ -18,6 +18,7 @@
  */
 
 #include <map>
+#include <sstream>
 #include <string>
 
 #include "c-wrapper/c-wrapper.h"
@@ -26,6 +27,7 @@
 #include "call/call.h"
 #include "conference_private.h"
 #include "conference/conference-listener.h"
+#include "conference/handlers/local-audio-video-conference-event-handler.h"
 #include "conference/handlers/local-conference-event-handler.h"
 #include "conference/handlers/remote-conference-event-handler.h"
 #include "conference/local-conference.h"
@@ -570,6 +572,8 @@ static const char *frankUri = "sip:frank@example.com";
 static const char *confUri = "sips:conf233@example.com";
 
 L_ENABLE_ATTR_ACCESS(LocalConference, shared_ptr<LocalConferenceEventHandler>, eventHandler);
+using MediaLocalConference = MediaConference::LocalConference;
+L_ENABLE_ATTR_ACCESS(MediaLocalConference, shared_ptr<LocalAudioVideoConferenceEventHandler>, eventHandler);
 
 class ConferenceEventTester : public RemoteConference {
 public:
@@ -858,6 +862,117 @@ void first_notify_with_extensions_parsing() {
 	linphone_core_manager_destroy(marie);
 }
 
+void first_notify_with_many_users_parsing() {
+	const int nbUsers = 500;
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneAddress *confAddress = linphone_core_interpret_url(marie->lc, confUri);
+	char *confAddressStr = linphone_address_as_string(confAddress);
+	Address addr(confAddressStr);
+	bctbx_free(confAddressStr);
+	linphone_address_unref(confAddress);
+	shared_ptr<ConferenceEventTester> tester = make_shared<ConferenceEventTester>(marie->lc->cppPtr, addr);
+
+	const_cast<ConferenceAddress &>(tester->handler->getConferenceId().getPeerAddress()) = ConferenceAddress(addr);
+
+	// Full state of a large conference, read user by user.
+	ostringstream notify;
+	notify << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+		<< "<conference-info xmlns=\"urn:ietf:params:xml:ns:conference-info\" entity=\"" << confUri << "\" state=\"full\" version=\"1\">"
+		<< "<conference-description><subject>Large conference</subject></conference-description>"
+		<< "<users>";
+	for (int i = 0; i < nbUsers; i++) {
+		notify << "<user entity=\"sip:user" << i << "@example.com\" state=\"full\">"
+			<< "<roles><entry>participant</entry>" << (i == 0 ? "<entry>admin</entry>" : "") << "</roles>"
+			<< "<endpoint entity=\"sip:user" << i << "@example.com;gr=" << i << "\" state=\"full\">"
+			<< "<display-text>Device " << i << "</display-text>"
+			<< "<media id=\"1\"><type>audio</type><src-id>" << (1000 + i) << "</src-id><status>sendrecv</status></media>"
+			<< "</endpoint>"
+			<< "</user>";
+	}
+	notify << "</users></conference-info>";
+
+	Content content;
+	content.setBodyFromUtf8(notify.str());
+	content.setContentType(ContentType::ConferenceInfo);
+	tester->handler->notifyReceived(content);
+
+	BC_ASSERT_EQUAL(tester->getParticipantCount(), nbUsers, int, "%d");
+	BC_ASSERT_EQUAL((int)tester->getLastNotify(), 1, int, "%d");
+	BC_ASSERT_STRING_EQUAL(tester->getSubject().c_str(), "Large conference");
+
+	shared_ptr<Participant> admin = tester->findParticipant(IdentityAddress("sip:user0@example.com"));
+	shared_ptr<Participant> last = tester->findParticipant(IdentityAddress("sip:user" + to_string(nbUsers - 1) + "@example.com"));
+	if (BC_ASSERT_PTR_NOT_NULL(admin) && BC_ASSERT_PTR_NOT_NULL(last)) {
+		BC_ASSERT_TRUE(admin->isAdmin());
+		BC_ASSERT_FALSE(last->isAdmin());
+		BC_ASSERT_EQUAL((int)last->getDevices().size(), 1, int, "%d");
+		if (!last->getDevices().empty()) {
+			BC_ASSERT_EQUAL((int)last->getDevices().front()->getSsrc(), 1000 + nbUsers - 1, int, "%d");
+			BC_ASSERT_STRING_EQUAL(last->getDevices().front()->getName().c_str(), ("Device " + to_string(nbUsers - 1)).c_str());
+		}
+	}
+
+	tester = nullptr;
+	linphone_core_manager_destroy(marie);
+}
+
+void truncated_notify_parsing() {
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneAddress *confAddress = linphone_core_interpret_url(marie->lc, confUri);
+	char *confAddressStr = linphone_address_as_string(confAddress);
+	Address addr(confAddressStr);
+	bctbx_free(confAddressStr);
+	linphone_address_unref(confAddress);
+	shared_ptr<ConferenceEventTester> tester = make_shared<ConferenceEventTester>(marie->lc->cppPtr, addr);
+
+	const_cast<ConferenceAddress &>(tester->handler->getConferenceId().getPeerAddress()) = ConferenceAddress(addr);
+
+	auto createNotify = [](const string &state, unsigned int version, int firstUser, int nbUsers) {
+		ostringstream notify;
+		notify << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+			<< "<conference-info xmlns=\"urn:ietf:params:xml:ns:conference-info\" entity=\"" << confUri << "\" state=\"" << state << "\" version=\"" << version << "\">"
+			<< "<users>";
+		for (int i = firstUser; i < firstUser + nbUsers; i++) {
+			notify << "<user entity=\"sip:user" << i << "@example.com\" state=\"full\">"
+				<< "<endpoint entity=\"sip:user" << i << "@example.com;gr=" << i << "\" state=\"full\"/>"
+				<< "</user>";
+		}
+		notify << "</users></conference-info>";
+		return notify.str();
+	};
+	auto receiveNotify = [&tester](const string &notify) {
+		Content content;
+		content.setBodyFromUtf8(notify);
+		content.setContentType(ContentType::ConferenceInfo);
+		tester->handler->notifyReceived(content);
+	};
+	// Cut the document in the middle of its last user.
+	auto truncate = [](const string &notify) {
+		return notify.substr(0, notify.rfind("<endpoint"));
+	};
+
+	receiveNotify(createNotify("full", 1, 0, 3));
+	BC_ASSERT_EQUAL(tester->getParticipantCount(), 3, int, "%d");
+	BC_ASSERT_EQUAL((int)tester->getLastNotify(), 1, int, "%d");
+
+	// A truncated partial notify is not applied at all.
+	receiveNotify(truncate(createNotify("partial", 2, 3, 2)));
+	BC_ASSERT_EQUAL(tester->getParticipantCount(), 3, int, "%d");
+	BC_ASSERT_TRUE(tester->participants.empty());
+	BC_ASSERT_EQUAL((int)tester->getLastNotify(), 1, int, "%d");
+
+	// A truncated full state leaves the conference partly updated: a full state must be requested again.
+	receiveNotify(truncate(createNotify("full", 3, 0, 5)));
+	BC_ASSERT_EQUAL((int)tester->getLastNotify(), 0, int, "%d");
+
+	receiveNotify(createNotify("full", 4, 0, 5));
+	BC_ASSERT_EQUAL(tester->getParticipantCount(), 5, int, "%d");
+	BC_ASSERT_EQUAL((int)tester->getLastNotify(), 4, int, "%d");
+
+	tester = nullptr;
+	linphone_core_manager_destroy(marie);
+}
+
 void first_notify_parsing_wrong_conf() {
 	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
 	LinphoneAddress *confAddress = linphone_core_interpret_url(marie->lc, "sips:conf322@example.com");
@@ -1593,6 +1708,152 @@ void send_added_notify_through_call() {
 
 }
 
+void send_notify_body_shared_by_devices() {
+	LinphoneCoreManager *pauline = create_mgr_for_conference(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc", TRUE);
+	LinphoneCoreManager *marie = NULL;
+	LinphoneCoreManager *laure = NULL;
+	LinphoneCoreManager *chloe = NULL;
+
+	bctbx_list_t *lcs = NULL;
+	lcs = bctbx_list_append(lcs, pauline->lc);
+
+	bctbx_list_t *mgrs = NULL;
+	mgrs = bctbx_list_append(mgrs, pauline);
+
+	char *identityStr = linphone_address_as_string(pauline->identity);
+	Address addr(identityStr);
+	bctbx_free(identityStr);
+	stats initialPaulineStats = pauline->stat;
+	{
+		shared_ptr<MediaConference::LocalConference> localConf = std::shared_ptr<MediaConference::LocalConference>(new MediaConference::LocalConference(pauline->lc->cppPtr, addr, nullptr, ConferenceParams::create(pauline->lc)), [](MediaConference::LocalConference * c){c->unref();});
+
+		BC_ASSERT_TRUE(wait_for_list(lcs, &pauline->stat.number_of_LinphoneConferenceStateCreationPending, initialPaulineStats.number_of_LinphoneConferenceStateCreationPending + 1, 5000));
+
+		std::shared_ptr<ConferenceListenerInterfaceTester> confListener = std::make_shared<ConferenceListenerInterfaceTester>();
+		localConf->addListener(confListener);
+
+		marie = create_core_and_add_to_conference("marie_rc", &mgrs, &lcs, confListener, localConf, pauline, FALSE);
+		laure = create_core_and_add_to_conference((liblinphone_tester_ipv6_available()) ? "laure_tcp_rc" : "laure_rc_udp", &mgrs, &lcs, confListener, localConf, pauline, FALSE);
+		chloe = create_core_and_add_to_conference("chloe_rc", &mgrs, &lcs, confListener, localConf, pauline, FALSE);
+
+		LocalConferenceEventHandler *localHandler = (L_ATTR_GET(localConf.get(), eventHandler)).get();
+		if (BC_ASSERT_PTR_NOT_NULL(localHandler)) {
+			const LocalConferenceEventHandler::NotifyStats initialNotifyStats = localHandler->getNotifyStats();
+			stats initialMarieStats = marie->stat;
+			stats initialLaureStats = laure->stat;
+			stats initialChloeStats = chloe->stat;
+
+			localConf->setSubject("One body for all devices");
+
+			BC_ASSERT_TRUE(wait_for_list(lcs, &marie->stat.number_of_NotifyReceived, initialMarieStats.number_of_NotifyReceived + 1, 5000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &laure->stat.number_of_NotifyReceived, initialLaureStats.number_of_NotifyReceived + 1, 5000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &chloe->stat.number_of_NotifyReceived, initialChloeStats.number_of_NotifyReceived + 1, 5000));
+
+			// The three subscribed devices got a NOTIFY built from one body.
+			const LocalConferenceEventHandler::NotifyStats &notifyStats = localHandler->getNotifyStats();
+			BC_ASSERT_EQUAL(notifyStats.bodies, initialNotifyStats.bodies + 1, unsigned int, "%u");
+			BC_ASSERT_EQUAL(notifyStats.notifies, initialNotifyStats.notifies + 3, unsigned int, "%u");
+			BC_ASSERT_GREATER(notifyStats.bodiesSize, initialNotifyStats.bodiesSize + 1, size_t, "%zu");
+		}
+
+		localConf->terminate();
+
+		for (bctbx_list_t *it = mgrs; it; it = bctbx_list_next(it)) {
+			LinphoneCoreManager * m = reinterpret_cast<LinphoneCoreManager *>(bctbx_list_get_data(it));
+			// Wait for all calls to be terminated
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneCallEnd, (int)bctbx_list_size(linphone_core_get_calls(m->lc)), 5000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneCallReleased, (int)bctbx_list_size(linphone_core_get_calls(m->lc)), 5000));
+
+			// Wait for all conferences to be terminated
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneConferenceStateTerminationPending, m->stat.number_of_LinphoneConferenceStateCreated, 5000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneConferenceStateTerminated, m->stat.number_of_LinphoneConferenceStateCreated, 5000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneConferenceStateDeleted, m->stat.number_of_LinphoneConferenceStateCreated, 5000));
+		}
+	}
+
+	destroy_mgr_in_conference(marie);
+	destroy_mgr_in_conference(laure);
+	destroy_mgr_in_conference(chloe);
+	destroy_mgr_in_conference(pauline);
+
+	bctbx_list_free(lcs);
+	bctbx_list_free(mgrs);
+}
+
+void send_aggregated_notifies_with_joining_device() {
+	LinphoneCoreManager *pauline = create_mgr_for_conference(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc", TRUE);
+	LinphoneCoreManager *marie = NULL;
+	LinphoneCoreManager *laure = NULL;
+	// Large enough for the window not to expire during the test.
+	linphone_config_set_int(linphone_core_get_config(pauline->lc), "misc", "conference_notify_aggregation_window", 60000);
+
+	bctbx_list_t *lcs = NULL;
+	lcs = bctbx_list_append(lcs, pauline->lc);
+
+	bctbx_list_t *mgrs = NULL;
+	mgrs = bctbx_list_append(mgrs, pauline);
+
+	char *identityStr = linphone_address_as_string(pauline->identity);
+	Address addr(identityStr);
+	bctbx_free(identityStr);
+	stats initialPaulineStats = pauline->stat;
+	{
+		shared_ptr<MediaConference::LocalConference> localConf = std::shared_ptr<MediaConference::LocalConference>(new MediaConference::LocalConference(pauline->lc->cppPtr, addr, nullptr, ConferenceParams::create(pauline->lc)), [](MediaConference::LocalConference * c){c->unref();});
+
+		BC_ASSERT_TRUE(wait_for_list(lcs, &pauline->stat.number_of_LinphoneConferenceStateCreationPending, initialPaulineStats.number_of_LinphoneConferenceStateCreationPending + 1, 5000));
+
+		std::shared_ptr<ConferenceListenerInterfaceTester> confListener = std::make_shared<ConferenceListenerInterfaceTester>();
+		localConf->addListener(confListener);
+
+		marie = create_core_and_add_to_conference("marie_rc", &mgrs, &lcs, confListener, localConf, pauline, FALSE);
+
+		// This change waits for the window to expire when Laure joins.
+		localConf->setSubject("Subject set before Laure joins");
+
+		// The NOTIFYs sent on Laure's SUBSCRIBE must not be received before the pending changes.
+		laure = create_core_and_add_to_conference((liblinphone_tester_ipv6_available()) ? "laure_tcp_rc" : "laure_rc_udp", &mgrs, &lcs, confListener, localConf, pauline, FALSE);
+
+		LocalConferenceEventHandler *localHandler = (L_ATTR_GET(localConf.get(), eventHandler)).get();
+		if (BC_ASSERT_PTR_NOT_NULL(localHandler))
+			localHandler->flushPendingNotifies();
+		wait_for_list(lcs, NULL, 0, 1000);
+
+		// Marie has seen every change, in order.
+		LinphoneConference *marieConference = linphone_core_get_conference(marie->lc);
+		if (BC_ASSERT_PTR_NOT_NULL(marieConference)) {
+			BC_ASSERT_STRING_EQUAL(linphone_conference_get_subject(marieConference), "Subject set before Laure joins");
+			BC_ASSERT_PTR_NOT_NULL(linphone_conference_find_participant(marieConference, laure->identity));
+			BC_ASSERT_EQUAL(MediaConference::Conference::toCpp(marieConference)->getLastNotify(), localConf->getLastNotify(), unsigned int, "%u");
+		}
+		LinphoneConference *laureConference = linphone_core_get_conference(laure->lc);
+		if (BC_ASSERT_PTR_NOT_NULL(laureConference)) {
+			BC_ASSERT_STRING_EQUAL(linphone_conference_get_subject(laureConference), "Subject set before Laure joins");
+			BC_ASSERT_EQUAL(MediaConference::Conference::toCpp(laureConference)->getLastNotify(), localConf->getLastNotify(), unsigned int, "%u");
+		}
+
+		localConf->terminate();
+
+		for (bctbx_list_t *it = mgrs; it; it = bctbx_list_next(it)) {
+			LinphoneCoreManager * m = reinterpret_cast<LinphoneCoreManager *>(bctbx_list_get_data(it));
+			// Wait for all calls to be terminated
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneCallEnd, (int)bctbx_list_size(linphone_core_get_calls(m->lc)), 5000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneCallReleased, (int)bctbx_list_size(linphone_core_get_calls(m->lc)), 5000));
+
+			// Wait for all conferences to be terminated
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneConferenceStateTerminationPending, m->stat.number_of_LinphoneConferenceStateCreated, 5000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneConferenceStateTerminated, m->stat.number_of_LinphoneConferenceStateCreated, 5000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &m->stat.number_of_LinphoneConferenceStateDeleted, m->stat.number_of_LinphoneConferenceStateCreated, 5000));
+		}
+	}
+
+	destroy_mgr_in_conference(marie);
+	destroy_mgr_in_conference(laure);
+	destroy_mgr_in_conference(pauline);
+
+	bctbx_list_free(lcs);
+	bctbx_list_free(mgrs);
+}
+
 void send_removed_notify_through_call() {
 	LinphoneCoreManager *pauline = create_mgr_for_conference(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc", TRUE);
 	LinphoneCoreManager *marie = NULL;
@@ -1863,6 +2124,105 @@ void send_subject_changed_notify () {
 	BC_ASSERT_TRUE(confListener->participants.find(aliceAddr.asString())->second);
 	BC_ASSERT_EQUAL(localConf->getLastNotify(), (lastNotifyCount + 1), int, "%d");
 
+	// No device subscribed to the conference, no NOTIFY body must have been built.
+	LocalConferenceEventHandler *localHandler = (L_ATTR_GET(localConf.get(), eventHandler)).get();
+	BC_ASSERT_EQUAL(localHandler->getNotifyStats().bodies, 0, unsigned int, "%u");
+	BC_ASSERT_EQUAL(localHandler->getNotifyStats().notifies, 0, unsigned int, "%u");
+
+	localConf = nullptr;
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
+void send_missed_notifies_from_cache () {
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneCoreManager *pauline = linphone_core_manager_new(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc");
+	linphone_config_set_int(linphone_core_get_config(pauline->lc), "misc", "conference_notify_cache_size", 2);
+	char *identityStr = linphone_address_as_string(pauline->identity);
+	Address addr(identityStr);
+	bctbx_free(identityStr);
+	shared_ptr<LocalConferenceTester> localConf = make_shared<LocalConferenceTester>(pauline->lc->cppPtr, addr, nullptr);
+	std::shared_ptr<ConferenceListenerInterfaceTester> confListener = std::make_shared<ConferenceListenerInterfaceTester>();
+	localConf->addListener(confListener);
+	LinphoneAddress *cBobAddr = linphone_core_interpret_url(marie->lc, bobUri);
+	char *bobAddrStr = linphone_address_as_string(cBobAddr);
+	Address bobAddr(bobAddrStr);
+	bctbx_free(bobAddrStr);
+	linphone_address_unref(cBobAddr);
+
+	localConf->addParticipant(bobAddr);
+	localConf->setConferenceAddress(ConferenceAddress(addr));
+	LocalConferenceEventHandler *localHandler = (L_ATTR_GET(localConf.get(), eventHandler)).get();
+
+	unsigned int lastNotifyCount = localConf->getLastNotify();
+	localConf->setSubject("First subject");
+	localConf->setSubject("Second subject");
+	BC_ASSERT_EQUAL(localConf->getLastNotify(), (lastNotifyCount + 2), int, "%d");
+
+	// Both partial NOTIFY bodies are still in the cache.
+	string notify = localHandler->createNotifyMissed(static_cast<int>(lastNotifyCount), NULL);
+	BC_ASSERT_TRUE(notify.find(MultipartBoundary) != string::npos);
+	BC_ASSERT_TRUE(notify.find("First subject") != string::npos);
+	BC_ASSERT_TRUE(notify.find("Second subject") != string::npos);
+
+	// The first body has been evicted, the catch-up falls back to a full state.
+	localConf->setSubject("Third subject");
+	notify = localHandler->createNotifyMissed(static_cast<int>(lastNotifyCount), NULL);
+	BC_ASSERT_TRUE(notify.find(MultipartBoundary) == string::npos);
+	BC_ASSERT_TRUE(notify.find("state=\"full\"") != string::npos);
+	BC_ASSERT_TRUE(notify.find("Third subject") != string::npos);
+
+	// The last two bodies can still be served from the cache.
+	notify = localHandler->createNotifyMissed(static_cast<int>(lastNotifyCount + 1), NULL);
+	BC_ASSERT_TRUE(notify.find(MultipartBoundary) != string::npos);
+	BC_ASSERT_TRUE(notify.find("First subject") == string::npos);
+	BC_ASSERT_TRUE(notify.find("Third subject") != string::npos);
+
+	localConf = nullptr;
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
+void send_aggregated_notifies () {
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneCoreManager *pauline = linphone_core_manager_new(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc");
+	// Large enough for the window not to expire during the test.
+	linphone_config_set_int(linphone_core_get_config(pauline->lc), "misc", "conference_notify_aggregation_window", 60000);
+	char *identityStr = linphone_address_as_string(pauline->identity);
+	Address addr(identityStr);
+	bctbx_free(identityStr);
+	shared_ptr<LocalConferenceTester> localConf = make_shared<LocalConferenceTester>(pauline->lc->cppPtr, addr, nullptr);
+	std::shared_ptr<ConferenceListenerInterfaceTester> confListener = std::make_shared<ConferenceListenerInterfaceTester>();
+	localConf->addListener(confListener);
+	LinphoneAddress *cBobAddr = linphone_core_interpret_url(marie->lc, bobUri);
+	char *bobAddrStr = linphone_address_as_string(cBobAddr);
+	Address bobAddr(bobAddrStr);
+	bctbx_free(bobAddrStr);
+	linphone_address_unref(cBobAddr);
+
+	localConf->addParticipant(bobAddr);
+	localConf->setConferenceAddress(ConferenceAddress(addr));
+	LocalConferenceEventHandler *localHandler = (L_ATTR_GET(localConf.get(), eventHandler)).get();
+	localHandler->flushPendingNotifies();
+	unsigned int aggregatedChanges = localHandler->getNotifyStats().aggregatedChanges;
+
+	unsigned int lastNotifyCount = localConf->getLastNotify();
+	localConf->setSubject("First subject");
+	localConf->setSubject("Second subject");
+	localConf->setSubject("Third subject");
+
+	// Each change keeps its own notify id.
+	BC_ASSERT_EQUAL(localConf->getLastNotify(), (lastNotifyCount + 3), int, "%d");
+	string notify = localHandler->createNotifyMissed(static_cast<int>(lastNotifyCount + 1), NULL);
+	BC_ASSERT_TRUE(notify.find("First subject") == string::npos);
+	BC_ASSERT_TRUE(notify.find("Second subject") != string::npos);
+	BC_ASSERT_TRUE(notify.find("Third subject") != string::npos);
+
+	localHandler->flushPendingNotifies();
+	BC_ASSERT_EQUAL(localHandler->getNotifyStats().aggregatedChanges, aggregatedChanges + 3, unsigned int, "%u");
+	localHandler->flushPendingNotifies();
+	BC_ASSERT_EQUAL(localHandler->getNotifyStats().aggregatedChanges, aggregatedChanges + 3, unsigned int, "%u");
+
 	localConf = nullptr;
 	linphone_core_manager_destroy(marie);
 	linphone_core_manager_destroy(pauline);
@@ -2020,6 +2380,8 @@ test_t conference_event_tests[] = {
 	TEST_NO_TAG("First notify parsing", first_notify_parsing),
 	TEST_NO_TAG("First notify with extensions parsing", first_notify_with_extensions_parsing),
 	TEST_NO_TAG("First notify parsing wrong conf", first_notify_parsing_wrong_conf),
+	TEST_NO_TAG("First notify with many users parsing", first_notify_with_many_users_parsing),
+	TEST_NO_TAG("Truncated notify parsing", truncated_notify_parsing),
 	TEST_NO_TAG("Participant added", participant_added_parsing),
 	TEST_NO_TAG("Participant not added", participant_not_added_parsing),
 	TEST_NO_TAG("Participant deleted", participant_deleted_parsing),
@@ -2033,6 +2395,10 @@ test_t conference_event_tests[] = {
 	TEST_NO_TAG("Send participant admined notify", send_admined_notify),
 	TEST_NO_TAG("Send participant unadmined notify", send_unadmined_notify),
 	TEST_NO_TAG("Send subject changed notify", send_subject_changed_notify),
+	TEST_NO_TAG("Send notify body shared by devices", send_notify_body_shared_by_devices),
+	TEST_NO_TAG("Send missed notifies from cache", send_missed_notifies_from_cache),
+	TEST_NO_TAG("Send aggregated notifies", send_aggregated_notifies),
+	TEST_NO_TAG("Send aggregated notifies with joining device", send_aggregated_notifies_with_joining_device),
 	TEST_NO_TAG("Send device added notify", send_device_added_notify),
 	TEST_NO_TAG("Send device removed notify", send_device_removed_notify),
 	TEST_NO_TAG("one-to-one keyword", one_to_one_keyword)
@@ -0,0 +1,551 @@
+/*
+ * Copyright (c) 2010-2021 Belledonne Communications SARL.
+ *
+ * This file is part of Liblinphone.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "address/identity-address.h"
+#include "conference/handlers/local-conference-event-handler.h"
+#include "conference/local-conference.h"
+#include "conference/participant.h"
+#include "conference/session/mixers.h"
+#include "liblinphone_tester.h"
+#include "linphone/core.h"
+#include "private.h"
+#include "tester_utils.h"
+#include "tools/private-access.h"
+
+// =============================================================================
+
+using namespace LinphonePrivate;
+using namespace std;
+
+static FILE *log_file = NULL;
+
+// The benchmark is run for min_participants, then twice as many participants each time, up to max_participants.
+static int min_participants = 10;
+static int max_participants = 320;
+static int nb_devices = 2;
+static int nb_messages = 5;
+static int nb_notify_iterations = 10;
+
+// The audio mixing benchmark is run the same way, without then with partitioned mixing.
+static int audio_min_participants = 8;
+static int audio_max_participants = 256;
+static int mixer_partition_size = 16;
+static int mixing_duration = 5;
+
+L_ENABLE_ATTR_ACCESS(LocalConference, shared_ptr<LocalConferenceEventHandler>, eventHandler);
+
+// Local conference whose participants and devices are simulated, no session is created for them.
+class LocalConferenceBenchmark : public LocalConference {
+public:
+	LocalConferenceBenchmark (const shared_ptr<Core> &core, const IdentityAddress &myAddress) : LocalConference(core, myAddress, nullptr, ConferenceParams::create(core->getCCore())) {}
+
+	void populate (int participants, int devices) {
+		for (int i = 0; i < participants; i++) {
+			IdentityAddress addr("sip:user_" + to_string(i) + "@127.0.0.1");
+			LocalConference::addParticipant(addr);
+			shared_ptr<Participant> participant = findParticipant(addr);
+			if (!participant)
+				continue;
+			for (int j = 0; j < devices; j++) {
+				Address gruu(addr.asAddress());
+				gruu.setUriParam("gr", "urn:uuid:" + to_string(i) + "-" + to_string(j));
+				participant->addDevice(IdentityAddress(gruu));
+			}
+		}
+	}
+};
+
+struct BenchmarkResult {
+	int participants = 0;
+	double fullStateNotifyMs = 0;
+	size_t fullStateNotifySize = 0;
+	double partialNotifyUs = 0;
+	double messagesPerSecond = 0;
+	int messagesReceived = 0;
+	double dbWriteUs = 0;
+	double dbWriteMaxUs = 0;
+	double memoryPerParticipantKb = 0;
+};
+
+// Remote participants of an MS2AudioMixer simulated by audio streams of the mixer side, each one fed with PCMU by
+// an RTP session of the benchmark, as a call joined to a local conference would be.
+class AudioMixerBenchmark {
+public:
+	AudioMixerBenchmark (LinphoneCore *lc, int partitionSize) {
+		linphone_config_set_int(linphone_core_get_config(lc), "sound", "conference_mixer_partition_size", partitionSize);
+		mSession.reset(new MixerSession(*lc->cppPtr));
+		mMixer = dynamic_cast<MS2AudioMixer *>(mSession->getMixerByType(SalAudio));
+		mFactory = lc->factory;
+		for (size_t i = 0; i < sizeof(mPayload); i++)
+			mPayload[i] = (uint8_t)bctbx_random();
+	}
+
+	~AudioMixerBenchmark () {
+		for (auto &participant : mParticipants) {
+			mMixer->removeMember(participant.endpoint);
+			ms_audio_endpoint_release_from_stream(participant.endpoint);
+			audio_stream_stop(participant.stream);
+			rtp_session_destroy(participant.sender);
+		}
+		mSession.reset();
+	}
+
+	bool addParticipant () {
+		Participant participant;
+		participant.stream = audio_stream_new2(mFactory, "127.0.0.1", -1, -1);
+		if (!participant.stream)
+			return false;
+		participant.sender = rtp_session_new(RTP_SESSION_SENDRECV);
+		rtp_session_set_local_addr(participant.sender, "127.0.0.1", -1, -1);
+		rtp_session_set_profile(participant.sender, &av_profile);
+		rtp_session_set_payload_type(participant.sender, 0);
+		rtp_session_set_remote_addr(participant.sender, "127.0.0.1", rtp_session_get_local_port(participant.stream->ms.sessions.rtp_session));
+		audio_stream_start_full(participant.stream, &av_profile, "127.0.0.1", rtp_session_get_local_port(participant.sender),
+			"127.0.0.1", 0, 0, 60, nullptr, nullptr, nullptr, nullptr, FALSE);
+		participant.endpoint = ms_audio_endpoint_get_from_stream(participant.stream, TRUE);
+		mMixer->addMember(participant.endpoint, false);
+		mParticipants.push_back(participant);
+		return true;
+	}
+
+	// One 20 ms PCMU packet for each participant.
+	void sendPackets () {
+		for (auto &participant : mParticipants)
+			rtp_session_send_with_ts(participant.sender, mPayload, (int)sizeof(mPayload), mTimestamp);
+		mTimestamp += sizeof(mPayload);
+	}
+
+	size_t getParticipantCount () const {
+		return mParticipants.size();
+	}
+
+	size_t getPartitionCount () const {
+		return mMixer->getPartitionCount();
+	}
+
+private:
+	struct Participant {
+		AudioStream *stream = nullptr;
+		MSAudioEndpoint *endpoint = nullptr;
+		RtpSession *sender = nullptr;
+	};
+
+	unique_ptr<MixerSession> mSession;
+	MS2AudioMixer *mMixer = nullptr;
+	MSFactory *mFactory = nullptr;
+	vector<Participant> mParticipants;
+	uint8_t mPayload[160];
+	uint32_t mTimestamp = 0;
+};
+
+struct MixingResult {
+	int participants = 0;
+	int partitionSize = 0;
+	size_t partitions = 0;
+	double cpuPercent = 0; // Of one core.
+	double participantsPerCore = 0;
+};
+
+using Clock = chrono::steady_clock;
+
+static double elapsed_us (Clock::time_point start) {
+	return (double)chrono::duration_cast<chrono::microseconds>(Clock::now() - start).count();
+}
+
+// Resident memory of the process in kB, 0 if it is not available on this platform.
+static long get_resident_memory_kb (void) {
+#ifdef __linux__
+	long pages = 0, residentPages = 0;
+	FILE *statm = fopen("/proc/self/statm", "r");
+	if (!statm)
+		return 0;
+	if (fscanf(statm, "%ld %ld", &pages, &residentPages) != 2)
+		residentPages = 0;
+	fclose(statm);
+	return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+	return 0;
+#endif
+}
+
+// CPU time used by all the threads of the process in us, 0 if it is not available on this platform.
+static double get_process_cpu_us (void) {
+#ifdef __linux__
+	struct timespec ts;
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+		return 0;
+	return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+#else
+	return 0;
+#endif
+}
+
+static void log_handler (int lev, const char *fmt, va_list args) {
+#ifdef _WIN32
+	vfprintf(lev == ORTP_ERROR ? stderr : stdout, fmt, args);
+	fprintf(lev == ORTP_ERROR ? stderr : stdout, "\n");
+#else
+	va_list cap;
+	va_copy(cap, args);
+	/* We must use stdio to avoid log formatting (for autocompletion etc.) */
+	vfprintf(lev == ORTP_ERROR ? stderr : stdout, fmt, cap);
+	fprintf(lev == ORTP_ERROR ? stderr : stdout, "\n");
+	va_end(cap);
+#endif
+	bctbx_logv(BCTBX_LOG_DOMAIN, (BctbxLogLevel)lev, fmt, args);
+}
+
+static int conference_benchmark_set_log_file (const char *filename) {
+	if (log_file) {
+		fclose(log_file);
+	}
+	log_file = fopen(filename, "w");
+	if (!log_file) {
+		ms_error("Cannot open file [%s] for writing logs because [%s]", filename, strerror(errno));
+		return -1;
+	}
+	ms_message("Redirecting traces to file [%s]", filename);
+	linphone_core_set_log_file(log_file);
+	return 0;
+}
+
+static int silent_arg_func (const char *arg) {
+	linphone_core_set_log_level(ORTP_FATAL);
+	return 0;
+}
+
+static int verbose_arg_func (const char *arg) {
+	linphone_core_set_log_level(ORTP_MESSAGE);
+	return 0;
+}
+
+static int logfile_arg_func (const char *arg) {
+	if (conference_benchmark_set_log_file(arg) < 0) return -2;
+	return 0;
+}
+
+// Time taken to build the bodies of the conference event package NOTIFYs and memory footprint of a conference of the
+// given size. The bodies are only built, no NOTIFY is sent.
+static void measure_conference (LinphoneCoreManager *focus, BenchmarkResult &result) {
+	long memoryBefore = get_resident_memory_kb();
+	char *focusUri = linphone_address_as_string_uri_only(focus->identity);
+	IdentityAddress focusAddr(focusUri);
+	bctbx_free(focusUri);
+	shared_ptr<LocalConferenceBenchmark> conference = make_shared<LocalConferenceBenchmark>(focus->lc->cppPtr, focusAddr);
+	conference->populate(result.participants, nb_devices);
+	conference->setConferenceAddress(ConferenceAddress(focusAddr));
+	long memoryAfter = get_resident_memory_kb();
+	BC_ASSERT_EQUAL((int)conference->getParticipantCount(), result.participants, int, "%d");
+	result.memoryPerParticipantKb = (double)(memoryAfter - memoryBefore) / result.participants;
+
+	LocalConferenceEventHandler *handler = (L_ATTR_GET(conference.get(), eventHandler)).get();
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < nb_notify_iterations; i++) {
+		string notify = handler->createNotifyFullState(NULL);
+		result.fullStateNotifySize = notify.size();
+	}
+	result.fullStateNotifyMs = elapsed_us(start) / nb_notify_iterations / 1000.;
+
+	Address participantAddr("sip:user_0@127.0.0.1");
+	start = Clock::now();
+	for (int i = 0; i < nb_notify_iterations; i++)
+		handler->createNotifyParticipantAdded(participantAddr);
+	result.partialNotifyUs = elapsed_us(start) / nb_notify_iterations;
+
+	conference = nullptr;
+}
+
+// Messages sent from the sender to one basic chat room per participant of the receiver, over the loopback SIP transport.
+// Each message is sent by the sender itself: this is the throughput of one to one messages, not of the fan-out of a
+// server group chat room.
+static void measure_one_to_one_messages (LinphoneCoreManager *sender, LinphoneCoreManager *receiver, bctbx_list_t *coresList, BenchmarkResult &result) {
+	LinphoneSipTransports transports;
+	linphone_core_get_sip_transports_used(receiver->lc, &transports);
+
+	vector<LinphoneChatRoom *> chatRooms;
+	for (int i = 0; i < result.participants; i++) {
+		char *uri = bctbx_strdup_printf("sip:user_%d@127.0.0.1:%d;transport=tcp", i, transports.tcp_port);
+		LinphoneAddress *addr = linphone_address_new(uri);
+		bctbx_free(uri);
+		chatRooms.push_back(linphone_core_get_chat_room(sender->lc, addr));
+		linphone_address_unref(addr);
+	}
+
+	stats initialStats = receiver->stat;
+	stats initialSenderStats = sender->stat;
+	int expected = result.participants * nb_messages;
+	vector<LinphoneChatMessage *> messages;
+	messages.reserve((size_t)expected);
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < nb_messages; i++) {
+		for (LinphoneChatRoom *chatRoom : chatRooms) {
+			LinphoneChatMessage *msg = linphone_chat_room_create_message_from_utf8(chatRoom, "Conference benchmark message");
+			linphone_chat_message_send(msg);
+			messages.push_back(msg);
+		}
+	}
+	BC_ASSERT_TRUE(wait_for_list(coresList, &receiver->stat.number_of_LinphoneMessageReceived, initialStats.number_of_LinphoneMessageReceived + expected, 10000 + expected * 50));
+	double elapsed = elapsed_us(start);
+	result.messagesReceived = receiver->stat.number_of_LinphoneMessageReceived - initialStats.number_of_LinphoneMessageReceived;
+	result.messagesPerSecond = elapsed > 0 ? result.messagesReceived * 1000000. / elapsed : 0;
+	wait_for_list(coresList, &sender->stat.number_of_LinphoneMessageDelivered, initialSenderStats.number_of_LinphoneMessageDelivered + expected, 5000);
+	for (LinphoneChatMessage *msg : messages)
+		linphone_chat_message_unref(msg);
+
+	// Storage of a new message in each chat room, the history of the chat rooms growing with the participants.
+	double totalUs = 0;
+	for (LinphoneChatRoom *chatRoom : chatRooms) {
+		LinphoneChatMessage *msg = linphone_chat_room_create_message_from_utf8(chatRoom, "Conference benchmark stored message");
+		start = Clock::now();
+		linphone_chat_message_store(msg);
+		double us = elapsed_us(start);
+		totalUs += us;
+		if (us > result.dbWriteMaxUs)
+			result.dbWriteMaxUs = us;
+		linphone_chat_message_unref(msg);
+	}
+	result.dbWriteUs = totalUs / result.participants;
+}
+
+// CPU cost of mixing the given number of simulated participants, with partitioned mixing if partitionSize is not 0.
+static void measure_audio_mixing (LinphoneCoreManager *mgr, int partitionSize, MixingResult &result) {
+	AudioMixerBenchmark benchmark(mgr->lc, partitionSize);
+	for (int i = 0; i < result.participants; i++) {
+		if (!benchmark.addParticipant())
+			break;
+	}
+	result.participants = (int)benchmark.getParticipantCount();
+	result.partitionSize = partitionSize;
+	result.partitions = benchmark.getPartitionCount();
+
+	auto run = [&benchmark, mgr](int seconds) {
+		Clock::time_point start = Clock::now();
+		for (int tick = 1; tick <= seconds * 50; tick++) {
+			benchmark.sendPackets();
+			linphone_core_iterate(mgr->lc);
+			this_thread::sleep_until(start + chrono::milliseconds(20 * tick));
+		}
+	};
+	// Let the jitter buffers and the active talker detection settle before measuring.
+	run(1);
+	Clock::time_point start = Clock::now();
+	double cpuBefore = get_process_cpu_us();
+	run(mixing_duration);
+	double cpuUs = get_process_cpu_us() - cpuBefore;
+	double wallUs = elapsed_us(start);
+	result.cpuPercent = cpuUs * 100 / wallUs;
+	if (cpuUs > 0)
+		result.participantsPerCore = result.participants * wallUs / cpuUs;
+}
+
+static void audio_mixing_benchmark (void) {
+	LinphoneCoreManager *mgr = linphone_core_manager_new_with_proxies_check("marie_rc", FALSE);
+	unsigned int cores = ms_factory_get_cpu_count(mgr->lc->factory);
+
+	vector<MixingResult> results;
+	for (int nbParticipants = audio_min_participants; nbParticipants <= audio_max_participants; nbParticipants *= 2) {
+		for (int partitionSize : { 0, mixer_partition_size }) {
+			MixingResult result;
+			result.participants = nbParticipants;
+			measure_audio_mixing(mgr, partitionSize, result);
+			results.push_back(result);
+		}
+	}
+
+	// A single conference mixes everybody on one ticker thread, partitions spread the mixing over all the cores.
+	bc_tester_printf(ORTP_MESSAGE, "PCMU participants mixed at %d Hz for %d s, %u core(s), CPU in percent of one core",
+		linphone_config_get_int(linphone_core_get_config(mgr->lc), "sound", "conference_rate", 16000), mixing_duration, cores);
+	bc_tester_printf(ORTP_MESSAGE, "%12s %14s %10s %8s %18s %18s",
+		"participants", "partition size", "partitions", "CPU(%)", "participants/core", "max participants");
+	for (const auto &result : results) {
+		double maxParticipants = result.partitions > 0 ? result.participantsPerCore * cores : result.participantsPerCore;
+		bc_tester_printf(ORTP_MESSAGE, "%12d %14s %10zu %8.1f %18.1f %18.0f",
+			result.participants, result.partitionSize > 0 ? to_string(result.partitionSize).c_str() : "-", result.partitions,
+			result.cpuPercent, result.participantsPerCore, maxParticipants);
+	}
+
+	linphone_core_manager_destroy(mgr);
+}
+
+static void conference_benchmark (void) {
+	LinphoneCoreManager *focus = linphone_core_manager_new_with_proxies_check("marie_rc", FALSE);
+	LinphoneCoreManager *participants = linphone_core_manager_new_with_proxies_check("pauline_tcp_rc", FALSE);
+	linphone_core_enable_ipv6(focus->lc, FALSE);
+	linphone_core_enable_ipv6(participants->lc, FALSE);
+	linphone_core_set_default_proxy_config(focus->lc, NULL);
+	linphone_core_set_default_proxy_config(participants->lc, NULL);
+	bctbx_list_t *coresList = bctbx_list_append(NULL, focus->lc);
+	coresList = bctbx_list_append(coresList, participants->lc);
+
+	vector<BenchmarkResult> results;
+	for (int nbParticipants = min_participants; nbParticipants <= max_participants; nbParticipants *= 2) {
+		BenchmarkResult result;
+		result.participants = nbParticipants;
+		measure_conference(focus, result);
+		measure_one_to_one_messages(focus, participants, coresList, result);
+		results.push_back(result);
+	}
+
+	bc_tester_printf(ORTP_MESSAGE, "%d device(s) per participant, %d NOTIFY body(ies) built per measure, without sending them",
+		nb_devices, nb_notify_iterations);
+	bc_tester_printf(ORTP_MESSAGE, "%d message(s) sent to one basic chat room per participant over the loopback SIP transport",
+		nb_messages);
+	bc_tester_printf(ORTP_MESSAGE, "%12s %16s %16s %18s %16s %14s %16s %18s",
+		"participants", "full body(ms)", "full body(kB)", "partial body(us)", "1-1 msg(msg/s)", "db write(us)", "db write max(us)", "memory/part.(kB)");
+	for (const auto &result : results) {
+		bc_tester_printf(ORTP_MESSAGE, "%12d %16.3f %16.1f %18.1f %16.1f %14.1f %16.1f %18.2f",
+			result.participants, result.fullStateNotifyMs, result.fullStateNotifySize / 1024., result.partialNotifyUs,
+			result.messagesPerSecond, result.dbWriteUs, result.dbWriteMaxUs, result.memoryPerParticipantKb);
+		if (result.messagesReceived != result.participants * nb_messages)
+			bc_tester_printf(ORTP_MESSAGE, "%12s only %d of the %d messages have been received", "", result.messagesReceived, result.participants * nb_messages);
+	}
+
+	bctbx_list_free(coresList);
+	linphone_core_manager_destroy(participants);
+	linphone_core_manager_destroy(focus);
+}
+
+static int check_params (void) {
+	if (min_participants < 1 || max_participants < min_participants) {
+		bctbx_fatal("There must be at least 1 participant and the maximum must not be less than the minimum!");
+		return -1;
+	}
+	if (nb_devices < 1 || nb_messages < 1 || nb_notify_iterations < 1) {
+		bctbx_fatal("There must be at least 1 device, 1 message and 1 NOTIFY per measure!");
+		return -1;
+	}
+	if (audio_min_participants < 1 || audio_max_participants < audio_min_participants || mixer_partition_size < 1 || mixing_duration < 1) {
+		bctbx_fatal("Audio mixing needs at least 1 participant, a partition size and a duration of at least 1!");
+		return -1;
+	}
+	return 0;
+}
+
+static void conference_benchmark_init (void(*ftester_printf)(int level, const char *fmt, va_list args)) {
+	bctbx_init_logger(FALSE);
+	if (ftester_printf == NULL) ftester_printf = log_handler;
+	bc_tester_set_silent_func(silent_arg_func);
+	bc_tester_set_verbose_func(verbose_arg_func);
+	bc_tester_set_logfile_func(logfile_arg_func);
+	bc_tester_init(ftester_printf, ORTP_MESSAGE, ORTP_ERROR, "rcfiles");
+}
+
+static void conference_benchmark_uninit (void) {
+	bc_tester_uninit();
+	bctbx_uninit_logger();
+}
+
+#if !TARGET_OS_IPHONE && !(defined(LINPHONE_WINDOWS_PHONE) || defined(LINPHONE_WINDOWS_UNIVERSAL))
+
+static const char *conference_benchmark_helper =
+	"\t\t\t--min-participants <nb_participants> (Number of participants of the first run)\n"
+	"\t\t\t--max-participants <nb_participants> (The number of participants is doubled at each run up to this value)\n"
+	"\t\t\t--devices <nb_devices> (Number of devices of each participant)\n"
+	"\t\t\t--messages <nb_messages> (Number of messages sent to the basic chat room of each participant)\n"
+	"\t\t\t--notifies <nb_notifies> (Number of NOTIFY bodies created for each measure)\n"
+	"\t\t\t--audio-min-participants <nb_participants> (Number of participants of the first audio mixing run)\n"
+	"\t\t\t--audio-max-participants <nb_participants> (The number of mixed participants is doubled at each run up to this value)\n"
+	"\t\t\t--partition-size <nb_participants> (Participants per partition for partitioned audio mixing)\n"
+	"\t\t\t--mixing-duration <seconds> (Duration of each audio mixing measure)\n"
+	"\t\t\t--dns-hosts </etc/hosts -like file to used to override DNS names (default: tester_hosts)>\n"
+	"\t\t\t--disable-leak-detector\n"
+	"\t\t\t--no-ipv6 (turn off IPv6 in LinphoneCore, tests requiring IPv6 will be skipped)\n"
+	;
+
+int main (int argc, char *argv[]) {
+	int i;
+	int ret;
+
+	conference_benchmark_init(NULL);
+	linphone_core_set_log_level(ORTP_ERROR);
+
+	test_t benchmark_tests[] = {
+		TEST_NO_TAG("Conference benchmark", conference_benchmark),
+		TEST_NO_TAG("Audio mixing benchmark", audio_mixing_benchmark)
+	};
+	test_suite_t test_suite = {"Conference Benchmark", NULL, NULL, liblinphone_tester_before_each, liblinphone_tester_after_each,
+		sizeof(benchmark_tests) / sizeof(benchmark_tests[0]), benchmark_tests};
+	bc_tester_add_suite(&test_suite);
+
+	for (i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--min-participants") == 0) {
+			CHECK_ARG("--min-participants", ++i, argc);
+			min_participants = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--max-participants") == 0) {
+			CHECK_ARG("--max-participants", ++i, argc);
+			max_participants = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--devices") == 0) {
+			CHECK_ARG("--devices", ++i, argc);
+			nb_devices = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--messages") == 0) {
+			CHECK_ARG("--messages", ++i, argc);
+			nb_messages = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--notifies") == 0) {
+			CHECK_ARG("--notifies", ++i, argc);
+			nb_notify_iterations = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--audio-min-participants") == 0) {
+			CHECK_ARG("--audio-min-participants", ++i, argc);
+			audio_min_participants = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--audio-max-participants") == 0) {
+			CHECK_ARG("--audio-max-participants", ++i, argc);
+			audio_max_participants = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--partition-size") == 0) {
+			CHECK_ARG("--partition-size", ++i, argc);
+			mixer_partition_size = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--mixing-duration") == 0) {
+			CHECK_ARG("--mixing-duration", ++i, argc);
+			mixing_duration = atoi(argv[i]);
+		} else if (strcmp(argv[i], "--dns-hosts") == 0) {
+			CHECK_ARG("--dns-hosts", ++i, argc);
+			userhostsfile = argv[i];
+		} else if (strcmp(argv[i], "--disable-leak-detector") == 0) {
+			liblinphone_tester_disable_leak_detector(TRUE);
+		} else if (strcmp(argv[i], "--no-ipv6") == 0) {
+			liblinphonetester_ipv6 = FALSE;
+		} else {
+			int bret = bc_tester_parse_args(argc, argv, i);
+			if (bret > 0) {
+				i += bret - 1;
+				continue;
+			} else if (bret < 0) {
+				bc_tester_helper(argv[0], conference_benchmark_helper);
+			}
+			return bret;
+		}
+	}
+
+	if (check_params() != 0) {
+		return -1;
+	}
+	ret = bc_tester_start(argv[0]);
+	conference_benchmark_uninit();
+	return ret;
+}
+
+#endif
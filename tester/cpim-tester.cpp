@@ -21,10 +21,13 @@
 #include "chat/chat-message/chat-message.h"
 #include "chat/chat-room/basic-chat-room.h"
 #include "chat/cpim/cpim.h"
+#include "chat/cpim/parser/cpim-parser.h"
 #include "content/content-type.h"
 #include "content/content.h"
 #include "core/core.h"
 #include "belr/grammarbuilder.h"
+
+#include <chrono>
 // TODO: Remove me later.
 #include "private.h"
 
@@ -244,6 +247,97 @@ static void build_message () {
 	BC_ASSERT_STRING_EQUAL(strMessage.c_str(), expectedMessage.c_str());
 }
 
+static const string fastPathMessage = "From: \"Marie \\\"the\\\" Curie\"<sip:marie@sip.example.org>\r\n"
+	"To: <sip:pauline@sip.example.org>\r\n"
+	"DateTime: 2021-07-08T13:40:00Z\r\n"
+	"NS: imdn <urn:ietf:params:imdn>\r\n"
+	"imdn.Message-ID: 6fa94ef4d8c9\r\n"
+	"imdn.Disposition-Notification: positive-delivery, display\r\n"
+	"\r\n"
+	"Content-Type: text/plain; charset=utf-8\r\n"
+	"Content-Length: 12\r\n"
+	"\r\n"
+	"Hello world!";
+
+static void parse_message_with_fast_path () {
+	// Each input with whether the hand-written parser handles it.
+	const vector<pair<string, bool>> inputs = {
+		{ fastPathMessage, true },
+		// Same message with an offset date.
+		{ "From: <sip:marie@sip.example.org>\r\n"
+		"DateTime: 2021-07-08T05:40:00-08:00\r\n"
+		"Require: imdn.Disposition-Notification\r\n"
+		"\r\n"
+		"Content-Type: text/plain\r\n"
+		"\r\n"
+		"Hi", true },
+		// Subjects and header parameters are handled by the CPIM grammar.
+		{ "Subject:;lang=fr beau temps prevu pour aujourd'hui\r\n"
+		"\r\n"
+		"Content-Type: text/plain; charset=utf-8\r\n"
+		"\r\n", false },
+		{ "MyFeatures.WackyMessageOption:;foo=bar Use-silly-font\r\n"
+		"\r\n"
+		"Content-Type: text/plain\r\n"
+		"\r\n", false },
+		// So are reserved header names written with another case.
+		{ "from: <sip:marie@sip.example.org>\r\n"
+		"CC: <sip:laure@sip.example.org>\r\n"
+		"\r\n"
+		"Content-Type: text/plain\r\n"
+		"\r\n", false },
+		{ "subject: beau temps prevu pour aujourd'hui\r\n"
+		"\r\n"
+		"Content-Type: text/plain\r\n"
+		"\r\n", false }
+	};
+
+	for (const auto &input : inputs) {
+		size_t fastParsedCount = Cpim::Parser::getInstance()->getFastParsedMessagesCount();
+		shared_ptr<const Cpim::Message> message = Cpim::Parser::getInstance()->parseMessage(input.first);
+		BC_ASSERT_EQUAL(Cpim::Parser::getInstance()->getFastParsedMessagesCount(), fastParsedCount + (input.second ? 1 : 0), size_t, "%zu");
+		shared_ptr<const Cpim::Message> grammarMessage = Cpim::Parser::getInstance()->parseMessageWithGrammar(input.first);
+		shared_ptr<const Cpim::Message> grammarMessage = Cpim::Parser::getInstance()->parseMessageWithGrammar(input);
+		if (!BC_ASSERT_PTR_NOT_NULL(message) || !BC_ASSERT_PTR_NOT_NULL(grammarMessage)) continue;
+
+		const string str = message->asString();
+		const string grammarStr = grammarMessage->asString();
+		BC_ASSERT_STRING_EQUAL(str.c_str(), grammarStr.c_str());
+	}
+
+	// Invalid messages must be rejected as before.
+	BC_ASSERT_PTR_NULL(Cpim::Parser::getInstance()->parseMessage("From: <sip:marie@sip.example.org>\r\n\r\n"));
+	BC_ASSERT_PTR_NULL(Cpim::Parser::getInstance()->parseMessage("DateTime: 2021-13-08T13:40:00Z\r\n\r\nContent-Type: text/plain\r\n\r\n"));
+}
+
+static void fast_path_benchmark () {
+	const int iterations = 2000;
+	const auto parser = Cpim::Parser::getInstance();
+
+	int fastParsed = 0;
+	int grammarParsed = 0;
+
+	auto start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		if (parser->parseMessage(fastPathMessage))
+			fastParsed++;
+	}
+	auto fastDuration = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+
+	start = chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		if (parser->parseMessageWithGrammar(fastPathMessage))
+			grammarParsed++;
+	}
+	auto grammarDuration = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start);
+
+	BC_ASSERT_EQUAL(fastParsed, iterations, int, "%d");
+	BC_ASSERT_EQUAL(grammarParsed, iterations, int, "%d");
+
+	ms_message("Parsed %d CPIM messages in %lld us with the fast path, %lld us with the CPIM grammar",
+		iterations, (long long)fastDuration.count(), (long long)grammarDuration.count());
+}
+
 static int fake_im_encryption_engine_process_incoming_message_cb (
 	LinphoneImEncryptionEngine *engine,
 	LinphoneChatRoom *room,
@@ -354,6 +448,8 @@ test_t cpim_tests[] = {
 	TEST_NO_TAG("Parse RFC example", parse_rfc_example),
 	TEST_NO_TAG("Parse Message with generic header parameters", parse_message_with_generic_header_parameters),
 	TEST_NO_TAG("Build Message", build_message),
+	TEST_NO_TAG("Parse Message with fast path", parse_message_with_fast_path),
+	TEST_NO_TAG("CPIM parsers benchmark", fast_path_benchmark),
 	TEST_NO_TAG("CPIM chat message modifier", cpim_chat_message_modifier),
 	TEST_NO_TAG("CPIM chat message modifier with multipart body", cpim_chat_message_modifier_with_multipart_body),
 	TEST_ONE_TAG("CPIM ephemeral message", ephemeral_message, "Ephemeral")
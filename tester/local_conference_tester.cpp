@@ -30,10 +30,17 @@
 #include "address/address.h"
 #include "c-wrapper/c-wrapper.h"
 #include "chat/chat-room/chat-room.h"
+#include "chat/notification/imdn-scheduler.h"
 #include "core/core.h"
+#include "core/core-p.h"
 #include "conference/participant.h"
 #include "address/identity-address.h"
 #include "chat/chat-room/server-group-chat-room-p.h"
+#include "call/call.h"
+#include "conference_private.h"
+#include "conference/session/media-session.h"
+#include "conference/session/mixers.h"
+#include "tools/private-access.h"
 
 #if __clang__ || ((__GNUC__ == 4 && __GNUC_MINOR__ >= 6) || __GNUC__ > 4)
 #pragma GCC diagnostic push
@@ -44,6 +51,12 @@
 
 using namespace LinphonePrivate;
 using namespace std;
+
+using MediaLocalConference = MediaConference::LocalConference;
+L_ENABLE_ATTR_ACCESS(MediaLocalConference, unique_ptr<MixerSession>, mMixerSession);
+L_ENABLE_ATTR_ACCESS(Conference, list<shared_ptr<Participant>>, participants);
+L_ENABLE_ATTR_ACCESS(CorePrivate, list<shared_ptr<AbstractChatRoom>>, pendingOneToOneChatRooms);
+
 namespace LinphoneTest {
 
 class BcAssert {
@@ -145,7 +158,10 @@ class Focus;
 /*Core manager acting as a client*/
 class ClientConference :public CoreManager {
 public:
-	ClientConference(std::string rc,Address factoryUri):CoreManager(rc,[this,factoryUri] {
+	// configure is called on the config of the core before each start.
+	ClientConference(std::string rc,Address factoryUri,const std::function<void (LinphoneConfig *)> &configure = nullptr):CoreManager(rc,[this,factoryUri,configure] {
+		if (configure)
+			configure(linphone_core_get_config(getLc()));
 		_configure_core_for_conference(mMgr,L_GET_C_BACK_PTR(&factoryUri));
 		LinphoneCoreCbs *cbs = linphone_factory_create_core_cbs(linphone_factory_get());
 		linphone_core_cbs_set_chat_room_state_changed(cbs, core_chat_room_state_changed);
@@ -202,6 +218,18 @@ public:
 		
 	}
 
+	void unregisterAsParticipantDevice(ClientConference &otherMgr) {
+		const LinphoneAddress *cAddr = linphone_proxy_config_get_contact(linphone_core_get_default_proxy_config(otherMgr.getLc()));
+		IdentityAddress participantDevice(*L_GET_CPP_PTR_FROM_C_OBJECT(cAddr));
+		auto participantRange = mParticipantDevices.equal_range(participantDevice.getAddressWithoutGruu());
+		for (auto participantIt = participantRange.first; participantIt != participantRange.second; participantIt++) {
+			if (participantIt->second == participantDevice) {
+				mParticipantDevices.erase(participantIt);
+				break;
+			}
+		}
+	}
+
 	void subscribeParticipantDevice(const LinphoneAddress *conferenceAddress, const LinphoneAddress *participantDevice){
 		LinphoneChatRoom *cr = linphone_core_search_chat_room(getLc(), NULL, conferenceAddress, conferenceAddress, NULL);
 		BC_ASSERT_PTR_NOT_NULL(cr);
@@ -648,6 +676,161 @@ static void group_chat_room_server_deletion_with_rmt_lst_event_handler (void) {
 	}
 }
 
+static size_t server_chat_room_device_count (Focus &focus, const IdentityAddress &participantAddress) {
+	for (auto chatRoom : focus.getCore().getChatRooms()) {
+		shared_ptr<Participant> participant = chatRoom->findParticipant(participantAddress);
+		if (participant)
+			return participant->getDevices().size();
+	}
+	return 0;
+}
+
+static void group_chat_room_server_fan_out_follows_devices (void) {
+	Focus focus("chloe_rc");
+	{//to make sure focus is destroyed after clients.
+		ClientConference marie("marie_rc", focus.getIdentity().asAddress());
+		ClientConference marie2("marie_rc", focus.getIdentity().asAddress());
+		ClientConference pauline("pauline_rc", focus.getIdentity().asAddress());
+
+		// Marie's second device is not registered yet.
+		focus.registerAsParticipantDevice(marie);
+		focus.registerAsParticipantDevice(pauline);
+
+		bctbx_list_t * coresList = bctbx_list_append(NULL, focus.getLc());
+		coresList = bctbx_list_append(coresList, marie.getLc());
+		coresList = bctbx_list_append(coresList, marie2.getLc());
+		coresList = bctbx_list_append(coresList, pauline.getLc());
+		Address paulineAddr(pauline.getIdentity().asAddress());
+		bctbx_list_t *participantsAddresses = bctbx_list_append(NULL, linphone_address_ref(L_GET_C_BACK_PTR(&paulineAddr)));
+
+		stats initialMarieStats = marie.getStats();
+		stats initialMarie2Stats = marie2.getStats();
+		stats initialPaulineStats = pauline.getStats();
+
+		const char *initialSubject = "Devices";
+		LinphoneChatRoom *marieCr = create_chat_room_client_side(coresList, marie.getCMgr(), &initialMarieStats, participantsAddresses, initialSubject, FALSE, LinphoneChatRoomEphemeralModeDeviceManaged);
+		const LinphoneAddress *confAddr = linphone_chat_room_get_conference_address(marieCr);
+		LinphoneChatRoom *paulineCr = check_creation_chat_room_client_side(coresList, pauline.getCMgr(), &initialPaulineStats, confAddr, initialSubject, 1, FALSE);
+		const IdentityAddress marieAddr(marie.getIdentity());
+		Address marieIdentityAddr(marieAddr.asAddress());
+		BC_ASSERT_EQUAL(server_chat_room_device_count(focus, marieAddr), 1, size_t, "%zu");
+
+		// Marie's second device registers, it is invited and the message is sent to both devices.
+		focus.registerAsParticipantDevice(marie2);
+		focus.subscribeParticipantDevice(confAddr, L_GET_C_BACK_PTR(&marieIdentityAddr));
+		LinphoneChatRoom *marie2Cr = check_creation_chat_room_client_side(coresList, marie2.getCMgr(), &initialMarie2Stats, confAddr, initialSubject, 1, FALSE);
+		BC_ASSERT_PTR_NOT_NULL(marie2Cr);
+		BC_ASSERT_EQUAL(server_chat_room_device_count(focus, marieAddr), 2, size_t, "%zu");
+
+		stats marie_stat = marie.getStats();
+		stats marie2_stat = marie2.getStats();
+		LinphoneChatMessage *msg = linphone_chat_room_create_message_from_utf8(paulineCr, "To both devices");
+		linphone_chat_message_send(msg);
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_LinphoneMessageReceived, marie_stat.number_of_LinphoneMessageReceived + 1, 10000));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie2.getStats().number_of_LinphoneMessageReceived, marie2_stat.number_of_LinphoneMessageReceived + 1, 10000));
+		linphone_chat_message_unref(msg);
+
+		// The second device unregisters, it is removed and no longer receives the messages.
+		stats pauline_stat = pauline.getStats();
+		focus.unregisterAsParticipantDevice(marie2);
+		focus.subscribeParticipantDevice(confAddr, L_GET_C_BACK_PTR(&marieIdentityAddr));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &pauline.getStats().number_of_participant_devices_removed, pauline_stat.number_of_participant_devices_removed + 1, 5000));
+		BC_ASSERT_EQUAL(server_chat_room_device_count(focus, marieAddr), 1, size_t, "%zu");
+
+		marie_stat = marie.getStats();
+		marie2_stat = marie2.getStats();
+		msg = linphone_chat_room_create_message_from_utf8(paulineCr, "To the first device");
+		linphone_chat_message_send(msg);
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_LinphoneMessageReceived, marie_stat.number_of_LinphoneMessageReceived + 1, 10000));
+		BC_ASSERT_FALSE(wait_for_list(coresList, &marie2.getStats().number_of_LinphoneMessageReceived, marie2_stat.number_of_LinphoneMessageReceived + 1, 3000));
+		linphone_chat_message_unref(msg);
+
+		// It registers again and is back in the fan-out.
+		pauline_stat = pauline.getStats();
+		focus.registerAsParticipantDevice(marie2);
+		focus.subscribeParticipantDevice(confAddr, L_GET_C_BACK_PTR(&marieIdentityAddr));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &pauline.getStats().number_of_participant_devices_added, pauline_stat.number_of_participant_devices_added + 1, 5000));
+		BC_ASSERT_EQUAL(server_chat_room_device_count(focus, marieAddr), 2, size_t, "%zu");
+
+		marie_stat = marie.getStats();
+		marie2_stat = marie2.getStats();
+		msg = linphone_chat_room_create_message_from_utf8(paulineCr, "To both devices again");
+		linphone_chat_message_send(msg);
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_LinphoneMessageReceived, marie_stat.number_of_LinphoneMessageReceived + 1, 10000));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie2.getStats().number_of_LinphoneMessageReceived, marie2_stat.number_of_LinphoneMessageReceived + 1, 10000));
+		linphone_chat_message_unref(msg);
+
+		bctbx_list_free(coresList);
+	}
+}
+
+static void one_to_one_chat_room_index (void) {
+	Focus focus("chloe_rc");
+	{//to make sure focus is destroyed after clients.
+		ClientConference marie("marie_rc", focus.getIdentity().asAddress());
+		ClientConference pauline("pauline_rc", focus.getIdentity().asAddress());
+
+		focus.registerAsParticipantDevice(marie);
+		focus.registerAsParticipantDevice(pauline);
+
+		bctbx_list_t * coresList = bctbx_list_append(NULL, focus.getLc());
+		coresList = bctbx_list_append(coresList, marie.getLc());
+		coresList = bctbx_list_append(coresList, pauline.getLc());
+		Address paulineAddr(pauline.getIdentity().asAddress());
+		bctbx_list_t *participantsAddresses = bctbx_list_append(NULL, linphone_address_ref(L_GET_C_BACK_PTR(&paulineAddr)));
+
+		stats initialMarieStats = marie.getStats();
+		stats initialPaulineStats = pauline.getStats();
+
+		// A basic chat room is found through its peer address.
+		LinphoneChatRoom *basicCr = linphone_core_get_chat_room(marie.getLc(), L_GET_C_BACK_PTR(&paulineAddr));
+		BC_ASSERT_PTR_NOT_NULL(basicCr);
+		BC_ASSERT_PTR_EQUAL(marie.getCore().findOneToOneChatRoom(marie.getIdentity(), pauline.getIdentity(), true, false, false).get(), L_GET_CPP_PTR_FROM_C_OBJECT(basicCr).get());
+		BC_ASSERT_PTR_NULL(marie.getCore().findOneToOneChatRoom(marie.getIdentity(), pauline.getIdentity(), false, true, false).get());
+
+		// A one to one conference chat room is found through its participant, on Pauline's side once the conference has notified it.
+		const char *initialSubject = "One to one index";
+		LinphoneChatRoom *marieCr = create_chat_room_client_side(coresList, marie.getCMgr(), &initialMarieStats, participantsAddresses, initialSubject, FALSE, LinphoneChatRoomEphemeralModeDeviceManaged);
+		LinphoneChatRoom *paulineCr = NULL;
+		if (BC_ASSERT_PTR_NOT_NULL(marieCr))
+			paulineCr = check_creation_chat_room_client_side(coresList, pauline.getCMgr(), &initialPaulineStats, linphone_chat_room_get_conference_address(marieCr), initialSubject, 1, FALSE);
+		if (BC_ASSERT_PTR_NOT_NULL(paulineCr)) {
+			const IdentityAddress marieLocalAddr(*L_GET_CPP_PTR_FROM_C_OBJECT(linphone_chat_room_get_local_address(marieCr)));
+			BC_ASSERT_PTR_EQUAL(marie.getCore().findOneToOneChatRoom(marieLocalAddr, pauline.getIdentity(), false, true, false).get(), L_GET_CPP_PTR_FROM_C_OBJECT(marieCr).get());
+
+			shared_ptr<AbstractChatRoom> paulineChatRoom = L_GET_CPP_PTR_FROM_C_OBJECT(paulineCr);
+			const IdentityAddress paulineLocalAddr(paulineChatRoom->getLocalAddress());
+			CorePrivate *paulineCore = L_GET_PRIVATE_FROM_C_OBJECT(pauline.getLc());
+			list<shared_ptr<AbstractChatRoom>> &pendingChatRooms = L_ATTR_GET(paulineCore, pendingOneToOneChatRooms);
+			BC_ASSERT_PTR_EQUAL(pauline.getCore().findOneToOneChatRoom(paulineLocalAddr, marie.getIdentity(), false, true, false).get(), paulineChatRoom.get());
+			BC_ASSERT_TRUE(pendingChatRooms.empty());
+
+			// Without its participant, the chat room waits to be indexed until the participant is known again.
+			list<shared_ptr<Participant>> &participants = L_ATTR_GET(paulineChatRoom->getConference().get(), participants);
+			const list<shared_ptr<Participant>> paulineParticipants = participants;
+			participants.clear();
+			paulineCore->reindexOneToOneChatRoom(paulineChatRoom->getConferenceId());
+			BC_ASSERT_EQUAL(pendingChatRooms.size(), 1, size_t, "%zu");
+			BC_ASSERT_PTR_NULL(pauline.getCore().findOneToOneChatRoom(paulineLocalAddr, marie.getIdentity(), false, true, false).get());
+			participants = paulineParticipants;
+			BC_ASSERT_PTR_EQUAL(pauline.getCore().findOneToOneChatRoom(paulineLocalAddr, marie.getIdentity(), false, true, false).get(), paulineChatRoom.get());
+			BC_ASSERT_TRUE(pendingChatRooms.empty());
+
+			// When its participant changes, the chat room is found through the new one only.
+			const IdentityAddress laureAddr("sip:laure@sip.example.org");
+			participants = { Participant::create(paulineChatRoom->getConference().get(), laureAddr) };
+			paulineCore->reindexOneToOneChatRoom(paulineChatRoom->getConferenceId());
+			BC_ASSERT_PTR_EQUAL(pauline.getCore().findOneToOneChatRoom(paulineLocalAddr, laureAddr, false, true, false).get(), paulineChatRoom.get());
+			BC_ASSERT_PTR_NULL(pauline.getCore().findOneToOneChatRoom(paulineLocalAddr, marie.getIdentity(), false, true, false).get());
+			participants = paulineParticipants;
+			paulineCore->reindexOneToOneChatRoom(paulineChatRoom->getConferenceId());
+			BC_ASSERT_PTR_EQUAL(pauline.getCore().findOneToOneChatRoom(paulineLocalAddr, marie.getIdentity(), false, true, false).get(), paulineChatRoom.get());
+		}
+
+		bctbx_list_free(coresList);
+	}
+}
+
 static void group_chat_room_server_admin_managed_messages_base (bool_t encrypted) {
 	Focus focus("chloe_rc");
 	{//to make sure focus is destroyed after clients.
@@ -750,6 +933,91 @@ static void group_chat_room_server_admin_managed_messages_base (bool_t encrypted
 	}
 }
 
+static void group_chat_room_imdn_sends_paced_across_chat_rooms (void) {
+	Focus focus("chloe_rc");
+	{//to make sure focus is destroyed after clients.
+		ClientConference marie("marie_rc", focus.getIdentity().asAddress());
+		// Only one chat room of Pauline may send its IMDNs per second.
+		ClientConference pauline("pauline_rc", focus.getIdentity().asAddress(), [](LinphoneConfig *config) {
+			linphone_config_set_int(config, "misc", "imdn_max_sends_per_interval", 1);
+			linphone_config_set_int(config, "misc", "imdn_send_interval", 1000);
+		});
+
+		focus.registerAsParticipantDevice(marie);
+		focus.registerAsParticipantDevice(pauline);
+
+		// Enable IMDN
+		linphone_im_notif_policy_enable_all(linphone_core_get_im_notif_policy(marie.getLc()));
+		linphone_im_notif_policy_enable_all(linphone_core_get_im_notif_policy(pauline.getLc()));
+
+		bctbx_list_t * coresList = bctbx_list_append(NULL, focus.getLc());
+		coresList = bctbx_list_append(coresList, marie.getLc());
+		coresList = bctbx_list_append(coresList, pauline.getLc());
+		Address paulineAddr(pauline.getIdentity().asAddress());
+
+		constexpr int noChatRooms = 3;
+		std::list<LinphoneChatRoom *> marieCrs;
+		std::list<LinphoneChatRoom *> paulineCrs;
+		for (int i = 0; i < noChatRooms; i++) {
+			stats marie_stat = marie.getStats();
+			stats pauline_stat = pauline.getStats();
+			const std::string subject = "Paced IMDNs " + std::to_string(i);
+			bctbx_list_t *participantsAddresses = bctbx_list_append(NULL, linphone_address_ref(L_GET_C_BACK_PTR(&paulineAddr)));
+			LinphoneChatRoomParams *params = linphone_core_create_default_chat_room_params(marie.getLc());
+			linphone_chat_room_params_enable_group(params, TRUE);
+			linphone_chat_room_params_enable_encryption(params, FALSE);
+			linphone_chat_room_params_set_backend(params, LinphoneChatRoomBackendFlexisipChat);
+			LinphoneChatRoom *marieCr = create_chat_room_client_side_with_params(coresList, marie.getCMgr(), &marie_stat, participantsAddresses, subject.c_str(), params);
+			linphone_chat_room_params_unref(params);
+			if (!BC_ASSERT_PTR_NOT_NULL(marieCr))
+				break;
+			LinphoneChatRoom *paulineCr = check_creation_chat_room_client_side(coresList, pauline.getCMgr(), &pauline_stat, linphone_chat_room_get_conference_address(marieCr), subject.c_str(), 1, FALSE);
+			if (!BC_ASSERT_PTR_NOT_NULL(paulineCr))
+				break;
+			marieCrs.push_back(marieCr);
+			paulineCrs.push_back(paulineCr);
+		}
+
+		const ImdnScheduler::Stats &imdnStats = pauline.getCore().getImdnScheduler()->getStats();
+		const ImdnScheduler::Stats initialImdnStats = imdnStats;
+		stats marie_stat = marie.getStats();
+		stats pauline_stat = pauline.getStats();
+
+		// Marie sends a message in each chat room, Pauline's delivery IMDNs have to wait for their turn.
+		std::list<LinphoneChatMessage *> messages;
+		for (auto marieCr : marieCrs) {
+			LinphoneChatMessage *msg = linphone_chat_room_create_message_from_utf8(marieCr, "Hello");
+			linphone_chat_message_send(msg);
+			messages.push_back(msg);
+		}
+		const int noMsg = (int)messages.size();
+		BC_ASSERT_TRUE(wait_for_list(coresList, &pauline.getStats().number_of_LinphoneMessageReceived, pauline_stat.number_of_LinphoneMessageReceived + noMsg, 10000));
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_LinphoneMessageDeliveredToUser, marie_stat.number_of_LinphoneMessageDeliveredToUser + noMsg, 10000));
+
+		// Same for the display IMDNs.
+		for (auto paulineCr : paulineCrs)
+			linphone_chat_room_mark_as_read(paulineCr);
+		BC_ASSERT_TRUE(wait_for_list(coresList, &marie.getStats().number_of_LinphoneMessageDisplayed, marie_stat.number_of_LinphoneMessageDisplayed + noMsg, 10000));
+		for (auto msg : messages) {
+			BC_ASSERT_EQUAL(linphone_chat_message_get_state(msg), LinphoneChatMessageStateDisplayed, int, "%d");
+			linphone_chat_message_unref(msg);
+		}
+
+		// The chat rooms sent their IMDNs one per interval, the others waited.
+		BC_ASSERT_GREATER(imdnStats.sends, initialImdnStats.sends + noMsg, unsigned int, "%u");
+		BC_ASSERT_GREATER(imdnStats.delayedSends, initialImdnStats.delayedSends + noMsg - 1, unsigned int, "%u");
+		BC_ASSERT_GREATER(imdnStats.maxQueueDepth, (size_t)(noMsg - 1), size_t, "%zu");
+		BC_ASSERT_TRUE(imdnStats.maxFlushLatency > 0);
+		BC_ASSERT_EQUAL(imdnStats.queueDepth, 0, size_t, "%zu");
+		// And their delivery is saved in database.
+		BC_ASSERT_TRUE(CoreManagerAssert({focus,marie,pauline}).wait([&imdnStats, &initialImdnStats, noMsg] {
+			return imdnStats.persistedMessages >= initialImdnStats.persistedMessages + (unsigned int)noMsg;
+		}));
+
+		bctbx_list_free(coresList);
+	}
+}
+
 static void group_chat_room_server_admin_managed_messages_unencrypted (void) {
 	group_chat_room_server_admin_managed_messages_base (FALSE);
 }
@@ -2378,23 +2646,222 @@ static void group_chat_room_server_ephemeral_mode_changed (void) {
 	}
 }
 
+
+static MixerSession *getMixerSession (LinphoneConference *conference) {
+	MediaLocalConference *localConf = dynamic_cast<MediaLocalConference *>(MediaConference::Conference::toCpp(conference));
+	return localConf ? L_ATTR_GET(localConf, mMixerSession).get() : nullptr;
+}
+
+// Calls each participant from the focus, then merges the calls into a conference hosted by the focus.
+static LinphoneConference *createLocalConference (Focus &focus, std::initializer_list<std::reference_wrapper<ClientConference>> participants, bctbx_list_t *coresList, bool withVideo = false) {
+	bctbx_list_t *participantsMgrs = NULL;
+	for (ClientConference &participant : participants) {
+		LinphoneCallParams *callParams = linphone_core_create_call_params(focus.getLc(), NULL);
+		linphone_call_params_enable_video(callParams, withVideo);
+		bool callOk = call_with_caller_params(focus.getCMgr(), participant.getCMgr(), callParams);
+		linphone_call_params_unref(callParams);
+		if (!BC_ASSERT_TRUE(callOk)) {
+			bctbx_list_free(participantsMgrs);
+			return nullptr;
+		}
+		participantsMgrs = bctbx_list_append(participantsMgrs, participant.getCMgr());
+	}
+
+	LinphoneConferenceParams *confParams = linphone_core_create_conference_params(focus.getLc());
+	linphone_conference_params_set_video_enabled(confParams, withVideo);
+	LinphoneConference *conference = linphone_core_create_conference_with_params(focus.getLc(), confParams);
+	linphone_conference_params_unref(confParams);
+	add_calls_to_local_conference(coresList, focus.getCMgr(), conference, participantsMgrs, FALSE);
+	bctbx_list_free(participantsMgrs);
+
+	if (conference) {
+		// Only the participants are heard.
+		linphone_conference_mute_microphone(conference, TRUE);
+	}
+	return conference;
+}
+
+static bool hearsAudio (ClientConference &participant) {
+	LinphoneCall *call = linphone_core_get_current_call(participant.getLc());
+	return call && (linphone_call_get_play_volume(call) > -40);
+}
+
+static bool hearsSilence (ClientConference &participant) {
+	LinphoneCall *call = linphone_core_get_current_call(participant.getLc());
+	return call && (linphone_call_get_play_volume(call) < -60);
+}
+
+// Ends the calls of the conference created by createLocalConference() and releases it.
+static void terminateLocalConference (Focus &focus, LinphoneConference *conference, std::initializer_list<std::reference_wrapper<ClientConference>> participants, bctbx_list_t *coresList) {
+	std::list<stats> initialStats;
+	for (ClientConference &participant : participants)
+		initialStats.push_back(participant.getStats());
+	linphone_core_terminate_all_calls(focus.getLc());
+	auto initialStat = initialStats.begin();
+	for (ClientConference &participant : participants) {
+		BC_ASSERT_TRUE(wait_for_list(coresList, &participant.getStats().number_of_LinphoneCallReleased, initialStat->number_of_LinphoneCallReleased + 1, 10000));
+		initialStat++;
+	}
+	if (conference)
+		linphone_conference_unref(conference);
+}
+
+static void audio_conference_with_mixer_partitions (void) {
+	Focus focus("chloe_rc");
+	{//to make sure focus is destroyed after clients.
+		ClientConference marie("marie_rc", focus.getIdentity().asAddress());
+		ClientConference pauline("pauline_rc", focus.getIdentity().asAddress());
+		ClientConference laure("laure_tcp_rc", focus.getIdentity().asAddress());
+
+		// One participant is mixed by the main conference, each of the two others by its own partition.
+		// Only the partial mix of the partition whose member talked last is mixed by the main conference.
+		linphone_config_set_int(linphone_core_get_config(focus.getLc()), "sound", "conference_mixer_partition_size", 1);
+		linphone_config_set_int(linphone_core_get_config(focus.getLc()), "sound", "conference_mixer_talking_partitions", 1);
+
+		bctbx_list_t * coresList = bctbx_list_append(NULL, focus.getLc());
+		coresList = bctbx_list_append(coresList, marie.getLc());
+		coresList = bctbx_list_append(coresList, pauline.getLc());
+		coresList = bctbx_list_append(coresList, laure.getLc());
+
+		LinphoneConference *conference = createLocalConference(focus, {marie, pauline, laure}, coresList);
+		if (BC_ASSERT_PTR_NOT_NULL(conference)) {
+			BC_ASSERT_EQUAL(linphone_conference_get_participant_count(conference), 3, int, "%d");
+			MixerSession *mixerSession = getMixerSession(conference);
+			MS2AudioMixer *audioMixer = mixerSession ? dynamic_cast<MS2AudioMixer *>(mixerSession->getMixerByType(SalAudio)) : nullptr;
+			if (BC_ASSERT_PTR_NOT_NULL(audioMixer))
+				BC_ASSERT_EQUAL((int)audioMixer->getPartitionCount(), 2, int, "%d");
+
+			// Each participant talks alone in turn: whatever their partitions, the two others must hear it.
+			std::vector<std::reference_wrapper<ClientConference>> participants = {marie, pauline, laure};
+			for (ClientConference &talker : participants) {
+				for (ClientConference &participant : participants)
+					linphone_core_enable_mic(participant.getLc(), FALSE);
+				BC_ASSERT_TRUE(CoreManagerAssert({focus, marie, pauline, laure}).wait([&participants] {
+					for (ClientConference &participant : participants) {
+						if (!hearsSilence(participant))
+							return false;
+					}
+					return true;
+				}));
+
+				linphone_core_enable_mic(talker.getLc(), TRUE);
+				for (ClientConference &listener : participants) {
+					if (&listener == &talker)
+						continue;
+					BC_ASSERT_TRUE(CoreManagerAssert({focus, marie, pauline, laure}).wait([&listener] {
+						return hearsAudio(listener);
+					}));
+				}
+			}
+		}
+
+		terminateLocalConference(focus, conference, {marie, pauline, laure}, coresList);
+		bctbx_list_free(coresList);
+	}
+}
+
+#ifdef VIDEO_ENABLED
+static void enableVideo (CoreManager &mgr) {
+	LinphoneVideoActivationPolicy *pol = linphone_factory_create_video_activation_policy(linphone_factory_get());
+	linphone_video_activation_policy_set_automatically_accept(pol, TRUE);
+	linphone_core_set_video_activation_policy(mgr.getLc(), pol);
+	linphone_video_activation_policy_unref(pol);
+	linphone_core_set_video_device(mgr.getLc(), liblinphone_tester_mire_id);
+	linphone_core_enable_video_capture(mgr.getLc(), TRUE);
+	linphone_core_enable_video_display(mgr.getLc(), TRUE);
+}
+
+// Waits for each participant to decode a new video frame.
+static void checkVideoDecoded (std::initializer_list<std::reference_wrapper<ClientConference>> participants, bctbx_list_t *coresList) {
+	std::list<int> initialDecodedFrames;
+	for (ClientConference &participant : participants) {
+		initialDecodedFrames.push_back(participant.getStats().number_of_IframeDecoded);
+		liblinphone_tester_set_next_video_frame_decoded_cb(linphone_core_get_current_call(participant.getLc()));
+	}
+	auto initialDecoded = initialDecodedFrames.begin();
+	for (ClientConference &participant : participants) {
+		BC_ASSERT_TRUE(wait_for_list(coresList, &participant.getStats().number_of_IframeDecoded, *initialDecoded + 1, 5000));
+		initialDecoded++;
+	}
+}
+
+static void video_conference_with_router_mode (void) {
+	Focus focus("chloe_rc");
+	{//to make sure focus is destroyed after clients.
+		ClientConference marie("marie_rc", focus.getIdentity().asAddress());
+		ClientConference pauline("pauline_rc", focus.getIdentity().asAddress());
+		ClientConference laure("laure_tcp_rc", focus.getIdentity().asAddress());
+
+		// The focus forwards the video of the focused participant instead of mixing it.
+		linphone_config_set_int(linphone_core_get_config(focus.getLc()), "video", "conference_router_mode", 1);
+		enableVideo(focus);
+		enableVideo(marie);
+		enableVideo(pauline);
+		enableVideo(laure);
+
+		bctbx_list_t * coresList = bctbx_list_append(NULL, focus.getLc());
+		coresList = bctbx_list_append(coresList, marie.getLc());
+		coresList = bctbx_list_append(coresList, pauline.getLc());
+		coresList = bctbx_list_append(coresList, laure.getLc());
+
+		LinphoneConference *conference = createLocalConference(focus, {marie, pauline, laure}, coresList, true);
+		if (BC_ASSERT_PTR_NOT_NULL(conference)) {
+			for (ClientConference &participant : {std::ref(marie), std::ref(pauline), std::ref(laure)}) {
+				LinphoneCall *call = linphone_core_get_current_call(participant.getLc());
+				if (BC_ASSERT_PTR_NOT_NULL(call))
+					BC_ASSERT_TRUE(linphone_call_params_video_enabled(linphone_call_get_current_params(call)));
+			}
+
+			MixerSession *mixerSession = getMixerSession(conference);
+			MS2VideoMixer *videoMixer = mixerSession ? dynamic_cast<MS2VideoMixer *>(mixerSession->getMixerByType(SalVideo)) : nullptr;
+			MS2VideoRouter *router = videoMixer ? videoMixer->getRouter() : nullptr;
+			if (BC_ASSERT_PTR_NOT_NULL(router)) {
+				// Everybody receives the focused participant, who receives the previous focus or another participant.
+				checkVideoDecoded({marie, pauline, laure}, coresList);
+				uint64_t forwardedPackets = router->getStats().forwardedPackets;
+				BC_ASSERT_TRUE(forwardedPackets > 0);
+				BC_ASSERT_TRUE(router->getStats().keyFrameRequests > 0);
+
+				// Video keeps flowing once another participant is focused.
+				LinphoneCall *focusCallLaure = linphone_core_get_call_by_remote_address2(focus.getLc(), laure.getCMgr()->identity);
+				if (BC_ASSERT_PTR_NOT_NULL(focusCallLaure)) {
+					mixerSession->setFocus(&Call::toCpp(focusCallLaure)->getMediaSession()->getStreamsGroup());
+					checkVideoDecoded({marie, pauline, laure}, coresList);
+					BC_ASSERT_TRUE(router->getStats().forwardedPackets > forwardedPackets);
+				}
+			}
+		}
+
+		terminateLocalConference(focus, conference, {marie, pauline, laure}, coresList);
+		bctbx_list_free(coresList);
+	}
+}
+#endif // ifdef VIDEO_ENABLED
+
 }
 
 static test_t local_conference_tests[] = {
 	TEST_ONE_TAG("Group chat room creation local server", LinphoneTest::group_chat_room_creation_server,"LeaksMemory"), /* beacause of coreMgr restart*/
 	TEST_NO_TAG("Group chat Server chat room deletion", LinphoneTest::group_chat_room_server_deletion),
+	TEST_NO_TAG("Group chat Server fan-out follows device changes", LinphoneTest::group_chat_room_server_fan_out_follows_devices),
+	TEST_NO_TAG("One to one chat room index", LinphoneTest::one_to_one_chat_room_index),
 	TEST_NO_TAG("Group chat Add participant with invalid address", LinphoneTest::group_chat_room_add_participant_with_invalid_address),
 	TEST_NO_TAG("Group chat Only participant with invalid address", LinphoneTest::group_chat_room_with_only_participant_with_invalid_address),
 	TEST_ONE_TAG("Group chat room bulk notify to participant", LinphoneTest::group_chat_room_bulk_notify_to_participant,"LeaksMemory"), /* because of network up and down*/
 	TEST_ONE_TAG("One to one chatroom exhumed while participant is offline", LinphoneTest::one_to_one_chatroom_exhumed_while_offline,"LeaksMemory"), /* because of network up and down*/
 	TEST_ONE_TAG("Group chat Server chat room deletion with remote list event handler", LinphoneTest::group_chat_room_server_deletion_with_rmt_lst_event_handler,"LeaksMemory"), /* because of coreMgr restart*/
 	TEST_NO_TAG("Unencrypted group chat server chat room with admin managed ephemeral messages", LinphoneTest::group_chat_room_server_admin_managed_messages_unencrypted),
+	TEST_NO_TAG("Group chat IMDN sends paced across chat rooms", LinphoneTest::group_chat_room_imdn_sends_paced_across_chat_rooms),
 	TEST_ONE_TAG("Group chat Server chat room with admin managed ephemeral messages disabled after creation", LinphoneTest::group_chat_room_server_admin_managed_messages_ephemeral_disabled_after_creation, "LeaksMemory"), /* because of coreMgr restart*/
 	TEST_ONE_TAG("Group chat Server chat room with admin managed ephemeral messages enabled after creation", LinphoneTest::group_chat_room_server_admin_managed_messages_ephemeral_enabled_after_creation, "LeaksMemory"), /* because of coreMgr restart*/
 	TEST_ONE_TAG("Group chat Server chat room with admin managed ephemeral messages with lifetime update", LinphoneTest::group_chat_room_server_admin_managed_messages_ephemeral_lifetime_update, "LeaksMemory"), /* because of coreMgr restart*/
 	TEST_NO_TAG("Group chat Server chat room with admin managed ephemeral messages with lifetime toggle", LinphoneTest::group_chat_room_server_admin_managed_messages_ephemeral_lifetime_toggle_using_different_methods),
 	TEST_NO_TAG("Group chat Server chat room with ephemeral message mode changed", LinphoneTest::group_chat_room_server_ephemeral_mode_changed),
 	TEST_ONE_TAG("Multi domain chatroom", LinphoneTest::multidomain_group_chat_room,"LeaksMemory"), /* because of coreMgr restart*/
+	TEST_NO_TAG("Audio conference with mixer partitions", LinphoneTest::audio_conference_with_mixer_partitions),
+#ifdef VIDEO_ENABLED
+	TEST_NO_TAG("Video conference with router mode", LinphoneTest::video_conference_with_router_mode),
+#endif
 };
 
 test_suite_t local_conference_test_suite = {
@@ -18,6 +18,8 @@
  */
 
 #include "address/address.h"
+#include "chat/chat-message/chat-message-p.h"
+#include "content/content.h"
 #include "core/core-p.h"
 #include "db/main-db.h"
 #include "event-log/events.h"
@@ -40,12 +42,19 @@ class MainDbProvider {
 public:
 	MainDbProvider () : MainDbProvider("db/linphone.db") { }
 
-	MainDbProvider (const char *db_file) {
+	// If reuseDb is true, the database left by the previous provider is opened again instead of a fresh copy of db_file.
+	MainDbProvider (const char *db_file, bool writeBehind = false, bool reuseDb = false) {
 		mCoreManager = linphone_core_manager_create("empty_rc");
 		char *roDbPath = bc_tester_res(db_file);
 		char *rwDbPath = bc_tester_file("linphone.db");
-		BC_ASSERT_FALSE(liblinphone_tester_copy_file(roDbPath, rwDbPath));
+		if (!reuseDb)
+			BC_ASSERT_FALSE(liblinphone_tester_copy_file(roDbPath, rwDbPath));
 		linphone_config_set_string(linphone_core_get_config(mCoreManager->lc), "storage", "uri", rwDbPath);
+		if (writeBehind) {
+			linphone_config_set_bool(linphone_core_get_config(mCoreManager->lc), "storage", "write_behind_enabled", TRUE);
+			linphone_config_set_int(linphone_core_get_config(mCoreManager->lc), "storage", "write_behind_max_pending_writes", 1000);
+			linphone_config_set_int(linphone_core_get_config(mCoreManager->lc), "storage", "write_behind_delay_ms", 60000);
+		}
 		bc_free(roDbPath);
 		bc_free(rwDbPath);
 		linphone_core_manager_start(mCoreManager, false);
@@ -99,6 +108,16 @@ static void get_unread_messages_count (void) {
 	);
 }
 
+static void get_unread_messages_count_after_reconnect (void) {
+	MainDbProvider provider;
+	MainDb &mainDb = provider.getMainDb();
+	// The global count is not cached by MainDb, it always runs the prepared statement.
+	BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(), 2, int, "%d");
+	BC_ASSERT_TRUE(mainDb.forceReconnect());
+	BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(), 2, int, "%d");
+	BC_ASSERT_EQUAL(mainDb.getUnreadChatMessageCount(), 2, int, "%d");
+}
+
 static void get_history (void) {
 	MainDbProvider provider;
 	const MainDb &mainDb = provider.getMainDb();
@@ -140,6 +159,92 @@ static void get_history (void) {
 	);
 }
 
+static void get_history_before (void) {
+	MainDbProvider provider;
+	const MainDb &mainDb = provider.getMainDb();
+	const ConferenceId conferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org"));
+
+	list<shared_ptr<EventLog>> lastPage = mainDb.getHistoryBefore(conferenceId, nullptr, 100, MainDb::Filter::ConferenceChatMessageFilter);
+	BC_ASSERT_EQUAL((int)lastPage.size(), 100, int, "%d");
+	if (lastPage.empty())
+		return;
+
+	// The page before the most recent one must match the equivalent offset-based range.
+	list<shared_ptr<EventLog>> cursorPage = mainDb.getHistoryBefore(conferenceId, lastPage.front(), 100, MainDb::Filter::ConferenceChatMessageFilter);
+	list<shared_ptr<EventLog>> offsetPage = mainDb.getHistoryRange(conferenceId, 100, 200, MainDb::Filter::ConferenceChatMessageFilter);
+	BC_ASSERT_EQUAL((int)cursorPage.size(), (int)offsetPage.size(), int, "%d");
+	BC_ASSERT_TRUE(cursorPage == offsetPage);
+
+	// Nothing is stored before the oldest event.
+	list<shared_ptr<EventLog>> history = mainDb.getHistoryRange(conferenceId, 0, -1, MainDb::Filter::ConferenceChatMessageFilter);
+	BC_ASSERT_EQUAL((int)history.size(), 804, int, "%d");
+	if (!history.empty())
+		BC_ASSERT_EQUAL((int)mainDb.getHistoryBefore(conferenceId, history.front(), 100, MainDb::Filter::ConferenceChatMessageFilter).size(), 0, int, "%d");
+}
+
+static void paginate_history_benchmark (void) {
+	MainDbProvider provider;
+	const MainDb &mainDb = provider.getMainDb();
+	const ConferenceId conferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org"));
+	const int pageSize = 10;
+
+	// Keep every page alive so that both walks share the MainDb event cache and can be compared by pointer.
+	list<shared_ptr<EventLog>> offsetHistory;
+	long offsetDeepestPageUs = 0;
+	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
+	for (int begin = 0; ; begin += pageSize) {
+		chrono::high_resolution_clock::time_point pageStart = chrono::high_resolution_clock::now();
+		list<shared_ptr<EventLog>> page = mainDb.getHistoryRange(conferenceId, begin, begin + pageSize, MainDb::Filter::ConferenceChatMessageFilter);
+		chrono::high_resolution_clock::time_point pageEnd = chrono::high_resolution_clock::now();
+		if (page.empty())
+			break;
+		offsetDeepestPageUs = (long) chrono::duration_cast<chrono::microseconds>(pageEnd - pageStart).count();
+		offsetHistory.splice(offsetHistory.begin(), page);
+	}
+	long offsetMs = (long) chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+	list<shared_ptr<EventLog>> cursorHistory;
+	long cursorDeepestPageUs = 0;
+	start = chrono::high_resolution_clock::now();
+	for (;;) {
+		shared_ptr<const EventLog> lastEvent = cursorHistory.empty() ? nullptr : cursorHistory.front();
+		chrono::high_resolution_clock::time_point pageStart = chrono::high_resolution_clock::now();
+		list<shared_ptr<EventLog>> page = mainDb.getHistoryBefore(conferenceId, lastEvent, pageSize, MainDb::Filter::ConferenceChatMessageFilter);
+		chrono::high_resolution_clock::time_point pageEnd = chrono::high_resolution_clock::now();
+		if (page.empty())
+			break;
+		cursorDeepestPageUs = (long) chrono::duration_cast<chrono::microseconds>(pageEnd - pageStart).count();
+		cursorHistory.splice(cursorHistory.begin(), page);
+	}
+	long cursorMs = (long) chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - start).count();
+
+	BC_ASSERT_EQUAL((int)offsetHistory.size(), 804, int, "%d");
+	BC_ASSERT_EQUAL((int)cursorHistory.size(), (int)offsetHistory.size(), int, "%d");
+	BC_ASSERT_TRUE(cursorHistory == offsetHistory);
+
+	ms_message("History pagination by %d: offset walk took %li ms (deepest page %li us), cursor walk took %li ms (deepest page %li us)",
+		pageSize, offsetMs, offsetDeepestPageUs, cursorMs, cursorDeepestPageUs);
+}
+
+static void load_history_contents (void) {
+	MainDbProvider provider;
+	const MainDb &mainDb = provider.getMainDb();
+	list<shared_ptr<EventLog>> events = mainDb.getHistoryRange(
+		ConferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org")),
+		0, -1, MainDb::Filter::ConferenceChatMessageFilter
+	);
+	BC_ASSERT_EQUAL((int)events.size(), 804, int, "%d");
+
+	// Contents of the whole page are loaded in batch with the events, not one chat message at a time.
+	int contentsCount = 0;
+	for (const auto &event : events) {
+		shared_ptr<ChatMessage> chatMessage = static_pointer_cast<ConferenceChatMessageEvent>(event)->getChatMessage();
+		BC_ASSERT_TRUE(chatMessage->getPrivate()->areContentsLoaded());
+		contentsCount += (int)chatMessage->getContents().size();
+	}
+	BC_ASSERT_GREATER(contentsCount, (int)events.size(), int, "%d");
+}
+
 static void get_conference_notified_events (void) {
 	MainDbProvider provider;
 	const MainDb &mainDb = provider.getMainDb();
@@ -269,6 +374,64 @@ static void get_chat_rooms() {
 		}
 	}
 }
+static shared_ptr<AbstractChatRoom> findChatRoom (MainDb &mainDb, const ConferenceId &conferenceId) {
+	for (const auto &room : mainDb.getChatRooms()) {
+		if (room->getConferenceId() == conferenceId)
+			return room;
+	}
+	return nullptr;
+}
+
+static void write_behind (void) {
+	const ConferenceId conferenceId(IdentityAddress("sip:test-1@sip.linphone.org"), IdentityAddress("sip:test-1@sip.linphone.org"));
+	int historySize;
+
+	{
+		MainDbProvider provider("db/linphone.db", true);
+		MainDb &mainDb = provider.getMainDb();
+		historySize = mainDb.getHistorySize(conferenceId, MainDb::Filter::ConferenceChatMessageFilter);
+
+		shared_ptr<AbstractChatRoom> chatRoom = findChatRoom(mainDb, conferenceId);
+		if (!BC_ASSERT_PTR_NOT_NULL(chatRoom))
+			return;
+
+		// Pending writes are not committed yet but must be visible to the readers.
+		for (int i = 0; i < 10; i++)
+			chatRoom->createChatMessageFromUtf8("Hello write-behind")->send();
+		BC_ASSERT_EQUAL(mainDb.getHistorySize(conferenceId, MainDb::Filter::ConferenceChatMessageFilter), historySize + 10, int, "%d");
+		shared_ptr<ChatMessage> lastMessage = chatRoom->getLastChatMessageInHistory();
+		BC_ASSERT_PTR_NOT_NULL(lastMessage);
+
+		// The writes of the messages were left pending for the flush.
+		const unsigned int committedWrites = mainDb.getWriteBehindStats().committedWrites;
+		BC_ASSERT_TRUE(mainDb.flushPendingWrites());
+		BC_ASSERT_GREATER_STRICT(mainDb.getWriteBehindStats().committedWrites, committedWrites, unsigned int, "%u");
+		BC_ASSERT_EQUAL(mainDb.getHistorySize(conferenceId, MainDb::Filter::ConferenceChatMessageFilter), historySize + 10, int, "%d");
+		BC_ASSERT_PTR_EQUAL(chatRoom->getLastChatMessageInHistory(), lastMessage);
+		BC_ASSERT_GREATER(mainDb.getWriteBehindStats().committedWrites, 10, unsigned int, "%u");
+		BC_ASSERT_EQUAL(mainDb.getWriteBehindStats().lostWrites, 0, unsigned int, "%u");
+
+		// These ones are still pending when the core stops, they must be committed by its shutdown.
+		for (int i = 0; i < 5; i++)
+			chatRoom->createChatMessageFromUtf8("Hello write-behind at shutdown")->send();
+	}
+
+	// Both batches must have reached the database file.
+	MainDbProvider provider("db/linphone.db", false, true);
+	MainDb &mainDb = provider.getMainDb();
+	BC_ASSERT_EQUAL(mainDb.getHistorySize(conferenceId, MainDb::Filter::ConferenceChatMessageFilter), historySize + 15, int, "%d");
+	shared_ptr<AbstractChatRoom> chatRoom = findChatRoom(mainDb, conferenceId);
+	if (BC_ASSERT_PTR_NOT_NULL(chatRoom)) {
+		shared_ptr<ChatMessage> lastMessage = chatRoom->getLastChatMessageInHistory();
+		if (BC_ASSERT_PTR_NOT_NULL(lastMessage)) {
+			const list<Content *> &contents = lastMessage->getContents();
+			BC_ASSERT_EQUAL((int)contents.size(), 1, int, "%d");
+			if (!contents.empty())
+				BC_ASSERT_STRING_EQUAL(contents.front()->getBodyAsUtf8String().c_str(), "Hello write-behind at shutdown");
+		}
+	}
+}
+
 static void load_a_lot_of_chatrooms(void) {
 	chrono::high_resolution_clock::time_point start = chrono::high_resolution_clock::now();
 	MainDbProvider provider("db/chatrooms.db");
@@ -285,9 +448,14 @@ test_t main_db_tests[] = {
 	TEST_NO_TAG("Get events count", get_events_count),
 	TEST_NO_TAG("Get messages count", get_messages_count),
 	TEST_NO_TAG("Get unread messages count", get_unread_messages_count),
+	TEST_NO_TAG("Get unread messages count after reconnect", get_unread_messages_count_after_reconnect),
 	TEST_NO_TAG("Get history", get_history),
+	TEST_NO_TAG("Get history before", get_history_before),
+	TEST_NO_TAG("Paginate history benchmark", paginate_history_benchmark),
+	TEST_NO_TAG("Load history contents", load_history_contents),
 	TEST_NO_TAG("Get conference events", get_conference_notified_events),
 	TEST_NO_TAG("Get chat rooms", get_chat_rooms),
+	TEST_NO_TAG("Write behind", write_behind),
 	TEST_NO_TAG("Load a lot of chatrooms", load_a_lot_of_chatrooms)
 };
 
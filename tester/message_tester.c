@@ -1321,6 +1321,65 @@ static void transfer_message_2_files(void) {
 	transfer_message_base(FALSE, FALSE, FALSE, FALSE, FALSE, TRUE, -1, TRUE, FALSE);
 }
 
+static void transfer_message_2_files_in_parallel(void) {
+	if (!linphone_factory_is_database_storage_available(linphone_factory_get())) {
+		ms_warning("Test skipped, database storage is not available");
+		return;
+	}
+	if (transport_supported(LinphoneTransportTls)) {
+		LinphoneCoreManager* marie = linphone_core_manager_new( "marie_rc");
+		LinphoneCoreManager* pauline = linphone_core_manager_new( "pauline_tcp_rc");
+		char *send_filepath2 = bc_tester_res("sounds/ahbahouaismaisbon.wav");
+		LinphoneChatRoom *chat_room;
+		LinphoneChatMessage *msg;
+		LinphoneContent *content;
+		FILE *file_to_send;
+		size_t file_size;
+
+		/* Upload both files at once */
+		linphone_config_set_int(linphone_core_get_config(pauline->lc), "misc", "max_parallel_file_uploads", 2);
+		linphone_core_set_file_transfer_server(pauline->lc, file_transfer_url);
+
+		chat_room = linphone_core_get_chat_room(pauline->lc, marie->identity);
+		linphone_chat_room_allow_multipart(chat_room);
+		linphone_chat_room_allow_cpim(chat_room);
+
+		msg = create_file_transfer_message_from_file(chat_room, "sounds/sintel_trailer_opus_h264.mkv");
+
+		file_to_send = fopen(send_filepath2, "rb");
+		fseek(file_to_send, 0, SEEK_END);
+		file_size = ftell(file_to_send);
+		fclose(file_to_send);
+
+		content = linphone_core_create_content(pauline->lc);
+		linphone_content_set_type(content, "audio");
+		linphone_content_set_subtype(content, "wav");
+		linphone_content_set_name(content, "ahbahouaismaisbon.wav");
+		linphone_content_set_file_path(content, send_filepath2);
+		linphone_content_set_size(content, file_size);
+		linphone_chat_message_add_file_content(msg, content);
+		linphone_content_unref(content);
+		BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_chat_message_get_contents(msg)), 2, int, "%d");
+
+		linphone_chat_message_send(msg);
+
+		/* The message is sent once, when both uploads are done */
+		BC_ASSERT_TRUE(wait_for_until(pauline->lc, marie->lc, &marie->stat.number_of_LinphoneMessageReceivedWithFile, 1, 60000));
+		BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageFileTransferInProgress, 1, int, "%d");
+		BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageFileTransferDone, 1, int, "%d");
+		BC_ASSERT_EQUAL(pauline->stat.number_of_LinphoneMessageNotDelivered, 0, int, "%d");
+		if (marie->stat.last_received_chat_message) {
+			const bctbx_list_t *contents = linphone_chat_message_get_contents(marie->stat.last_received_chat_message);
+			BC_ASSERT_EQUAL((int)bctbx_list_size(contents), 2, int, "%d");
+		}
+
+		linphone_chat_message_unref(msg);
+		bc_free(send_filepath2);
+		linphone_core_manager_destroy(pauline);
+		linphone_core_manager_destroy(marie);
+	}
+}
+
 static void transfer_message_auto_download(void) {
 	transfer_message_base(FALSE, FALSE, TRUE, TRUE, FALSE, TRUE, 0, FALSE, FALSE);
 }
@@ -2721,6 +2780,40 @@ void crash_during_file_transfer(void) {
 	linphone_core_manager_destroy(marie);
 }
 
+static void lazy_chat_room_loading(void) {
+	if (!linphone_factory_is_database_storage_available(linphone_factory_get())) {
+		ms_warning("Test skipped, database storage is not available");
+		return;
+	}
+
+	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
+	LinphoneCoreManager *pauline = linphone_core_manager_new("pauline_tcp_rc");
+
+	LinphoneChatRoom *chat_room = linphone_core_get_chat_room(marie->lc, pauline->identity);
+	linphone_chat_room_send_message(chat_room, "Bla bla bla bla");
+	linphone_chat_room_send_message(chat_room, "Bouhbouhbouh");
+	BC_ASSERT_TRUE(wait_for(pauline->lc, marie->lc, &pauline->stat.number_of_LinphoneMessageReceived, 2));
+
+	/* Restart pauline with the chat rooms left in database until they are accessed. */
+	linphone_core_manager_reinit(pauline);
+	linphone_config_set_int(linphone_core_get_config(pauline->lc), "misc", "lazy_chat_room_loading", 1);
+	linphone_core_manager_start(pauline, TRUE);
+
+	/* The unread count is known without building the chat room. */
+	BC_ASSERT_EQUAL(linphone_core_get_unread_chat_message_count_from_active_locals(pauline->lc), 2, int, "%d");
+	BC_ASSERT_EQUAL(linphone_core_get_unread_chat_message_count_from_local(pauline->lc, pauline->identity), 2, int, "%d");
+
+	chat_room = linphone_core_get_chat_room(pauline->lc, marie->identity);
+	if (BC_ASSERT_PTR_NOT_NULL(chat_room)) {
+		BC_ASSERT_EQUAL(linphone_chat_room_get_history_size(chat_room), 2, int, "%d");
+		BC_ASSERT_EQUAL(linphone_chat_room_get_unread_messages_count(chat_room), 2, int, "%d");
+	}
+	BC_ASSERT_EQUAL((int)bctbx_list_size(linphone_core_get_chat_rooms(pauline->lc)), 1, int, "%d");
+
+	linphone_core_manager_destroy(pauline);
+	linphone_core_manager_destroy(marie);
+}
+
 static void text_status_after_destroying_chat_room(void) {
 	LinphoneCoreManager *marie = linphone_core_manager_new("marie_rc");
 	LinphoneChatRoom *chatroom = linphone_core_get_chat_room_from_uri(marie->lc, "<sip:Jehan@sip.linphone.org>");
@@ -3819,6 +3912,7 @@ test_t message_tests[] = {
 	TEST_NO_TAG("Message with voice recording 3", message_with_voice_recording_3),
 	TEST_NO_TAG("Transfer message legacy", transfer_message_legacy),
 	TEST_NO_TAG("Transfer message with 2 files", transfer_message_2_files),
+	TEST_NO_TAG("Transfer message with 2 files uploaded in parallel", transfer_message_2_files_in_parallel),
 	TEST_NO_TAG("Transfer message auto download", transfer_message_auto_download),
 	TEST_NO_TAG("Transfer message auto download 2", transfer_message_auto_download_2),
 	TEST_NO_TAG("Transfer message auto download enabled but file too large", transfer_message_auto_download_3),
@@ -3868,6 +3962,7 @@ test_t message_tests[] = {
 	TEST_NO_TAG("Info message", info_message),
 	TEST_NO_TAG("Info message with body", info_message_with_body),
 	TEST_NO_TAG("Crash during file transfer", crash_during_file_transfer),
+	TEST_NO_TAG("Lazy chat room loading", lazy_chat_room_loading),
 	TEST_NO_TAG("Text status after destroying chat room", text_status_after_destroying_chat_room),
 	TEST_NO_TAG("Transfer success after destroying chatroom", file_transfer_success_after_destroying_chatroom),
 	TEST_NO_TAG("Migration from messages db", migration_from_messages_db)
@@ -24,6 +24,8 @@
 #include "linphone/utils/utils.h"
 #include "liblinphone_tester.h"
 #include "tester_utils.h"
+#include "call/call.h"
+#include "sal/call-op.h"
 #include "sal/sal_media_description.h"
 #include "sal/sal_stream_description.h"
 
@@ -148,6 +150,59 @@ static void simple_call_with_fmtps(void){
 	linphone_core_manager_destroy(pauline);
 }
 
+static void call_updated_with_unchanged_sdp(void) {
+	LinphoneCoreManager* marie;
+	LinphoneCoreManager* pauline;
+	LinphoneCall *pauline_call;
+	LinphoneCall *marie_call;
+	LinphonePrivate::SalCallOp *marie_op;
+	size_t reused_streams;
+	int i;
+
+	marie = linphone_core_manager_new( "marie_rc");
+	pauline = linphone_core_manager_new( "pauline_tcp_rc");
+
+	disable_all_audio_codecs_except_one(marie->lc,"pcmu",-1);
+	disable_all_audio_codecs_except_one(pauline->lc,"pcmu",-1);
+	payload_type_set_number(linphone_core_find_payload_type(pauline->lc, "PCMU", 8000, -1), 104);
+
+	BC_ASSERT_TRUE(call(pauline,marie));
+	pauline_call=linphone_core_get_current_call(pauline->lc);
+	marie_call=linphone_core_get_current_call(marie->lc);
+	if (!BC_ASSERT_PTR_NOT_NULL(pauline_call) || !BC_ASSERT_PTR_NOT_NULL(marie_call)) goto end;
+	marie_op = LinphonePrivate::Call::toCpp(marie_call)->getOp();
+
+	/*marie receives the same offer again, its unchanged m-line is not negotiated again*/
+	for (i = 0; i < 2; i++){
+		reused_streams = marie_op->getReusedStreamsCount();
+		LinphoneCallParams *params = linphone_core_create_call_params(pauline->lc, pauline_call);
+		linphone_call_update(pauline_call, params);
+		linphone_call_params_unref(params);
+		BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneCallUpdatedByRemote,i + 1));
+		BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&pauline->stat.number_of_LinphoneCallStreamsRunning,i + 2));
+		BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneCallStreamsRunning,i + 2));
+		check_payload_type_numbers(marie_call, pauline_call, 104);
+		/*the second re-INVITE is identical to the first one*/
+		if (i > 0) BC_ASSERT_GREATER_STRICT(marie_op->getReusedStreamsCount(), reused_streams, size_t, "%zu");
+	}
+
+	/*then an offer changing the direction of the stream must still be negotiated*/
+	reused_streams = marie_op->getReusedStreamsCount();
+	linphone_call_pause(pauline_call);
+	BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&pauline->stat.number_of_LinphoneCallPaused,1));
+	BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneCallPausedByRemote,1));
+	BC_ASSERT_EQUAL(marie_op->getReusedStreamsCount(), reused_streams, size_t, "%zu");
+	linphone_call_resume(pauline_call);
+	BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&pauline->stat.number_of_LinphoneCallStreamsRunning,4));
+	BC_ASSERT_TRUE(wait_for(pauline->lc,marie->lc,&marie->stat.number_of_LinphoneCallStreamsRunning,4));
+	check_payload_type_numbers(marie_call, pauline_call, 104);
+
+	end_call(marie,pauline);
+end:
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
 #ifdef VIDEO_ENABLED
 static void h264_call_with_fmtps(void){
  	LinphoneCoreManager* marie;
@@ -809,6 +864,7 @@ static test_t offeranswer_tests[] = {
 	TEST_NO_TAG("Call failed because of codecs", call_failed_because_of_codecs),
 	TEST_NO_TAG("Simple call with different codec mappings", simple_call_with_different_codec_mappings),
 	TEST_NO_TAG("Simple call with fmtps", simple_call_with_fmtps),
+	TEST_NO_TAG("Call updated with unchanged SDP", call_updated_with_unchanged_sdp),
 	TEST_NO_TAG("AVP to AVP call", avp_to_avp_call),
 	TEST_NO_TAG("AVP to AVPF call", avp_to_avpf_call),
 	TEST_NO_TAG("AVP to SAVP call", avp_to_savp_call),
@@ -1280,6 +1280,269 @@ static void search_friend_with_phone_number_2(void) {
 	linphone_core_manager_destroy(manager);
 }
 
+static void find_friend_by_phone_number_after_edition(void) {
+	LinphoneCoreManager* manager = linphone_core_manager_new_with_proxies_check("chloe_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(manager->lc);
+	LinphoneFriend *laureFriend = linphone_core_create_friend(manager->lc);
+	LinphoneVcard *laureVcard = linphone_factory_create_vcard(linphone_factory_get());
+	LinphoneFriend *lf = NULL;
+
+	linphone_vcard_set_full_name(laureVcard, "Laure");
+	linphone_vcard_add_phone_number(laureVcard, "+33641424344");
+	linphone_friend_set_vcard(laureFriend, laureVcard);
+	linphone_core_add_friend(manager->lc, laureFriend);
+
+	lf = linphone_friend_list_find_friend_by_phone_number(lfl, "+33 6 41 42 43 44");
+	BC_ASSERT_PTR_EQUAL(lf, laureFriend);
+
+	// Numbers added or removed once the friend is in the list
+	linphone_friend_add_phone_number(laureFriend, "0655667788");
+	linphone_friend_add_phone_number(laureFriend, "112");
+	lf = linphone_friend_list_find_friend_by_phone_number(lfl, "06 55 66 77 88");
+	BC_ASSERT_PTR_EQUAL(lf, laureFriend);
+	lf = linphone_friend_list_find_friend_by_phone_number(lfl, "112");
+	BC_ASSERT_PTR_EQUAL(lf, laureFriend);
+
+	linphone_friend_remove_phone_number(laureFriend, "+33641424344");
+	lf = linphone_friend_list_find_friend_by_phone_number(lfl, "+33641424344");
+	BC_ASSERT_PTR_NULL(lf);
+	lf = linphone_friend_list_find_friend_by_phone_number(lfl, "0655667788");
+	BC_ASSERT_PTR_EQUAL(lf, laureFriend);
+
+	// Same last digits but another number
+	lf = linphone_friend_list_find_friend_by_phone_number(lfl, "0611667788");
+	BC_ASSERT_PTR_NULL(lf);
+
+	linphone_friend_list_remove_friend(lfl, laureFriend);
+	lf = linphone_friend_list_find_friend_by_phone_number(lfl, "0655667788");
+	BC_ASSERT_PTR_NULL(lf);
+
+	if (laureFriend) linphone_friend_unref(laureFriend);
+	if (laureVcard) linphone_vcard_unref(laureVcard);
+
+	linphone_core_manager_destroy(manager);
+}
+
+static int find_friend_allocations = 0;
+
+static void *find_friend_counting_malloc(size_t size) {
+	find_friend_allocations++;
+	return malloc(size);
+}
+
+static void *find_friend_counting_realloc(void *ptr, size_t size) {
+	find_friend_allocations++;
+	return realloc(ptr, size);
+}
+
+static void find_friend_by_address_without_allocation(void) {
+	LinphoneCoreManager* manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(manager->lc);
+	LinphoneAddress *address = linphone_address_new("\"Marie\" <sip:marie@sip.example.org;gr=urn:uuid:6b1bb3f3-7e1f-4d7c-9b3a-6f1f1c2d3e4f>");
+	LinphoneAddress *unknownAddress = linphone_address_new("sip:pauline@sip.example.org");
+	BctoolboxMemoryFunctions countingFunctions = { find_friend_counting_malloc, find_friend_counting_realloc, free };
+	BctoolboxMemoryFunctions defaultFunctions = { malloc, realloc, free };
+	LinphoneFriend *expectedFriend = NULL;
+	LinphoneFriend *lf = NULL;
+	LinphoneFriend *unknownFriend = NULL;
+	const int lookups = 10000;
+	uint64_t start;
+	int i;
+
+	_create_friends_from_tab(manager->lc, lfl, sFriends, sSizeFriend);
+	expectedFriend = linphone_friend_list_find_friend_by_uri(lfl, sFriends[5]);
+	BC_ASSERT_PTR_NOT_NULL(expectedFriend);
+
+	// Only the allocations going through bctoolbox are counted, other threads of the core may add a few ones
+	find_friend_allocations = 0;
+	start = bctbx_get_cur_time_ms();
+	bctbx_set_memory_functions(&countingFunctions);
+	for (i = 0; i < lookups; i++) {
+		lf = linphone_friend_list_find_friend_by_address(lfl, address);
+		unknownFriend = linphone_friend_list_find_friend_by_address(lfl, unknownAddress);
+	}
+	bctbx_set_memory_functions(&defaultFunctions);
+	ms_message("%d friend lookups by address done in %llu ms with %d allocations",
+		2 * lookups, (unsigned long long)(bctbx_get_cur_time_ms() - start), find_friend_allocations);
+
+	BC_ASSERT_PTR_EQUAL(lf, expectedFriend);
+	BC_ASSERT_PTR_NULL(unknownFriend);
+	BC_ASSERT_LOWER(find_friend_allocations, lookups, int, "%d");
+
+	_remove_friends_from_list(lfl, sFriends, sSizeFriend);
+	linphone_address_unref(address);
+	linphone_address_unref(unknownAddress);
+	linphone_core_manager_destroy(manager);
+}
+
+static void search_friend_after_edition(void) {
+	LinphoneMagicSearch *magicSearch = NULL;
+	bctbx_list_t *resultList = NULL;
+	LinphoneCoreManager* manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(manager->lc);
+	LinphoneFriend *marieFriend = NULL;
+	LinphoneFriend *loicFriend = NULL;
+
+	_create_friends_from_tab(manager->lc, lfl, sFriends, sSizeFriend);
+	marieFriend = linphone_friend_list_find_friend_by_uri(lfl, sFriends[5]);
+	loicFriend = linphone_friend_list_find_friend_by_uri(lfl, sFriends[7]);
+
+	magicSearch = linphone_magic_search_new(manager->lc);
+
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "zorro", "");
+	BC_ASSERT_PTR_NULL(resultList);
+
+	// Friends edited once in the list must be found with their new informations
+	linphone_friend_edit(marieFriend);
+	linphone_friend_set_name(marieFriend, "Marie Zorro");
+	linphone_friend_done(marieFriend);
+	linphone_friend_add_phone_number(loicFriend, "0698765432");
+
+	linphone_magic_search_reset_search_cache(magicSearch);
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "zorro", "");
+
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 0, sFriends[5], NULL);//"sip:marie@sip.example.org"
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_magic_search_unref);
+	}
+
+	linphone_magic_search_reset_search_cache(magicSearch);
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "87654", "");
+
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+		BC_ASSERT_PTR_EQUAL(linphone_search_result_get_friend((LinphoneSearchResult *)bctbx_list_get_data(resultList)), loicFriend);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_magic_search_unref);
+	}
+
+	// Removed friends must not be found anymore
+	linphone_friend_list_remove_friend(lfl, marieFriend);
+	linphone_friend_unref(marieFriend);
+
+	linphone_magic_search_reset_search_cache(magicSearch);
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "zorro", "");
+	BC_ASSERT_PTR_NULL(resultList);
+
+	_remove_friends_from_list(lfl, sFriends, sSizeFriend);
+
+	linphone_magic_search_unref(magicSearch);
+	linphone_core_manager_destroy(manager);
+}
+
+static void search_friend_with_limited_search(void) {
+	LinphoneMagicSearch *magicSearch = NULL;
+	bctbx_list_t *resultList = NULL;
+	LinphoneCoreManager* manager = linphone_core_manager_new_with_proxies_check("empty_rc", FALSE);
+	LinphoneFriendList *lfl = linphone_core_get_default_friend_list(manager->lc);
+
+	_create_friends_from_tab(manager->lc, lfl, sFriends, sSizeFriend);
+
+	magicSearch = linphone_magic_search_new(manager->lc);
+	linphone_magic_search_set_limited_search(magicSearch, TRUE);
+	linphone_magic_search_set_search_limit(magicSearch, 2);
+
+	// "loic" starts with the filter and must be kept over "allo" and "hello"
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "lo", "");
+
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 2, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 0, sFriends[7], NULL);//"sip:loic@sip.example.org"
+		_check_friend_result_list(manager->lc, resultList, 1, sFriends[9], NULL);//"sip:loic@sip.test.org"
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_magic_search_unref);
+	}
+
+	// The cache only holds the best results, a new search must be done
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "llo", "");
+
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 2, int, "%d");
+		_check_friend_result_list(manager->lc, resultList, 0, sFriends[2], NULL);//"sip:allo@sip.example.org"
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_magic_search_unref);
+	}
+
+	_remove_friends_from_list(lfl, sFriends, sSizeFriend);
+
+	linphone_magic_search_unref(magicSearch);
+	linphone_core_manager_destroy(manager);
+}
+
+static void search_friend_with_phone_number_after_dial_prefix_change(void) {
+	LinphoneMagicSearch *magicSearch = NULL;
+	bctbx_list_t *resultList = NULL;
+	LinphoneCoreManager* manager = linphone_core_manager_new_with_proxies_check("marie_rc", FALSE);
+	LinphoneProxyConfig *proxy = linphone_core_get_default_proxy_config(manager->lc);
+	LinphoneFriend *laureFriend = linphone_core_create_friend(manager->lc);
+	LinphoneVcard *laureVcard = linphone_factory_create_vcard(linphone_factory_get());
+	LinphoneAccountParams *newParams = NULL;
+	LinphoneAddress *identityAddress = NULL;
+	LinphoneAccount *newAccount = NULL;
+
+	linphone_vcard_set_full_name(laureVcard, "Laure");
+	linphone_vcard_add_phone_number(laureVcard, "0641424344");
+	linphone_friend_set_vcard(laureFriend, laureVcard);
+	linphone_core_add_friend(manager->lc, laureFriend);
+
+	magicSearch = linphone_magic_search_new(manager->lc);
+
+	if (!BC_ASSERT_PTR_NOT_NULL(proxy)) goto end;
+	BC_ASSERT_PTR_NULL(linphone_proxy_config_get_dial_prefix(proxy));
+
+	// Without dial prefix the national number can't be turned into an international one
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "+33641", "");
+	BC_ASSERT_PTR_NULL(resultList);
+
+	// The phone numbers indexed with the previous dial settings must be normalized again
+	linphone_proxy_config_edit(proxy);
+	linphone_proxy_config_set_dial_prefix(proxy, "33");
+	linphone_proxy_config_done(proxy);
+
+	linphone_magic_search_reset_search_cache(magicSearch);
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "+33641", "");
+
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+		BC_ASSERT_PTR_EQUAL(linphone_search_result_get_friend((LinphoneSearchResult *)bctbx_list_get_data(resultList)), laureFriend);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_magic_search_unref);
+	}
+
+	linphone_proxy_config_edit(proxy);
+	linphone_proxy_config_set_dial_prefix(proxy, NULL);
+	linphone_proxy_config_done(proxy);
+
+	linphone_magic_search_reset_search_cache(magicSearch);
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "+33641", "");
+	BC_ASSERT_PTR_NULL(resultList);
+
+	// Same when another account becomes the default one
+	newParams = linphone_core_create_account_params(manager->lc);
+	identityAddress = linphone_factory_create_address(linphone_factory_get(), "sip:marie-finland@sip.example.org");
+	linphone_account_params_set_identity_address(newParams, identityAddress);
+	linphone_address_unref(identityAddress);
+	linphone_account_params_set_server_addr(newParams, "<sip:sip.example.org;transport=tls>");
+	linphone_account_params_set_international_prefix(newParams, "358");
+	newAccount = linphone_core_create_account(manager->lc, newParams);
+	linphone_core_add_account(manager->lc, newAccount);
+	linphone_core_set_default_account(manager->lc, newAccount);
+	linphone_account_params_unref(newParams);
+	linphone_account_unref(newAccount);
+
+	linphone_magic_search_reset_search_cache(magicSearch);
+	resultList = linphone_magic_search_get_contact_list_from_filter(magicSearch, "+358641", "");
+
+	if (BC_ASSERT_PTR_NOT_NULL(resultList)) {
+		BC_ASSERT_EQUAL((int)bctbx_list_size(resultList), 1, int, "%d");
+		BC_ASSERT_PTR_EQUAL(linphone_search_result_get_friend((LinphoneSearchResult *)bctbx_list_get_data(resultList)), laureFriend);
+		bctbx_list_free_with_data(resultList, (bctbx_list_free_func)linphone_magic_search_unref);
+	}
+
+end:
+	linphone_vcard_unref(laureVcard);
+	linphone_friend_unref(laureFriend);
+	linphone_magic_search_unref(magicSearch);
+	linphone_core_manager_destroy(manager);
+}
+
 static void search_friend_with_presence(void) {
 	LinphoneMagicSearch *magicSearch = NULL;
 	bctbx_list_t *resultList = NULL;
@@ -2358,6 +2621,11 @@ test_t setup_tests[] = {
 	TEST_ONE_TAG("Multiple looking for friends with cache resetting", search_friend_research_estate_reset, "MagicSearch"),
 	TEST_ONE_TAG("Search friend with phone number", search_friend_with_phone_number, "MagicSearch"),
 	TEST_NO_TAG("Search friend with phone number 2", search_friend_with_phone_number_2),
+	TEST_NO_TAG("Find friend by phone number after edition", find_friend_by_phone_number_after_edition),
+	TEST_NO_TAG("Find friend by address without allocation", find_friend_by_address_without_allocation),
+	TEST_ONE_TAG("Search friend after edition", search_friend_after_edition, "MagicSearch"),
+	TEST_ONE_TAG("Search friend with phone number after dial prefix change", search_friend_with_phone_number_after_dial_prefix_change, "MagicSearch"),
+	TEST_ONE_TAG("Search friend with limited search", search_friend_with_limited_search, "MagicSearch"),
 	TEST_ONE_TAG("Search friend and find it with its presence", search_friend_with_presence, "MagicSearch"),
 	TEST_ONE_TAG("Search friend in call log", search_friend_in_call_log, "MagicSearch"),
 	TEST_ONE_TAG("Search friend in call log but don't add address which already exist", search_friend_in_call_log_already_exist, "MagicSearch"),
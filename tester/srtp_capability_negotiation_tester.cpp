@@ -22,6 +22,8 @@
 #include "capability_negotiation_tester.h"
 #include "linphone/core.h"
 #include "c-wrapper/c-wrapper.h"
+#include "call/call.h"
+#include "sal/call-op.h"
 
 static void call_with_srtp_default_encryption(void) {
 	call_with_default_encryption(LinphoneMediaEncryptionSRTP);
@@ -127,6 +129,62 @@ static void srtp_call_with_capability_negotiations_callee_unencrypted(void) {
 	linphone_core_manager_destroy(pauline);
 }
 
+static void srtp_call_with_capability_negotiations_and_unchanged_sdp_in_update(void) {
+	LinphoneCoreManager* marie = linphone_core_manager_new("marie_rc");
+	LinphoneCoreManager* pauline = linphone_core_manager_new(transport_supported(LinphoneTransportTls) ? "pauline_rc" : "pauline_tcp_rc");
+	bctbx_list_t * encryption_list = bctbx_list_append(NULL, LINPHONE_INT_TO_PTR(LinphoneMediaEncryptionSRTP));
+	bctbx_list_t * lcs = NULL;
+	lcs = bctbx_list_append(lcs, marie->lc);
+	lcs = bctbx_list_append(lcs, pauline->lc);
+
+	// Without reINVITE, pauline keeps using the potential configuration it chose
+	for (bctbx_list_t *it = lcs; it != NULL; it = bctbx_list_next(it)) {
+		LinphoneCore *lc = (LinphoneCore *)bctbx_list_get_data(it);
+		linphone_core_enable_capability_negociation(lc, TRUE);
+		linphone_core_enable_capability_negotiation_reinvite(lc, FALSE);
+		linphone_core_set_media_encryption_mandatory(lc, FALSE);
+		linphone_core_set_media_encryption(lc, LinphoneMediaEncryptionNone);
+		linphone_core_set_supported_media_encryptions(lc, encryption_list);
+	}
+	bctbx_list_free(encryption_list);
+
+	encrypted_call_base(marie, pauline, LinphoneMediaEncryptionSRTP, TRUE, TRUE, FALSE);
+
+	LinphoneCall * marieCall = linphone_core_get_current_call(marie->lc);
+	LinphoneCall * paulineCall = linphone_core_get_current_call(pauline->lc);
+	BC_ASSERT_PTR_NOT_NULL(marieCall);
+	BC_ASSERT_PTR_NOT_NULL(paulineCall);
+	if (marieCall && paulineCall) {
+		LinphonePrivate::SalCallOp * paulineOp = LinphonePrivate::Call::toCpp(paulineCall)->getOp();
+		for (int i = 0; i < 2; i++) {
+			size_t reusedStreams = paulineOp->getReusedStreamsCount();
+			stats marie_stat = marie->stat;
+			stats pauline_stat = pauline->stat;
+			LinphoneCallParams *params = linphone_core_create_call_params(marie->lc, marieCall);
+			linphone_call_update(marieCall, params);
+			linphone_call_params_unref(params);
+			BC_ASSERT_TRUE(wait_for_list(lcs, &pauline->stat.number_of_LinphoneCallUpdatedByRemote, pauline_stat.number_of_LinphoneCallUpdatedByRemote + 1, 10000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &marie->stat.number_of_LinphoneCallStreamsRunning, marie_stat.number_of_LinphoneCallStreamsRunning + 1, 10000));
+			BC_ASSERT_TRUE(wait_for_list(lcs, &pauline->stat.number_of_LinphoneCallStreamsRunning, pauline_stat.number_of_LinphoneCallStreamsRunning + 1, 10000));
+			// The second update is identical to the first one, its stream keeps the configuration chosen before
+			if (i > 0) BC_ASSERT_GREATER_STRICT(paulineOp->getReusedStreamsCount(), reusedStreams, size_t, "%zu");
+
+			BC_ASSERT_EQUAL(linphone_call_params_get_media_encryption(linphone_call_get_current_params(marieCall)), LinphoneMediaEncryptionSRTP, int, "%i");
+			BC_ASSERT_EQUAL(linphone_call_params_get_media_encryption(linphone_call_get_current_params(paulineCall)), LinphoneMediaEncryptionSRTP, int, "%i");
+			check_stream_encryption(marieCall);
+			check_stream_encryption(paulineCall);
+
+			wait_for_until(marie->lc, pauline->lc, NULL, 5, 2000);
+			liblinphone_tester_check_rtcp(marie, pauline);
+		}
+		end_call(marie, pauline);
+	}
+
+	bctbx_list_free(lcs);
+	linphone_core_manager_destroy(marie);
+	linphone_core_manager_destroy(pauline);
+}
+
 static void srtp_call_with_encryption_supported_in_call_params_only(void) {
 	call_with_encryption_supported_in_call_params_only_base(LinphoneMediaEncryptionSRTP);
 }
@@ -554,6 +612,7 @@ test_t srtp_capability_negotiation_basic_tests[] = {
 	TEST_NO_TAG("Call with default SRTP encryption", call_with_srtp_default_encryption),
 	TEST_NO_TAG("Simple SRTP call with capability negotiations with reINVITE", simple_srtp_call_with_capability_negotiations_with_reinvite),
 	TEST_NO_TAG("Simple SRTP call with capability negotiations without reINVITE", simple_srtp_call_with_capability_negotiations_without_reinvite),
+	TEST_NO_TAG("SRTP call with capability negotiations and unchanged SDP in update", srtp_call_with_capability_negotiations_and_unchanged_sdp_in_update),
 	TEST_NO_TAG("SRTP unencrypted call and capability negotiations", unencrypted_srtp_call_with_capability_negotiations),
 	TEST_NO_TAG("SRTP call and capability negotiations (caller unencrypted)", srtp_call_with_capability_negotiations_caller_unencrypted),
 	TEST_NO_TAG("SRTP call and capability negotiations (callee unencrypted)", srtp_call_with_capability_negotiations_callee_unencrypted),
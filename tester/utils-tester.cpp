@@ -17,10 +17,14 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <set>
+
 #include "linphone/utils/utils.h"
 
 #include "bctoolbox/utils.hh"
 
+#include "conference/session/rtp-port-pool.h"
+
 #include "liblinphone_tester.h"
 #include "tester_utils.h"
 
@@ -103,11 +107,68 @@ static void parse_capabilities(void){
 	BC_ASSERT_TRUE(caps["ephemeral"] == Version(1, 0));
 }
 
+static void rtp_port_pool (void) {
+	RtpPortPool pool;
+
+	// Random range of 5 pairs: each pair is given once, then the range is exhausted.
+	set<int> ports;
+	for (int i = 0; i < 5; i++) {
+		int port = pool.allocate(make_pair(40000, 40009));
+		BC_ASSERT_TRUE(port >= 40000 && port <= 40008 && port % 2 == 0);
+		ports.insert(port);
+	}
+	BC_ASSERT_EQUAL((int)ports.size(), 5, int, "%d");
+	BC_ASSERT_EQUAL(pool.allocate(make_pair(40000, 40009)), -1, int, "%d");
+	BC_ASSERT_EQUAL((int)pool.getStats().allocatedPorts, 5, int, "%d");
+	BC_ASSERT_EQUAL((int)pool.getStats().failures, 1, int, "%d");
+
+	// A released pair is the only one that can be given again.
+	pool.release(40004);
+	BC_ASSERT_FALSE(pool.isAllocated(40004));
+	BC_ASSERT_EQUAL(pool.allocate(make_pair(40000, 40009)), 40004, int, "%d");
+	BC_ASSERT_TRUE(pool.isAllocated(40004));
+
+	// An overlapping range never gives the pairs taken through the first one.
+	set<int> overlappingPorts;
+	for (int i = 0; i < 2; i++)
+		overlappingPorts.insert(pool.allocate(make_pair(40004, 40013)));
+	BC_ASSERT_TRUE(overlappingPorts == set<int>({ 40010, 40012 }));
+	BC_ASSERT_EQUAL(pool.allocate(make_pair(40004, 40013)), -1, int, "%d");
+	BC_ASSERT_GREATER((int)pool.getStats().collisions, 1, int, "%d");
+	for (const auto &range : pool.getOccupancy()) {
+		BC_ASSERT_EQUAL((int)range.capacity, 5, int, "%d");
+		BC_ASSERT_EQUAL((int)range.used, (range.minPort == 40000) ? 5 : 2, int, "%d");
+	}
+
+	// A fixed port takes the first free pair following it, skipping the ones taken through other ranges.
+	BC_ASSERT_EQUAL(pool.allocate(make_pair(50002, 50003)), 50002, int, "%d");
+	BC_ASSERT_EQUAL(pool.allocate(make_pair(50000, 50000)), 50000, int, "%d");
+	BC_ASSERT_EQUAL(pool.allocate(make_pair(50000, 50000)), 50004, int, "%d");
+	pool.release(50000);
+	BC_ASSERT_EQUAL(pool.allocate(make_pair(50000, 50000)), 50000, int, "%d");
+
+	// The scan stops after 50 pairs.
+	int lastPort = 50004;
+	for (int i = 3; i < 50; i++)
+		lastPort = pool.allocate(make_pair(50000, 50000));
+	BC_ASSERT_EQUAL(lastPort, 50098, int, "%d");
+	BC_ASSERT_EQUAL(pool.allocate(make_pair(50000, 50000)), -1, int, "%d");
+	BC_ASSERT_FALSE(pool.isAllocated(50100));
+
+	unsigned int allocatedPorts = pool.getStats().allocatedPorts;
+	BC_ASSERT_EQUAL((int)allocatedPorts, 5 + 2 + 1 + 49, int, "%d");
+	BC_ASSERT_EQUAL((int)pool.getStats().maxAllocatedPorts, (int)allocatedPorts, int, "%d");
+	for (int port : ports)
+		pool.release(port);
+	BC_ASSERT_EQUAL((int)pool.getStats().allocatedPorts, (int)allocatedPorts - 5, int, "%d");
+}
+
 test_t utils_tests[] = {
 	TEST_NO_TAG("split", split),
 	TEST_NO_TAG("trim", trim),
 	TEST_NO_TAG("Version comparisons", version_comparisons),
-	TEST_NO_TAG("Parse capabilities", parse_capabilities)
+	TEST_NO_TAG("Parse capabilities", parse_capabilities),
+	TEST_NO_TAG("RTP port pool", rtp_port_pool)
 };
 
 test_suite_t utils_test_suite = {